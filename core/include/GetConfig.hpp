@@ -1,6 +1,7 @@
 #pragma once
 
 #include <RTypeNet/Interfaces.hpp>
+#include <RTypeSrv/Quantization.hpp>
 #include <string>
 
 namespace rtype::srv {
@@ -15,6 +16,23 @@ struct Config {
         network::Endpoint udp_endpoint;
         network::Endpoint external_udp_endpoint;
         std::size_t n_cores = 4;
+        bool udp_reuseport = false;///< All UDP workers share udp_port through SO_REUSEPORT (Linux only).
+        bool udp_io_uring = false; ///< `udp_engine = io_uring`: UDP workers use io_uring instead of poll (Linux with liburing only).
+        bool udp_gso = false;      ///< UDP workers batch same-destination sends with GSO and receive with GRO (Linux only).
+        std::size_t udp_rcvbuf = 0;///< SO_RCVBUF of each UDP worker socket in bytes, 0 keeps the kernel default.
+        std::size_t udp_sndbuf = 0;///< SO_SNDBUF of each UDP worker socket in bytes, 0 keeps the kernel default.
+        std::size_t udp_mtu = 1200;///< Largest datagram sent to a client, 548 to 1200; larger messages are fragmented.
+        std::size_t tcp_rcvbuf = 0;///< SO_RCVBUF of the gateway connections in bytes, 0 keeps the kernel default.
+        std::size_t tcp_sndbuf = 0;///< SO_SNDBUF of the gateway connections in bytes, 0 keeps the kernel default.
+        Quantization snapshot_x{}; ///< `snapshot_x = min:max:bits`: X bounds and precision in quantized snapshots.
+        Quantization snapshot_y{}; ///< `snapshot_y = min:max:bits`: Y bounds and precision in quantized snapshots.
+        bool snapshot_compression = false;               ///< Keyframes are zstd-compressed with the shipped dictionary (zstd builds).
+        std::size_t snapshot_compression_min_saving = 16;///< Bytes a keyframe must shrink by to be sent compressed.
+        std::size_t interest_radius = 1024;              ///< Distance from its player a client sees entities within, 0 for all.
+        std::size_t interest_hysteresis = 128;           ///< Extra distance before an entity in view leaves it.
+        std::size_t snapshot_budget = 0;                 ///< Snapshot bytes per client per tick, 0 for as many as fit a datagram.
+        std::size_t udp_max_rate = 256 * 1024;           ///< Highest send rate of a client in B/s, 0 turns congestion control off.
+        std::size_t udp_max_mtu = 1472;                  ///< Largest datagram path MTU discovery probes, up to 1472; udp_mtu or less: off.
 };
 
 static constexpr uint16_t default_tcp_port = 3000;
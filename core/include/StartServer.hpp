@@ -1,5 +1,6 @@
 #pragma once
 
+#include "GetConfig.hpp"
 #include <RTypeNet/Interfaces.hpp>
 #include <thread>
 #include <vector>
@@ -8,21 +9,18 @@ namespace rtype::srv {
 
 /**
  * @brief Starts the TCP server in a new thread.
- * @param endpoint The endpoint to listen on.
+ * @param cfg The server configuration (TCP endpoint and socket buffer sizes).
  * @param quitServer An atomic boolean to signal the server to quit.
  * @return A thread object representing the running server.
  */
-[[nodiscard]] std::thread startTcpServer(const network::Endpoint &endpoint, std::atomic<bool> &quitServer) noexcept;
+[[nodiscard]] std::thread startTcpServer(const Config &cfg, std::atomic<bool> &quitServer) noexcept;
 
 /**
  * @brief Starts the UDP servers in new threads.
- * @param baseEndpoint The base endpoint to listen on.
- * @param ncores The number of cores to use.
- * @param tcpEndpoint The TCP endpoint to connect to.
+ * @param cfg The server configuration (endpoints, number of workers and UDP options).
  * @param quitServer An atomic boolean to signal the server to quit.
  * @return A vector of thread objects representing the running servers.
  */
-[[nodiscard]] std::vector<std::thread> startUdpServers(network::Endpoint baseEndpoint, std::size_t ncores,
-    const network::Endpoint &tcpEndpoint, network::Endpoint externalUdpEndpoint, std::atomic<bool> &quitServer) noexcept;
+[[nodiscard]] std::vector<std::thread> startUdpServers(const Config &cfg, std::atomic<bool> &quitServer) noexcept;
 
 }// namespace rtype::srv
@@ -93,6 +93,41 @@ static void getPort(const std::string &val, uint16_t &port)
     port = static_cast<std::uint16_t>(p);
 }
 
+/**
+ * @brief Gets a size in bytes from a string.
+ * @param val The string to parse.
+ * @param size The variable to store the size in.
+ */
+static void getSize(const std::string &val, std::size_t &size)
+{
+    std::size_t s;
+
+    if (_SSCANF(val.c_str(), "%zu", &s) != 1) {
+        throw std::invalid_argument("Invalid config file");
+    }
+    size = s;
+}
+
+/**
+ * @brief Gets the bounds and precision of a quantized field from a string, as `min:max:bits`.
+ * @param val The string to parse.
+ * @param quantization The variable to store the quantization in.
+ */
+static void getQuantization(const std::string &val, rtype::srv::Quantization &quantization)
+{
+    rtype::srv::Quantization q;
+    unsigned bits;
+
+    if (_SSCANF(val.c_str(), "%f:%f:%u", &q.min, &q.max, &bits) != 3 || bits > rtype::srv::Quantization::MAX_BITS) {
+        throw std::invalid_argument("Invalid config file");
+    }
+    q.bits = static_cast<std::uint8_t>(bits);
+    if (!q.valid()) {
+        throw std::invalid_argument("Invalid config file");
+    }
+    quantization = q;
+}
+
 /**
  * @brief Splits a line into a key and a value.
  * @param line The line to split.
@@ -206,6 +241,43 @@ rtype::srv::Config rtype::srv::getConfig(const std::string &filename)
             getIp(val, config.external_udp_endpoint.ip);
         } else if (key == "udp_external_port") {
             getPort(val, config.external_udp_endpoint.port);
+        } else if (key == "udp_reuseport") {
+            config.udp_reuseport = (val == "true" || val == "1");
+        } else if (key == "udp_engine") {
+            if (val != "poll" && val != "io_uring") {
+                throw std::invalid_argument("Invalid config file");
+            }
+            config.udp_io_uring = (val == "io_uring");
+        } else if (key == "udp_gso") {
+            config.udp_gso = (val == "true" || val == "1");
+        } else if (key == "udp_rcvbuf") {
+            getSize(val, config.udp_rcvbuf);
+        } else if (key == "udp_sndbuf") {
+            getSize(val, config.udp_sndbuf);
+        } else if (key == "udp_mtu") {
+            getSize(val, config.udp_mtu);
+        } else if (key == "tcp_rcvbuf") {
+            getSize(val, config.tcp_rcvbuf);
+        } else if (key == "tcp_sndbuf") {
+            getSize(val, config.tcp_sndbuf);
+        } else if (key == "snapshot_x") {
+            getQuantization(val, config.snapshot_x);
+        } else if (key == "snapshot_y") {
+            getQuantization(val, config.snapshot_y);
+        } else if (key == "snapshot_compression") {
+            config.snapshot_compression = (val == "true" || val == "1");
+        } else if (key == "snapshot_compression_min_saving") {
+            getSize(val, config.snapshot_compression_min_saving);
+        } else if (key == "interest_radius") {
+            getSize(val, config.interest_radius);
+        } else if (key == "interest_hysteresis") {
+            getSize(val, config.interest_hysteresis);
+        } else if (key == "snapshot_budget") {
+            getSize(val, config.snapshot_budget);
+        } else if (key == "udp_max_rate") {
+            getSize(val, config.udp_max_rate);
+        } else if (key == "udp_max_mtu") {
+            getSize(val, config.udp_max_mtu);
         } else if (key == "n_cores") {
             std::size_t n_cores;
             if (_SSCANF(val.c_str(), "%zu", &n_cores) != 1 || n_cores == 0) {
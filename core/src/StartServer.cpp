@@ -1,22 +1,29 @@
 #include "StartServer.hpp"
 #include <RTypeSrv/Exception.hpp>
 #include <RTypeSrv/GameServer.hpp>
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
 #include <RTypeSrv/Gateway.hpp>
+#include <RTypeSrv/ReusePortGroup.hpp>
+#include <algorithm>
 #include <iostream>
+#include <optional>
 
 /**
  * @brief Starts the TCP server in a new thread.
- * @param endpoint The endpoint to listen on.
+ * @param cfg The server configuration (TCP endpoint and socket buffer sizes).
  * @param quitServer An atomic boolean to signal the server to quit.
  * @return A thread object representing the running server.
  */
-std::thread rtype::srv::startTcpServer(const network::Endpoint &endpoint, std::atomic<bool> &quitServer) noexcept
+std::thread rtype::srv::startTcpServer(const Config &cfg, std::atomic<bool> &quitServer) noexcept
 {
-    return std::thread([endpoint, &quitServer]() {
+    const network::Endpoint endpoint = cfg.tcp_endpoint;
+    const SocketBuffers buffers{cfg.tcp_rcvbuf, cfg.tcp_sndbuf};
+
+    return std::thread([endpoint, buffers, &quitServer]() {
         Gateway &s = Gateway::getInstance();
 
         try {
-            s.initServer(endpoint, quitServer);
+            s.initServer(endpoint, quitServer, buffers);
             s.startServer();
         } catch (const Exception &e) {
             std::cerr << "Exception caught while running server: " << e.where() << ": " << e.what() << std::endl;
@@ -26,28 +33,62 @@ std::thread rtype::srv::startTcpServer(const network::Endpoint &endpoint, std::a
 
 /**
  * @brief Starts the UDP servers in new threads.
- * @param baseEndpoint The base endpoint to listen on.
- * @param ncores The number of cores to use.
- * @param tcpEndpoint The TCP endpoint to connect to.
+ *
+ * Without `udp_reuseport` worker i listens on `udp_port + i`. With it the sockets are
+ * opened here, in order, before any thread starts, so worker i owns index i of the
+ * kernel reuseport group (see ReusePortGroup).
+ *
+ * @param cfg The server configuration (endpoints, number of workers and UDP options).
  * @param quitServer An atomic boolean to signal the server to quit.
  * @return A vector of thread objects representing the running servers.
  */
-std::vector<std::thread> rtype::srv::startUdpServers(network::Endpoint baseEndpoint, std::size_t ncores,
-    const network::Endpoint &tcpEndpoint, network::Endpoint externalUdpEndpoint, std::atomic<bool> &quitServer) noexcept
+std::vector<std::thread> rtype::srv::startUdpServers(const Config &cfg, std::atomic<bool> &quitServer) noexcept
 {
     std::vector<std::thread> threads{};
+    std::optional<ReusePortGroup> group;
+    network::Endpoint baseEndpoint = cfg.udp_endpoint;
+    network::Endpoint externalUdpEndpoint = cfg.external_udp_endpoint;
+    const network::Endpoint tcpEndpoint = cfg.tcp_endpoint;
+    const std::size_t ncores = cfg.n_cores;
+    GameServer::UdpOptions udp;
 
+    udp.engine = cfg.udp_io_uring ? GameServer::IoEngine::IO_URING : GameServer::IoEngine::POLL;
+    udp.gso = cfg.udp_gso;
+    udp.buffers = SocketBuffers{cfg.udp_rcvbuf, cfg.udp_sndbuf};
+    udp.mtu = static_cast<uint16_t>(std::clamp<std::size_t>(cfg.udp_mtu, GameServerUDPPacketParser::MIN_PACKET_SIZE,
+        GameServerUDPPacketParser::MAX_PACKET_SIZE));
+    udp.snapshot_precision = SnapshotPrecision{cfg.snapshot_x, cfg.snapshot_y};
+    udp.compression = cfg.snapshot_compression;
+    udp.compression_min_saving = cfg.snapshot_compression_min_saving;
+    udp.interest = InterestOptions{static_cast<float>(cfg.interest_radius), static_cast<float>(cfg.interest_hysteresis)};
+    udp.snapshot_budget = cfg.snapshot_budget;
+    udp.max_rate = cfg.udp_max_rate;
+    udp.max_mtu = static_cast<uint16_t>((std::min) (cfg.udp_max_mtu, std::size_t{GameServerUDPPacketParser::MAX_PROBED_SIZE}));
+    if (cfg.udp_reuseport) {
+        try {
+            group.emplace(baseEndpoint, ncores);
+        } catch (const Exception &e) {
+            std::cerr << "Exception caught while opening UDP sockets: " << e.where() << ": " << e.what() << std::endl;
+            return threads;
+        }
+    }
     threads.reserve(ncores);
     for (std::size_t i = 0; i < ncores; ++i) {
-        threads.emplace_back([baseEndpoint, ncores, tcpEndpoint, externalUdpEndpoint, &quitServer]() {
+        std::optional<GameServer::Shard> shard;
+        if (group) {
+            shard = GameServer::Shard{i, ncores, group->release(i)};
+        }
+        threads.emplace_back([baseEndpoint, ncores, tcpEndpoint, externalUdpEndpoint, shard, udp, &quitServer]() {
             try {
-                GameServer(baseEndpoint, ncores, tcpEndpoint, externalUdpEndpoint, quitServer).StartServer();
+                GameServer(baseEndpoint, ncores, tcpEndpoint, externalUdpEndpoint, quitServer, shard, udp).StartServer();
             } catch (const Exception &e) {
                 std::cerr << "Exception caught while running server: " << e.where() << ": " << e.what() << std::endl;
             }
         });
-        ++baseEndpoint.port;
-        ++externalUdpEndpoint.port;
+        if (!group) {
+            ++baseEndpoint.port;
+            ++externalUdpEndpoint.port;
+        }
     }
     return threads;
 }
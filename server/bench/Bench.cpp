@@ -0,0 +1,50 @@
+#include "Bench.hpp"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+
+rtype::srv::bench::Stopwatch::Stopwatch() noexcept : _wall(std::chrono::steady_clock::now()), _cpu(threadCpuTime())
+{
+}
+
+std::chrono::nanoseconds rtype::srv::bench::Stopwatch::wall() const noexcept
+{
+    return std::chrono::steady_clock::now() - _wall;
+}
+
+std::chrono::nanoseconds rtype::srv::bench::Stopwatch::cpu() const noexcept
+{
+    return threadCpuTime() - _cpu;
+}
+
+std::chrono::nanoseconds rtype::srv::bench::threadCpuTime() noexcept
+{
+#if defined(_WIN32)
+    // No per-thread clock in the standard library; the process clock includes the helper threads.
+    return std::chrono::nanoseconds(static_cast<int64_t>(std::clock()) * (1'000'000'000 / CLOCKS_PER_SEC));
+#else
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+#endif
+}
+
+void rtype::srv::bench::report(const std::string_view name, const uint64_t items, const std::string_view unit, const Stopwatch &run)
+{
+    const double seconds = std::chrono::duration<double>(run.wall()).count();
+    const auto cpu = static_cast<double>(run.cpu().count());
+    std::cout << std::left << std::setw(32) << name << std::right << std::setw(12) << items << ' ' << unit << std::fixed
+              << std::setprecision(0) << std::setw(14) << (seconds > 0.0 ? static_cast<double>(items) / seconds : 0.0) << ' ' << unit
+              << "/s" << std::setprecision(1) << std::setw(12) << (items > 0 ? cpu / static_cast<double>(items) : 0.0) << " ns CPU each"
+              << std::endl;
+}
+
+void rtype::srv::bench::keep(const void *value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(value) : "memory");
+#else
+    static const void *volatile sink = nullptr;
+    sink = value;
+#endif
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace rtype::srv::bench {
+
+constexpr auto RUN_TIME = std::chrono::seconds(1);///< Of each case
+
+/**
+ * @brief Measures the wall-clock and CPU time of the calling thread over a run.
+ *
+ * CPU time is the thread's own (CLOCK_THREAD_CPUTIME_ID), so helper threads
+ * feeding or draining a run do not count in its cost.
+ */
+class Stopwatch final
+{
+    public:
+        Stopwatch() noexcept;
+
+        [[nodiscard]] std::chrono::nanoseconds wall() const noexcept;
+        [[nodiscard]] std::chrono::nanoseconds cpu() const noexcept;
+
+    private:
+        std::chrono::steady_clock::time_point _wall;
+        std::chrono::nanoseconds _cpu;
+};
+
+/**
+ * @brief Gets the CPU time the calling thread used so far.
+ */
+[[nodiscard]] std::chrono::nanoseconds threadCpuTime() noexcept;
+
+/**
+ * @brief Prints one result line: the items per second and the CPU time per item.
+ * @param name The case, e.g. "poll recv 64 B".
+ * @param items What was processed: packets, entities...
+ * @param unit The name of an item, plural.
+ */
+void report(std::string_view name, uint64_t items, std::string_view unit, const Stopwatch &run);
+
+/**
+ * @brief Keeps the optimizer from dropping a computation whose result is unused.
+ */
+void keep(const void *value) noexcept;
+
+/**
+ * @brief Calls a case over and over for RUN_TIME and reports its cost per item.
+ * @param items The items one call of step processes.
+ */
+template<typename Step>
+void repeat(const std::string_view name, const uint64_t items, const std::string_view unit, Step &&step)
+{
+    constexpr uint64_t CHUNK = 1024;///< Calls between two clock reads
+    uint64_t calls = 0;
+    const Stopwatch run;
+    while (run.wall() < RUN_TIME) {
+        for (uint64_t i = 0; i < CHUNK; ++i) {
+            step();
+        }
+        calls += CHUNK;
+    }
+    report(name, calls * items, unit, run);
+}
+
+int runEngines();
+int runWriter();
+int runSnapshot();
+int runCipher();
+
+}// namespace rtype::srv::bench
@@ -0,0 +1,103 @@
+#include "Bench.hpp"
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/PacketCipher.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/PacketWriter.hpp>
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace GSPcol = rtype::srv::GSPcol;
+using Parser = rtype::srv::GameServerUDPPacketParser;
+using rtype::srv::PacketCipher;
+
+constexpr std::array SIZES{std::size_t{64}, std::size_t{256}, std::size_t{1200}};///< An input, a delta, a full snapshot
+constexpr PacketCipher::Key KEY{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28,
+    29, 30, 31, 32};
+
+/**
+ * @brief Makes a clear packet of the given size on the wire: a header and a payload of arbitrary bytes.
+ */
+std::vector<uint8_t> makePacket(const std::size_t size)
+{
+    std::vector<uint8_t> packet(size);
+    rtype::srv::PacketWriter out(packet);
+    Parser::writeHeader(out, GSPcol::CMD::SNAPSHOT, GSPcol::FLAGS{}, Parser::HeaderFields{.seq = 7}, GSPcol::CHANNEL::UU,
+        static_cast<uint16_t>(size), 42);
+    for (std::size_t i = out.size(); i < size; ++i) {
+        packet[i] = static_cast<uint8_t>(i * 31);
+    }
+    return packet;
+}
+
+/**
+ * @brief Copies a clear packet into a pooled buffer, as the outbox leaves it before sealing.
+ */
+void load(rtype::srv::PacketBuffer &buffer, const std::vector<uint8_t> &clear)
+{
+    std::ranges::copy(clear, buffer.storage().begin());
+    buffer.resize(clear.size());
+}
+
+/**
+ * @brief Measures seal() and open() on one packet size.
+ * @return false if the packet does not open back to what was sealed.
+ */
+bool runSize(PacketCipher &cipher, rtype::srv::PacketPool &pool, const std::size_t size)
+{
+    const std::vector<uint8_t> clear = makePacket(size);
+    rtype::srv::PacketBuffer packet = pool.acquire();
+    load(packet, clear);
+    if (!cipher.seal(KEY, PacketCipher::Direction::SERVER, packet)) {
+        return false;
+    }
+    const std::vector<uint8_t> sealed(packet.data(), packet.data() + packet.size());
+    std::vector<uint8_t> opened(sealed.size());
+    if (!cipher.open(KEY, PacketCipher::Direction::SERVER, sealed, opened)
+        || !std::ranges::equal(std::span(opened).first(size).subspan(Parser::HEADER_SIZE), std::span(clear).subspan(Parser::HEADER_SIZE))) {
+        return false;
+    }
+
+    const std::string name = std::to_string(size) + " B";
+    rtype::srv::bench::repeat("seal " + name, 1, "packets", [&] {
+        load(packet, clear);
+        (void) cipher.seal(KEY, PacketCipher::Direction::SERVER, packet);
+    });
+    rtype::srv::bench::repeat("open " + name, 1, "packets",
+        [&] { (void) cipher.open(KEY, PacketCipher::Direction::SERVER, sealed, opened); });
+    rtype::srv::bench::keep(opened.data());
+    return true;
+}
+
+}// namespace
+
+/**
+ * @brief Measures the ChaCha20-Poly1305 cost per packet of an encrypting client, sealed by the server or opened from it.
+ *
+ * The size is the clear packet's, header included; TAG_SIZE bytes more go on the
+ * wire. Sealing works in place, so each seal also copies the clear packet back
+ * into the buffer, a few ns of its cost. Before timing, the sealed packet is
+ * opened back and compared with the clear one.
+ */
+int rtype::srv::bench::runCipher()
+{
+    try {
+        PacketCipher cipher;
+        PacketPool pool;
+        for (const std::size_t size : SIZES) {
+            if (!runSize(cipher, pool, size)) {
+                std::cerr << "Cipher benchmark failed: a " << size << "-byte packet does not open back" << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Cipher benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include "Bench.hpp"
+#include <iostream>
+
+#if defined(__linux__)
+    #include <RTypeSrv/DatagramQueue.hpp>
+    #include <RTypeSrv/DatagramRing.hpp>
+    #include <RTypeSrv/Exception.hpp>
+    #include <RTypeSrv/IoUringEngine.hpp>
+    #include <RTypeSrv/PacketPool.hpp>
+    #include <RTypeSrv/Reactor.hpp>
+    #include <RTypeSrv/SocketBuffers.hpp>
+    #include <RTypeSrv/Utils/SockAddr.hpp>
+    #include <algorithm>
+    #include <array>
+    #include <cstring>
+    #include <iomanip>
+    #include <memory>
+    #include <netinet/in.h>
+    #include <string>
+    #include <sys/socket.h>
+    #include <thread>
+    #include <unistd.h>
+
+namespace {
+
+using rtype::srv::bench::RUN_TIME;
+using rtype::srv::bench::Stopwatch;
+
+constexpr auto WAIT = std::chrono::milliseconds(10);
+constexpr std::array SIZES{std::size_t{64}, std::size_t{1200}};///< An input, a full snapshot datagram
+constexpr std::size_t BATCH = rtype::srv::DatagramQueue::BATCH_SIZE;
+constexpr std::size_t SOCKET_BUFFER = 4 * 1024 * 1024;
+
+enum class Engine : uint8_t { POLL, IO_URING };
+
+/**
+ * @brief A non-blocking UDP socket bound to an ephemeral port of 127.0.0.1, closed with the object.
+ */
+class LoopbackSocket final
+{
+    public:
+        LoopbackSocket() : _handle(::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP))
+        {
+            if (_handle == -1) {
+                throw rtype::srv::Exception("LoopbackSocket", "socket failed: ", std::strerror(errno));
+            }
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            sockaddr_storage bound{};
+            socklen_t len = sizeof(bound);
+            if (::bind(_handle, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) == -1
+                || ::getsockname(_handle, reinterpret_cast<sockaddr *>(&bound), &len) == -1) {
+                ::close(_handle);
+                throw rtype::srv::Exception("LoopbackSocket", "bind failed: ", std::strerror(errno));
+            }
+            _endpoint = rtype::srv::utils::fromSockaddr(bound);
+            (void) rtype::srv::applySocketBuffers(_handle, {SOCKET_BUFFER, SOCKET_BUFFER});
+        }
+        ~LoopbackSocket() noexcept
+        {
+            ::close(_handle);
+        }
+        LoopbackSocket(const LoopbackSocket &) = delete;
+        LoopbackSocket &operator=(const LoopbackSocket &) = delete;
+
+        [[nodiscard]] rtype::network::Handle handle() const noexcept
+        {
+            return _handle;
+        }
+        [[nodiscard]] const rtype::network::Endpoint &endpoint() const noexcept
+        {
+            return _endpoint;
+        }
+
+    private:
+        rtype::network::Handle _handle;
+        rtype::network::Endpoint _endpoint{};
+};
+
+/**
+ * @brief Queues a batch of datagrams of the given size, as the tick flush does.
+ */
+template<typename Sink>
+void pushBatch(rtype::srv::PacketPool &pool, const rtype::network::Endpoint &to, const std::size_t size, Sink &sink)
+{
+    for (std::size_t i = 0; i < BATCH; ++i) {
+        rtype::srv::PacketBuffer packet = pool.acquire();
+        std::fill_n(packet.storage().begin(), size, static_cast<uint8_t>(i));
+        packet.resize(size);
+        sink.push(to, std::move(packet));
+    }
+}
+
+/**
+ * @brief Sends datagrams of the given size to a socket as fast as sendmmsg() allows, until asked to stop.
+ */
+void blast(const LoopbackSocket &from, const rtype::network::Endpoint &to, const std::size_t size, const std::stop_token &stop)
+{
+    rtype::srv::PacketPool pool;
+    rtype::srv::DatagramQueue queue;
+    while (!stop.stop_requested()) {
+        pushBatch(pool, to, size, queue);
+        if (!queue.flush(from.handle())) {
+            queue.clear();// The receiver is behind: what the kernel refused is lost, as on a real link
+            std::this_thread::yield();
+        }
+    }
+}
+
+/**
+ * @brief Drains a socket with recvmmsg() until asked to stop.
+ * @return The number of datagrams received.
+ */
+uint64_t sink(const LoopbackSocket &socket, rtype::srv::Reactor &reactor, const std::stop_token &stop)
+{
+    rtype::srv::DatagramRing ring;
+    uint64_t received = 0;
+    while (!stop.stop_requested()) {
+        if (!reactor.wait(WAIT).empty()) {
+            received += ring.drain(socket.handle());
+            ring.clear();
+        }
+    }
+    return received;
+}
+
+/**
+ * @brief Receives with one engine, waking on the reactor as a worker does, while a thread floods the socket.
+ */
+void receive(const Engine engine, const std::size_t size)
+{
+    LoopbackSocket socket;
+    const LoopbackSocket from;
+    std::unique_ptr<rtype::srv::IoUringEngine> uring;
+    rtype::srv::DatagramRing ring;
+    rtype::srv::Reactor reactor;
+    if (engine == Engine::IO_URING) {
+        uring = std::make_unique<rtype::srv::IoUringEngine>(socket.handle());
+    }
+    reactor.add(uring ? uring->eventHandle() : socket.handle(), rtype::srv::Reactor::READ);
+
+    const std::jthread sender([&](const std::stop_token &stop) { blast(from, socket.endpoint(), size, stop); });
+    uint64_t received = 0;
+    const Stopwatch run;
+    while (run.wall() < RUN_TIME) {
+        if (reactor.wait(WAIT).empty()) {
+            continue;
+        }
+        if (uring) {
+            received += uring->drain();
+            uring->clear();
+        } else {
+            received += ring.drain(socket.handle());
+            ring.clear();
+        }
+    }
+    const std::string name = std::string(engine == Engine::POLL ? "poll" : "io_uring") + " recv " + std::to_string(size) + " B";
+    rtype::srv::bench::report(name, received, "packets", run);
+}
+
+/**
+ * @brief Sends with one engine, a batch per flush as the tick does, while a thread drains the destination.
+ */
+void send(const Engine engine, const std::size_t size)
+{
+    LoopbackSocket socket;
+    LoopbackSocket destination;
+    std::unique_ptr<rtype::srv::IoUringEngine> uring;
+    rtype::srv::DatagramQueue queue;
+    rtype::srv::PacketPool pool;
+    rtype::srv::Reactor reactor;
+    rtype::srv::Reactor sink_reactor;
+    sink_reactor.add(destination.handle(), rtype::srv::Reactor::READ);
+    if (engine == Engine::IO_URING) {
+        uring = std::make_unique<rtype::srv::IoUringEngine>(socket.handle());
+        reactor.add(uring->eventHandle(), rtype::srv::Reactor::READ);
+    } else {
+        reactor.add(socket.handle(), rtype::srv::Reactor::WRITE);
+    }
+
+    uint64_t delivered = 0;
+    std::jthread receiver([&](const std::stop_token &stop) { delivered = sink(destination, sink_reactor, stop); });
+    const Stopwatch run;
+    while (run.wall() < RUN_TIME) {
+        if (uring) {
+            pushBatch(pool, destination.endpoint(), size, *uring);
+            // A full ring waits for completions to free its slots, as a worker does.
+            while (!uring->flush()) {
+                (void) reactor.wait(WAIT);
+                uring->drain();
+            }
+            uring->drain();
+        } else {
+            pushBatch(pool, destination.endpoint(), size, queue);
+            while (!queue.flush(socket.handle())) {
+                (void) reactor.wait(WAIT);
+            }
+        }
+    }
+    const uint64_t sent = uring ? uring->stats().send_datagrams : queue.stats().datagrams;// Completed within the run
+    const std::string name = std::string(engine == Engine::POLL ? "poll" : "io_uring") + " send " + std::to_string(size) + " B";
+    rtype::srv::bench::report(name, sent, "packets", run);
+    receiver.request_stop();
+    receiver.join();
+    std::cout << std::string(32, ' ') << std::setw(12) << delivered << " delivered" << std::endl;
+}
+
+}// namespace
+
+/**
+ * @brief Compares the poll (recvmmsg / sendmmsg) and io_uring engines on loopback.
+ *
+ * Each case runs for RUN_TIME on a fresh socket pair. Receive counts what the
+ * engine drained while another thread floods it; send counts what the engine
+ * handed to the kernel, flushing a BATCH per call, while another thread drains
+ * the destination. The CPU time is the engine thread's only.
+ */
+int rtype::srv::bench::runEngines()
+{
+    for (const Engine engine : {Engine::POLL, Engine::IO_URING}) {
+        if (engine == Engine::IO_URING && !IoUringEngine::available()) {
+            std::cout << "io_uring: not built (liburing missing), skipped" << std::endl;
+            continue;
+        }
+        try {
+            for (const std::size_t size : SIZES) {
+                receive(engine, size);
+                send(engine, size);
+            }
+        } catch (const std::exception &e) {
+            std::cerr << "Engine benchmark failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+int rtype::srv::bench::runEngines()
+{
+    std::cout << "engine: Linux only, skipped" << std::endl;
+    return 0;
+}
+
+#endif
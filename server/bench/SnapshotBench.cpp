@@ -0,0 +1,162 @@
+#include "Bench.hpp"
+#include <RTypeSrv/PacketWriter.hpp>
+#include <RTypeSrv/Snapshot.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ::SnapshotEntity;
+using rtype::srv::SnapshotPrecision;
+
+constexpr std::array WORLDS{std::size_t{10}, std::size_t{90}, std::size_t{500}};///< A few players, a busy wave, a stress case
+constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+/**
+ * @brief Makes a state of n entities sorted by id, with gaps in the ids and one entity out of the quantized bounds.
+ */
+std::vector<SnapshotEntity> makeWorld(const std::size_t n)
+{
+    std::vector<SnapshotEntity> world;
+    uint32_t seed = 12345;
+    const auto next = [&seed](const uint32_t range) {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>((seed >> 8) % range) + static_cast<float>(seed & 0xff) / 256.0f;
+    };
+    for (std::size_t i = 0; i < n; ++i) {
+        world.push_back(SnapshotEntity{static_cast<uint32_t>(1 + i + i / 8), next(2200) - 100.0f, next(1200) - 60.0f});
+    }
+    if (!world.empty()) {
+        world.front().x = 5000.0f;// Sent RAW
+    }
+    return world;
+}
+
+/**
+ * @brief Makes the next tick of a state: a third of the entities move, one is destroyed and one spawns.
+ */
+std::vector<SnapshotEntity> makeNextTick(std::vector<SnapshotEntity> world)
+{
+    for (std::size_t i = 0; i < world.size(); i += 3) {
+        world[i].x += 1.5f;
+        world[i].y -= 0.75f;
+    }
+    if (!world.empty()) {
+        const uint32_t spawned = world.back().id + 1;
+        world.erase(world.begin() + static_cast<std::ptrdiff_t>(world.size() / 2));
+        world.push_back(SnapshotEntity{spawned, 320.0f, 240.0f});
+    }
+    return world;
+}
+
+/**
+ * @brief Tells whether a decoded state matches the encoded one: same ids, coordinates within half a step.
+ */
+bool matches(const std::vector<SnapshotEntity> &decoded, const std::vector<SnapshotEntity> &expected, const SnapshotPrecision &precision)
+{
+    const auto close = [](const float a, const float b, const rtype::srv::Quantization &q) {
+        const double step = (static_cast<double>(q.max) - static_cast<double>(q.min)) / static_cast<double>((1U << q.bits) - 1);
+        return std::abs(static_cast<double>(a) - static_cast<double>(b)) <= step / 2.0 + 1e-3;
+    };
+    return std::ranges::equal(decoded, expected, [&](const SnapshotEntity &a, const SnapshotEntity &b) {
+        return a.id == b.id && close(a.x, b.x, precision.x) && close(a.y, b.y, precision.y);
+    });
+}
+
+/**
+ * @brief Prints the size of an encoded state under its timing line.
+ */
+void printSize(const std::size_t bytes, const std::size_t entities)
+{
+    std::cout << std::string(32, ' ') << std::setw(12) << bytes << " B" << std::fixed << std::setprecision(1) << std::setw(14)
+              << static_cast<double>(bytes) / static_cast<double>(entities) << " B per entity" << std::endl;
+}
+
+/**
+ * @brief Measures the four encoders and the two decoders on one world size.
+ * @return false if a quantized state does not decode back to what was encoded.
+ */
+bool runWorld(const std::size_t n)
+{
+    namespace snapshot = rtype::srv::snapshot;
+    const SnapshotPrecision precision{};
+    const std::vector<SnapshotEntity> baseline = makeWorld(n);
+    const std::vector<SnapshotEntity> current = makeNextTick(baseline);
+    std::vector<uint8_t> buffer(BUFFER_SIZE);
+    std::vector<uint8_t> keyframe;
+    std::vector<uint8_t> delta;
+    std::vector<SnapshotEntity> decoded;
+    std::vector<SnapshotEntity> applied;
+
+    // Round trip first: a client holds the decoded keyframe, and applies the delta to it.
+    rtype::srv::PacketWriter keyframe_out(buffer);
+    snapshot::writeQuantizedKeyframe(keyframe_out, baseline, precision);
+    keyframe.assign(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(keyframe_out.size()));
+    rtype::srv::PacketWriter delta_out(buffer);
+    if (!snapshot::writeQuantizedDelta(delta_out, baseline, current, precision)) {
+        return false;
+    }
+    delta.assign(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(delta_out.size()));
+    if (!snapshot::readQuantizedKeyframe(keyframe, precision, decoded) || !matches(decoded, baseline, precision)
+        || !snapshot::readQuantizedDelta(delta, precision, decoded, applied) || !matches(applied, current, precision)) {
+        return false;
+    }
+
+    const std::string size = " " + std::to_string(n);
+    std::size_t bytes = 0;
+    rtype::srv::bench::repeat("float keyframe" + size, n, "entities", [&] {
+        rtype::srv::PacketWriter w(buffer);
+        snapshot::writeKeyframe(w, baseline);
+        bytes = w.size();
+    });
+    printSize(bytes, n);
+    rtype::srv::bench::repeat("quantized keyframe" + size, n, "entities", [&] {
+        rtype::srv::PacketWriter w(buffer);
+        snapshot::writeQuantizedKeyframe(w, baseline, precision);
+        bytes = w.size();
+    });
+    printSize(bytes, n);
+    rtype::srv::bench::repeat("float delta" + size, n, "entities", [&] {
+        rtype::srv::PacketWriter w(buffer);
+        (void) snapshot::writeDelta(w, baseline, current);
+        bytes = w.size();
+    });
+    printSize(bytes, n);
+    rtype::srv::bench::repeat("quantized delta" + size, n, "entities", [&] {
+        rtype::srv::PacketWriter w(buffer);
+        (void) snapshot::writeQuantizedDelta(w, baseline, current, precision);
+        bytes = w.size();
+    });
+    printSize(bytes, n);
+    rtype::srv::bench::repeat("read quantized keyframe" + size, n, "entities",
+        [&] { (void) snapshot::readQuantizedKeyframe(keyframe, precision, decoded); });
+    rtype::srv::bench::repeat("read quantized delta" + size, n, "entities",
+        [&] { (void) snapshot::readQuantizedDelta(delta, precision, decoded, applied); });
+    rtype::srv::bench::keep(buffer.data());
+    return true;
+}
+
+}// namespace
+
+/**
+ * @brief Measures the snapshot encoders: bytes and CPU time per entity, keyframes and deltas, float and quantized.
+ *
+ * The delta goes from a world to its next tick, in which a third of the entities
+ * moved, one was destroyed and one spawned. Before timing, the quantized keyframe
+ * and delta are decoded back and compared with the states they encode.
+ */
+int rtype::srv::bench::runSnapshot()
+{
+    for (const std::size_t n : WORLDS) {
+        if (!runWorld(n)) {
+            std::cerr << "Snapshot benchmark failed: the quantized state of " << n << " entities does not round-trip" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
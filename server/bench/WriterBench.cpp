@@ -0,0 +1,145 @@
+#include "Bench.hpp"
+#include <RTypeSrv/GameServerPacketParser.hpp>
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/PacketWriter.hpp>
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <span>
+#include <vector>
+
+namespace {
+
+namespace GSPcol = rtype::srv::GSPcol;
+using Parser = rtype::srv::GameServerUDPPacketParser;
+
+constexpr std::size_t SNAPSHOT_STATE = 200;      ///< A small keyframe
+constexpr std::size_t FRAGMENTED_STATE = 4 * 1024;///< A keyframe cut into fragments at MAX_PACKET_SIZE
+constexpr uint32_t CLIENT_ID = 42;
+
+/**
+ * @brief Builds a packet as the builders did before PacketWriter, the baseline of the cases below.
+ *
+ * The header is stored byte by byte, every field shifted and masked apart, then
+ * appended to a pooled buffer with the payload behind it.
+ */
+rtype::srv::PacketBuffer buildBaseline(rtype::srv::PacketPool &pool, const GSPcol::CMD cmd, const std::span<const uint8_t> payload)
+{
+    const auto size = static_cast<uint16_t>(Parser::HEADER_SIZE + payload.size());
+    std::array<uint8_t, Parser::HEADER_SIZE> out{};
+    out[0] = static_cast<uint8_t>(Parser::HEADER_MAGIC >> 8);
+    out[1] = static_cast<uint8_t>(Parser::HEADER_MAGIC & 0xFF);
+    out[2] = Parser::VERSION;
+    out[3] = static_cast<uint8_t>(cmd == GSPcol::CMD::PONG ? GSPcol::FLAGS::CONN : GSPcol::FLAGS{});
+    for (std::size_t i = 4; i < 13; ++i) {
+        out[i] = 0;// SEQ, ACK_BASE, ACK_BITS
+    }
+    out[13] = static_cast<uint8_t>(GSPcol::CHANNEL::UU);
+    out[14] = static_cast<uint8_t>(size >> 8);
+    out[15] = static_cast<uint8_t>(size & 0xFF);
+    out[16] = static_cast<uint8_t>((CLIENT_ID >> 24) & 0xFF);
+    out[17] = static_cast<uint8_t>((CLIENT_ID >> 16) & 0xFF);
+    out[18] = static_cast<uint8_t>((CLIENT_ID >> 8) & 0xFF);
+    out[19] = static_cast<uint8_t>(CLIENT_ID & 0xFF);
+    out[20] = static_cast<uint8_t>(cmd);
+    rtype::srv::PacketBuffer packet = pool.acquire();
+    packet.append(out);
+    packet.append(payload);
+    rtype::srv::bench::keep(packet.data());
+    return packet;
+}
+
+/**
+ * @brief Builds the same packet as buildBaseline() through a PacketWriter, as the outbox does for a message alone.
+ */
+rtype::srv::PacketBuffer buildWritten(rtype::srv::PacketPool &pool, const GSPcol::CMD cmd, const std::span<const uint8_t> payload)
+{
+    rtype::srv::PacketBuffer packet = pool.acquire();
+    rtype::srv::PacketWriter out(packet.storage());
+    Parser::writeHeader(out, cmd, cmd == GSPcol::CMD::PONG ? GSPcol::FLAGS::CONN : GSPcol::FLAGS{}, Parser::HeaderFields{},
+        GSPcol::CHANNEL::UU, static_cast<uint16_t>(Parser::HEADER_SIZE + payload.size()), CLIENT_ID);
+    out.bytes(payload);
+    packet.resize(out.size());
+    rtype::srv::bench::keep(packet.data());
+    return packet;
+}
+
+/**
+ * @brief Builds a SNAPSHOT of the given state size into a send queue with appendMessage(), fragmented past MAX_PACKET_SIZE.
+ * @return The bytes queued.
+ */
+std::size_t buildSnapshot(rtype::srv::PacketPool &pool, std::vector<rtype::srv::PacketBuffer> &queue, const std::vector<uint8_t> &state)
+{
+    queue.clear();
+    (void) Parser::appendMessage(pool, queue, GSPcol::CMD::SNAPSHOT, GSPcol::FLAGS{}, GSPcol::CHANNEL::UU,
+        Parser::HeaderFields{}, CLIENT_ID, {std::span<const uint8_t>(state)});
+    std::size_t bytes = 0;
+    for (const rtype::srv::PacketBuffer &packet : queue) {
+        bytes += packet.size();
+    }
+    rtype::srv::bench::keep(queue.data());
+    return bytes;
+}
+
+/**
+ * @brief Tells whether the baseline, PacketWriter and appendMessage() build the same bytes for a PONG and a SNAPSHOT.
+ */
+bool matchesBaseline(rtype::srv::PacketPool &pool, std::vector<rtype::srv::PacketBuffer> &queue, const std::vector<uint8_t> &state)
+{
+    const auto same = [&pool](const GSPcol::CMD cmd, const std::span<const uint8_t> payload) {
+        return std::ranges::equal(buildBaseline(pool, cmd, payload).span(), buildWritten(pool, cmd, payload).span());
+    };
+    const rtype::srv::PacketBuffer snapshot = buildWritten(pool, GSPcol::CMD::SNAPSHOT, state);
+    (void) buildSnapshot(pool, queue, state);
+    return same(GSPcol::CMD::PONG, {}) && same(GSPcol::CMD::SNAPSHOT, state) && queue.size() == 1
+        && std::ranges::equal(snapshot.span(), queue[0].span());
+}
+
+/**
+ * @brief Builds the gateway's JOIN response, a fixed-size TCP packet.
+ */
+std::size_t buildJoinResponse(rtype::srv::PacketPool &pool)
+{
+    constexpr std::array<uint8_t, 16> ip{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 127, 0, 0, 1};
+    const rtype::srv::PacketBuffer packet = rtype::srv::GameServerPacketParser::buildJoinResponse(pool, 7, ip, 4242);
+    rtype::srv::bench::keep(packet.data());
+    return packet.size();
+}
+
+}// namespace
+
+/**
+ * @brief Measures the packet builders (PacketWriter over pooled buffers), pool acquire and release included.
+ *
+ * Each case first checks the size of what it builds, so a builder that stops
+ * writing shows up as a failure rather than as a speed-up. Each baseline case
+ * builds the packet of the case below it the way the builders did before
+ * PacketWriter, checked to produce the same bytes. appendMessage() adds to a
+ * single SNAPSHOT the fragmentation check and the send queue.
+ */
+int rtype::srv::bench::runWriter()
+{
+    PacketPool pool;
+    std::vector<PacketBuffer> queue;
+    const std::vector<uint8_t> small(SNAPSHOT_STATE, 0x5a);
+    const std::vector<uint8_t> large(FRAGMENTED_STATE, 0x5a);
+    if (buildWritten(pool, GSPcol::CMD::PONG, {}).size() != Parser::HEADER_SIZE
+        || buildSnapshot(pool, queue, small) != Parser::HEADER_SIZE + small.size()
+        || buildSnapshot(pool, queue, large) <= Parser::HEADER_SIZE + large.size() || queue.size() < 2) {
+        std::cerr << "Writer benchmark failed: unexpected packet size" << std::endl;
+        return 1;
+    }
+    if (!matchesBaseline(pool, queue, small)) {
+        std::cerr << "Writer benchmark failed: the baseline builds different bytes" << std::endl;
+        return 1;
+    }
+    repeat("baseline PONG (21 B)", 1, "packets", [&] { (void) buildBaseline(pool, GSPcol::CMD::PONG, {}); });
+    repeat("PONG (21 B)", 1, "packets", [&] { (void) buildWritten(pool, GSPcol::CMD::PONG, {}); });
+    repeat("baseline SNAPSHOT (200 B state)", 1, "packets", [&] { (void) buildBaseline(pool, GSPcol::CMD::SNAPSHOT, small); });
+    repeat("SNAPSHOT (200 B state)", 1, "packets", [&] { (void) buildWritten(pool, GSPcol::CMD::SNAPSHOT, small); });
+    repeat("appendMessage SNAPSHOT (200 B)", 1, "messages", [&] { (void) buildSnapshot(pool, queue, small); });
+    repeat("appendMessage SNAPSHOT (4 KiB)", 1, "messages", [&] { (void) buildSnapshot(pool, queue, large); });
+    repeat("gateway JOIN response", 1, "packets", [&] { (void) buildJoinResponse(pool); });
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "Bench.hpp"
+#include <array>
+#include <iostream>
+#include <string_view>
+
+namespace {
+
+struct Bench {
+        std::string_view name;
+        int (*run)();
+        std::string_view what;
+};
+
+constexpr std::array BENCHES{
+    Bench{"engine", &rtype::srv::bench::runEngines, "UDP engines (poll, io_uring) on loopback: receive and send"},
+    Bench{"writer", &rtype::srv::bench::runWriter, "packet builders (PacketWriter, pooled buffers): cost per packet"},
+    Bench{"snapshot", &rtype::srv::bench::runSnapshot, "snapshot state encoders and decoders: bytes and cost per entity"},
+    Bench{"cipher", &rtype::srv::bench::runCipher, "ChaCha20-Poly1305 seal and open (PacketCipher): cost per packet"},
+};
+
+}// namespace
+
+/**
+ * @brief Runs the benchmarks named on the command line, or all of them.
+ *
+ * Build with -DRTYPE_SRV_BENCH=ON, preferably in Release; results vary with the
+ * machine, so compare runs made on the same one.
+ */
+int main(const int argc, const char *const argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view name = argv[i];
+        bool known = false;
+        for (const Bench &bench : BENCHES) {
+            known = known || bench.name == name;
+        }
+        if (!known) {
+            std::cerr << "Unknown benchmark: " << name << "\nUsage: " << argv[0] << " [";
+            for (std::size_t b = 0; b < BENCHES.size(); ++b) {
+                std::cerr << (b > 0 ? "|" : "") << BENCHES[b].name;
+            }
+            std::cerr << "]..." << std::endl;
+            return 1;
+        }
+    }
+    int status = 0;
+    for (const Bench &bench : BENCHES) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || bench.name == argv[i];
+        }
+        if (selected) {
+            std::cout << "== " << bench.name << ": " << bench.what << std::endl;
+            status |= bench.run();
+        }
+    }
+    return status;
+}
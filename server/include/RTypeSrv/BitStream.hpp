@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+namespace rtype::srv {
+
+/**
+ * @brief Bit-granular serializer writing straight into caller-provided memory.
+ *
+ * Values are packed most significant bit first, so a stream read back byte by byte
+ * matches the order the fields were written in. Bits gather in a 64-bit register and
+ * are stored a byte at a time; like PacketWriter, the writer owns nothing and never
+ * allocates.
+ *
+ * @code
+ * BitWriter bits(out.unwritten());
+ * bits.varint(id, 4).bits(x, 16).bits(y, 16);
+ * (void) out.claim(bits.finish());
+ * @endcode
+ */
+class BitWriter final
+{
+    public:
+        /**
+         * @brief Constructs a writer over a destination span.
+         * @param out The memory to fill; the writer never writes past its end.
+         */
+        explicit BitWriter(const std::span<uint8_t> out) noexcept : _out(out)
+        {
+        }
+
+        /**
+         * @brief Writes the low n bits of a value.
+         * @param n Between 0 and 32.
+         * @throws std::length_error If they do not fit; nothing is written then.
+         */
+        BitWriter &bits(const uint32_t value, const unsigned n)
+        {
+            if (n > remainingBits()) {
+                throw std::length_error("BitWriter overflow");
+            }
+            if (n == 0) {
+                return *this;
+            }
+            _acc = (_acc << n) | (value & (0xFFFFFFFFU >> (32 - n)));
+            _pending += n;
+            while (_pending >= 8) {
+                _pending -= 8;
+                _out[_pos++] = static_cast<uint8_t>(_acc >> _pending);
+            }
+            return *this;
+        }
+
+        BitWriter &flag(const bool value)
+        {
+            return bits(value ? 1U : 0U, 1);
+        }
+
+        /**
+         * @brief Writes an unsigned value in groups of groupBits bits (1 to 16), each preceded by a continuation bit.
+         *
+         * Small values cost one group: with groupBits = 4, 0..15 take 5 bits and a full
+         * 32-bit value 40. The groups are written least significant first.
+         *
+         * @throws std::length_error If it does not fit.
+         */
+        BitWriter &varint(uint32_t value, const unsigned groupBits)
+        {
+            if (varintSize(value, groupBits) > remainingBits()) {
+                throw std::length_error("BitWriter overflow");
+            }
+            const uint32_t mask = (1U << groupBits) - 1;
+            while (value > mask) {
+                bits(1, 1).bits(value & mask, groupBits);
+                value >>= groupBits;
+            }
+            return bits(0, 1).bits(value, groupBits);
+        }
+
+        /**
+         * @brief Gets the number of bits varint() takes for a value.
+         */
+        [[nodiscard]] static constexpr std::size_t varintSize(uint32_t value, const unsigned groupBits) noexcept
+        {
+            std::size_t n = 1 + groupBits;
+            for (value >>= groupBits; value != 0; value >>= groupBits) {
+                n += 1 + groupBits;
+            }
+            return n;
+        }
+
+        /**
+         * @brief Pads the last byte with zero bits.
+         * @return The number of bytes written.
+         */
+        std::size_t finish() noexcept
+        {
+            if (_pending > 0) {
+                _out[_pos++] = static_cast<uint8_t>(_acc << (8 - _pending));
+                _pending = 0;
+            }
+            return _pos;
+        }
+
+        /**
+         * @brief Gets the number of bits written so far.
+         */
+        [[nodiscard]] std::size_t sizeBits() const noexcept
+        {
+            return _pos * 8 + _pending;
+        }
+
+        /**
+         * @brief Gets the number of bits that can still be written.
+         */
+        [[nodiscard]] std::size_t remainingBits() const noexcept
+        {
+            return (_out.size() - _pos) * 8 - _pending;
+        }
+
+    private:
+        std::span<uint8_t> _out;
+        std::size_t _pos = 0;
+        uint64_t _acc = 0;
+        unsigned _pending = 0;///< Bits of _acc not stored yet, always fewer than 8
+};
+
+/**
+ * @brief Reads a stream written by BitWriter.
+ *
+ * Reading past the end does not throw: it yields zeros and marks the reader as
+ * failed, so a decoder reads a whole block and checks ok() once.
+ */
+class BitReader final
+{
+    public:
+        explicit BitReader(const std::span<const uint8_t> in) noexcept : _in(in)
+        {
+        }
+
+        /**
+         * @brief Reads n bits, 0 to 32.
+         */
+        uint32_t bits(const unsigned n) noexcept
+        {
+            if (n > remainingBits()) {
+                _failed = true;
+                _bit = _in.size() * 8;
+                return 0;
+            }
+            uint32_t value = 0;
+            for (unsigned left = n; left > 0;) {
+                const std::size_t used = _bit % 8;
+                const unsigned take = static_cast<unsigned>(std::min<std::size_t>(left, 8 - used));
+                const auto byte = static_cast<unsigned>(_in[_bit / 8]);
+                const unsigned chunk = (byte >> (8 - used - take)) & ((1U << take) - 1);
+                value = static_cast<uint32_t>((static_cast<uint64_t>(value) << take) | chunk);
+                _bit += take;
+                left -= take;
+            }
+            return value;
+        }
+
+        bool flag() noexcept
+        {
+            return bits(1) != 0;
+        }
+
+        /**
+         * @brief Reads a value written by BitWriter::varint() with the same group size.
+         *
+         * A value longer than 32 bits marks the reader as failed.
+         */
+        uint32_t varint(const unsigned groupBits) noexcept
+        {
+            uint64_t value = 0;
+            for (unsigned shift = 0;; shift += groupBits) {
+                const bool more = flag();
+                value |= static_cast<uint64_t>(bits(groupBits)) << shift;
+                if (!more || _failed) {
+                    break;
+                }
+                if (shift + groupBits >= 32) {
+                    _failed = true;
+                    return 0;
+                }
+            }
+            if (value > UINT32_MAX) {
+                _failed = true;
+                return 0;
+            }
+            return static_cast<uint32_t>(value);
+        }
+
+        /**
+         * @brief Gets the number of bits left.
+         */
+        [[nodiscard]] std::size_t remainingBits() const noexcept
+        {
+            return _in.size() * 8 - _bit;
+        }
+
+        /**
+         * @brief Tells whether every read so far was within the stream.
+         */
+        [[nodiscard]] bool ok() const noexcept
+        {
+            return !_failed;
+        }
+
+    private:
+        std::span<const uint8_t> _in;
+        std::size_t _bit = 0;
+        bool _failed = false;
+};
+
+}// namespace rtype::srv
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace rtype::srv {
+
+/**
+ * @brief Counters of one command over a stats interval.
+ */
+struct CommandStats {
+        uint64_t calls{0};               ///< Packets handed to the handler
+        uint64_t rejected{0};            ///< Packets refused by the route requirements
+        uint64_t failed{0};              ///< Handler calls that threw
+        std::chrono::nanoseconds busy{0};///< Time spent in the handler
+        std::chrono::nanoseconds max{0};
+};
+
+/**
+ * @brief Per-command counters, indexed by the command byte; owned by the thread dispatching.
+ */
+using CommandCounters = std::array<CommandStats, 256>;
+
+/**
+ * @brief One registered command: its handler and what a packet must satisfy to reach it.
+ */
+template<typename Cmd, typename Handler>
+struct CommandRoute {
+        static constexpr uint8_t ANY_CHANNEL = 0x0F;///< Every 2-bit GSPcol channel
+
+        Cmd cmd{};
+        const char *name = nullptr;
+        Handler handler = nullptr;
+        std::size_t min_payload = 0;   ///< Payload bytes required after the command byte
+        bool authenticated = false;    ///< The sender must have completed the handshake
+        uint8_t channels = ANY_CHANNEL;///< Accepted channels, as a (1 << CHANNEL) mask
+
+        /**
+         * @brief Tells whether a channel value is accepted by the route.
+         */
+        [[nodiscard]] constexpr bool allows(const uint8_t channel) const noexcept
+        {
+            return channel < 8 && (channels & (1U << channel)) != 0;
+        }
+};
+
+/**
+ * @brief Compile-time command registry, laid out as a flat 256-entry jump table.
+ *
+ * The routes are given once, at compile time:
+ * @code
+ * constexpr CommandTable<GSPcol::CMD, Handler> COMMANDS{
+ *     {.cmd = GSPcol::CMD::PING, .name = "PING", .handler = &GameServer::handleUDPPing},
+ * };
+ * @endcode
+ * and a duplicate or missing handler fails the build. Looking a command up is one
+ * indexed load, and call() times the handler into the caller's CommandCounters, so
+ * every registered command is instrumented without any code in the handler.
+ *
+ * The requirements are data only: the dispatching loop checks them, since what
+ * "authenticated" means depends on the protocol.
+ */
+template<typename Cmd, typename Handler>
+class CommandTable final
+{
+        static_assert(std::is_enum_v<Cmd> && sizeof(Cmd) == 1, "commands must be one-byte enums");
+
+    public:
+        using Route = CommandRoute<Cmd, Handler>;
+
+        consteval CommandTable(const std::initializer_list<Route> routes)
+        {
+            for (const Route &route : routes) {
+                Route &slot = _routes[_index(route.cmd)];
+                if (route.handler == nullptr || route.name == nullptr || slot.handler != nullptr) {
+                    throw "CommandTable: every command needs one named handler";
+                }
+                slot = route;
+            }
+        }
+
+        /**
+         * @brief Gets the route of a command.
+         * @return The route, or nullptr if no handler is registered for it.
+         */
+        [[nodiscard]] constexpr const Route *find(const Cmd cmd) const noexcept
+        {
+            const Route &route = _routes[_index(cmd)];
+            return route.handler != nullptr ? &route : nullptr;
+        }
+
+        /**
+         * @brief Invokes the handler of a route and records the call in its counters.
+         * @throws Whatever the handler throws; the call is then counted as failed.
+         */
+        template<typename Owner, typename... Args>
+        static void call(const Route &route, CommandCounters &counters, Owner &owner, Args &&...args)
+        {
+            CommandStats &stats = counters[_index(route.cmd)];
+            const auto start = std::chrono::steady_clock::now();
+            try {
+                (owner.*route.handler)(std::forward<Args>(args)...);
+            } catch (...) {
+                ++stats.failed;
+                _record(stats, start);
+                throw;
+            }
+            _record(stats, start);
+        }
+
+        /**
+         * @brief Counts a packet refused by the requirements of its route.
+         */
+        static void reject(const Route &route, CommandCounters &counters) noexcept
+        {
+            ++counters[_index(route.cmd)].rejected;
+        }
+
+        /**
+         * @brief Formats the commands that saw traffic, e.g. "PING 12 (0.8 us avg, 3 us max)".
+         * @return An empty string if no command was dispatched or rejected.
+         */
+        [[nodiscard]] std::string summary(const CommandCounters &counters) const
+        {
+            std::ostringstream ss;
+            for (std::size_t i = 0; i < _routes.size(); ++i) {
+                const CommandStats &stats = counters[i];
+                if (_routes[i].handler == nullptr || (stats.calls == 0 && stats.rejected == 0)) {
+                    continue;
+                }
+                if (ss.tellp() > 0) {
+                    ss << ", ";
+                }
+                ss << _routes[i].name << ' ' << stats.calls << " ("
+                   << (stats.calls > 0 ? static_cast<double>(stats.busy.count()) / static_cast<double>(stats.calls) / 1000.0 : 0.0)
+                   << " us avg, " << std::chrono::duration_cast<std::chrono::microseconds>(stats.max).count() << " us max";
+                if (stats.rejected > 0) {
+                    ss << ", " << stats.rejected << " rejected";
+                }
+                if (stats.failed > 0) {
+                    ss << ", " << stats.failed << " failed";
+                }
+                ss << ')';
+            }
+            return ss.str();
+        }
+
+    private:
+        static constexpr std::size_t _index(const Cmd cmd) noexcept
+        {
+            return static_cast<std::size_t>(std::to_underlying(cmd));
+        }
+
+        static void _record(CommandStats &stats, const std::chrono::steady_clock::time_point start) noexcept
+        {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            ++stats.calls;
+            stats.busy += elapsed;
+            stats.max = (std::max) (stats.max, elapsed);
+        }
+
+        std::array<Route, 256> _routes{};
+};
+
+}// namespace rtype::srv
@@ -18,8 +18,20 @@ struct Velocity {
     r::Vec2f value;
 };
 
+struct SnapshotEntity {
+    uint32_t id;
+    float x;
+    float y;
+};
+
+struct PlayerEntity {
+    uint32_t clientId;
+    uint32_t entity;
+};
+
 struct GameStateSnapshot {
-    std::vector<uint8_t> data;
+    std::vector<SnapshotEntity> entities; // Sorted by id, as the delta encoder expects
+    std::vector<PlayerEntity> players;    // Entity of each connected client, centre of its area of interest
 };
 
 struct SnapshotSequence {
@@ -0,0 +1,107 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/ReliableChannel.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace rtype::srv {
+
+/**
+ * @brief The send rate of one client, adapted to the losses and delay of its path, and the token bucket holding it to it.
+ *
+ * The rate grows by one datagram per RTT per RTT, as a TCP window would, while the
+ * client takes all it is allowed. It is cut by LOSS_BACKOFF when the acknowledgements
+ * show a loss (ReliableChannel::Feedback), by DELAY_BACKOFF when the RTT climbs over
+ * the lowest seen, a queue building on the path, and halved when nothing is acknowledged
+ * for ACK_TIMEOUT; at most one cut per RTT.
+ *
+ * The bucket fills at the rate up to BURST of sending, and a datagram leaves while it
+ * is not empty, which may overdraw it by one datagram.
+ */
+class RTYPE_SRV_API CongestionController final
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Congestion counters, kept by the caller over all its controllers.
+         */
+        struct Stats {
+                uint64_t losses{0};  ///< Rate cuts on a loss
+                uint64_t delays{0};  ///< Rate cuts on a climbing RTT
+                uint64_t timeouts{0};///< Rate cuts on silence
+                uint64_t held{0};    ///< Datagrams an empty bucket left for a later flush, once per flush
+        };
+
+        /**
+         * @brief Adapts the rate to what the channel learnt since the last call; called once per tick.
+         * @param fallbackRtt An RTT measured otherwise (PING / PONG), used until the channel has a sample; 0 if none.
+         * @param maxRate The highest rate in bytes per second.
+         */
+        void update(const ReliableChannel &channel, std::chrono::microseconds fallbackRtt, Clock::time_point now, std::size_t maxRate,
+            Stats &stats) noexcept;
+
+        /**
+         * @brief Takes the tokens of a datagram.
+         * @return false if the bucket is empty: the datagram must wait.
+         */
+        [[nodiscard]] bool consume(std::size_t bytes, Clock::time_point now) noexcept;
+
+        /**
+         * @brief Gets the bytes the client may take in one interval at the current rate.
+         */
+        [[nodiscard]] std::size_t allowance(std::chrono::microseconds interval) const noexcept;
+
+        /**
+         * @brief Gets the send rate in bytes per second.
+         */
+        [[nodiscard]] std::size_t rate() const noexcept;
+
+        /**
+         * @brief Gets the congestion window the rate stands for: the bytes sent over one RTT.
+         */
+        [[nodiscard]] std::size_t window() const noexcept;
+
+        static constexpr std::size_t INITIAL_RATE = 96 * 1024;///< A full datagram per tick, and some
+        static constexpr std::size_t MIN_RATE = 16 * 1024;    ///< About 270 bytes per tick
+        static constexpr std::size_t SEGMENT = GameServerUDPPacketParser::MAX_PACKET_SIZE;
+        static constexpr double LOSS_BACKOFF = 0.7;
+        static constexpr double DELAY_BACKOFF = 0.85;
+        static constexpr std::chrono::microseconds INITIAL_RTT{std::chrono::milliseconds(100)};
+        static constexpr std::chrono::microseconds DELAY_MARGIN{std::chrono::milliseconds(10)};///< RTT over 1.5 lowest + margin is queueing
+        static constexpr std::chrono::microseconds BURST{std::chrono::milliseconds(32)};       ///< Two ticks
+        static constexpr std::chrono::microseconds ACK_TIMEOUT{std::chrono::seconds(1)};
+        static constexpr auto MIN_RTT_LIFETIME = std::chrono::seconds(10);///< The lowest RTT is forgotten after, in case the path changed
+
+    private:
+        void _refill(Clock::time_point now) noexcept;
+        [[nodiscard]] double _depth() const noexcept;
+
+        double _rate = INITIAL_RATE;///< Bytes per second
+        double _tokens = 0.0;       ///< Bytes; below 0 after a datagram overdrew it
+        bool _limited = false;      ///< The bucket ran dry since the last update()
+        bool _awaiting = false;     ///< Datagrams were sent since the last acknowledgement
+        std::chrono::microseconds _rtt{0};
+        std::chrono::microseconds _min_rtt{0};
+        uint64_t _acked = 0;///< ReliableChannel::Feedback seen by the last update()
+        uint64_t _lost = 0;
+        Clock::time_point _refilled;
+        Clock::time_point _updated;
+        Clock::time_point _cut;     ///< Last rate cut
+        Clock::time_point _progress;///< First datagram sent since the last acknowledgement
+        Clock::time_point _min_rtt_since;
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
@@ -0,0 +1,220 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeNet/Interfaces.hpp>
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+#if defined(__linux__)
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+#endif
+
+namespace rtype::srv {
+
+/**
+ * @brief Outgoing datagram queue flushed in batches.
+ *
+ * Datagrams pushed during a tick are sent together by flush(). On Linux they are
+ * gathered into mmsghdr arrays and sent with sendmmsg() in chunks of BATCH_SIZE.
+ * When the kernel send buffer is full the queue remembers how far it got, and the
+ * next flush() resumes from that index instead of dropping the remaining datagrams.
+ *
+ * With enableSegmentation() consecutive datagrams to the same destination are sent
+ * as one UDP_SEGMENT (GSO) message: the kernel splits it into datagrams of the first
+ * one's size, so a run of snapshot fragments costs one trip through the stack.
+ *
+ * Datagrams queued with pushStamped() report when they left: first the time the
+ * sendmmsg() carrying them returned, then, with enableSendTimestamps(), the software
+ * transmit timestamp the kernel posts on the socket error queue (SO_TIMESTAMPING).
+ */
+class RTYPE_SRV_API DatagramQueue final
+{
+    public:
+        /**
+         * @brief Transmit counters, used to check how well batching works under load.
+         */
+        struct Stats {
+                uint64_t syscalls{0};
+                uint64_t datagrams{0};
+                uint32_t max_batch{0};
+                uint64_t segmented{0};  ///< Messages that carried several datagrams (GSO)
+                uint64_t tx_stamps{0};  ///< Kernel transmit timestamps read from the error queue
+                uint64_t would_block{0};///< Flushes stopped by a full send buffer (EAGAIN), resumed on the next writable event
+                uint64_t partial{0};    ///< sendmmsg() calls that took only part of the batch
+                uint64_t errors{0};     ///< Datagrams dropped on another send error
+        };
+
+        /**
+         * @brief The send time of a datagram queued with pushStamped().
+         */
+        struct SendStamp {
+                network::Endpoint endpoint{};///< The destination of the datagram
+                std::chrono::steady_clock::time_point sent{};
+                bool kernel{false};///< Kernel transmit timestamp rather than the sendmmsg() return time
+        };
+
+        /**
+         * @brief Turns on UDP GSO for the datagrams sent on a socket.
+         *
+         * If a segmented send is later rejected (e.g. the device cannot checksum it),
+         * the queue logs it once and goes back to one datagram per message.
+         *
+         * @param handle The UDP socket the queue is flushed to.
+         * @return false if the platform or kernel does not support UDP_SEGMENT.
+         */
+        bool enableSegmentation(network::Handle handle);
+
+        /**
+         * @brief Requests a kernel transmit timestamp for the datagrams queued with pushStamped().
+         *
+         * The timestamps are posted on the socket error queue, which makes the socket
+         * report an error condition (EPOLLERR) until reapTimestamps() reads them.
+         *
+         * @param handle The UDP socket the queue is flushed to.
+         * @return false if the platform or kernel does not support SO_TIMESTAMPING.
+         */
+        bool enableSendTimestamps(network::Handle handle);
+
+        /**
+         * @brief Queues a datagram for the next flush.
+         * @param endpoint The destination.
+         * @param data The datagram, held by the queue until it is sent.
+         */
+        void push(const network::Endpoint &endpoint, PacketBuffer data);
+
+        /**
+         * @brief Queues a datagram whose send time is reported through sendStamps().
+         *
+         * It is always sent as a message of its own, never merged into a GSO run.
+         *
+         * @param endpoint The destination.
+         * @param data The datagram, held by the queue until it is sent.
+         */
+        void pushStamped(const network::Endpoint &endpoint, PacketBuffer data);
+
+        /**
+         * @brief Sends as many queued datagrams as the socket accepts.
+         * @param handle The UDP socket to send on.
+         * @return true if the queue is now empty, false if the kernel queue filled up first.
+         */
+        bool flush(network::Handle handle);
+
+        /**
+         * @brief Reads the transmit timestamps the kernel posted on the socket error queue.
+         *
+         * Also clears a pending socket error, so a readiness loop does not keep
+         * reporting the socket once the queue is empty.
+         *
+         * @param handle The UDP socket the queue is flushed to.
+         * @return The number of kernel timestamps added to sendStamps().
+         */
+        std::size_t reapTimestamps(network::Handle handle);
+
+        /**
+         * @brief Gets the send times reported since the last clearSendStamps(), oldest first.
+         *
+         * A datagram may appear twice: with its sendmmsg() return time, then with its kernel timestamp.
+         */
+        [[nodiscard]] std::span<const SendStamp> sendStamps() const noexcept;
+
+        /**
+         * @brief Forgets the reported send times.
+         */
+        void clearSendStamps() noexcept;
+
+        /**
+         * @brief Checks whether datagrams are still waiting to be sent.
+         */
+        [[nodiscard]] bool empty() const noexcept;
+
+        /**
+         * @brief Gets the number of datagrams still waiting to be sent.
+         */
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /**
+         * @brief Drops every queued datagram.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Gets the transmit counters accumulated since the last resetStats().
+         */
+        [[nodiscard]] const Stats &stats() const noexcept;
+
+        /**
+         * @brief Resets the transmit counters.
+         */
+        void resetStats() noexcept;
+
+        static constexpr std::size_t BATCH_SIZE = 64;
+        static constexpr std::size_t GSO_MAX_SEGMENTS = 64;///< UDP_MAX_SEGMENTS in the kernel
+        static constexpr std::size_t GSO_MAX_BYTES = 65000;///< Below the 64 KiB UDP length limit
+        static constexpr std::size_t MAX_STAMPS_IN_FLIGHT = 1024;
+        static constexpr std::chrono::milliseconds STAMP_TOLERANCE{50};///< Kernel stamps further than this from the send are dropped
+
+    private:
+        struct Entry {
+                network::Endpoint endpoint{};
+                PacketBuffer data;
+                bool stamped{false};
+        };
+
+        /**
+         * @brief A stamped datagram sent but whose kernel timestamp has not been read yet.
+         */
+        struct InFlight {
+                uint32_t key{0};///< SOF_TIMESTAMPING_OPT_ID counter value of the send
+                network::Endpoint endpoint{};
+                std::chrono::steady_clock::time_point sent{};
+        };
+
+        void _compact() noexcept;
+        void _recordSend(const Entry &entry, std::chrono::steady_clock::time_point sent);
+        [[nodiscard]] std::size_t _segmentRun(std::size_t first, std::size_t maxCount) const noexcept;
+
+        std::vector<Entry> _entries;
+        std::size_t _cursor = 0;
+        std::vector<SendStamp> _stamps;
+        std::deque<InFlight> _in_flight;
+        uint32_t _next_key = 0;
+        bool _tx_stamps = false;
+        Stats _stats{};
+#if defined(__linux__)
+        /**
+         * @brief Room for the UDP_SEGMENT segment size or the SO_TIMESTAMPING request of a message.
+         */
+        union SendControl {
+                cmsghdr align;
+                char buf[CMSG_SPACE(sizeof(uint32_t))];
+        };
+
+        static constexpr std::size_t IOV_CAPACITY = 1024;
+
+        int _family = AF_UNSPEC;
+        bool _gso = false;
+        std::array<mmsghdr, BATCH_SIZE> _msgs{};
+        std::array<iovec, IOV_CAPACITY> _iovs{};
+        std::array<sockaddr_storage, BATCH_SIZE> _addrs{};
+        std::array<SendControl, BATCH_SIZE> _ctrl{};
+        std::array<std::size_t, BATCH_SIZE> _counts{};///< Datagrams carried by each message of the batch
+#endif
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
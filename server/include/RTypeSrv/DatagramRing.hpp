@@ -0,0 +1,184 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeNet/Interfaces.hpp>
+#include <RTypeSrv/Api.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#if defined(__linux__)
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+#endif
+
+namespace rtype::srv {
+
+/**
+ * @brief Preallocated set of datagram slots used to drain a UDP socket in batches.
+ *
+ * On Linux the socket is drained with recvmmsg() until it returns EAGAIN or every
+ * slot is used, so a burst of N datagrams costs roughly N / BATCH_SIZE syscalls and
+ * no heap allocation. Other platforms fall back to a single recvfrom() per drain.
+ *
+ * The views returned by views() point into the ring storage and stay valid until
+ * the next call to drain() or clear().
+ *
+ * With enableGro() the kernel may coalesce consecutive datagrams of one sender into
+ * a single slot; drain() splits them back, so views() may hold more entries than
+ * there are slots.
+ *
+ * With enableTimestamps() every view carries the time the kernel received the
+ * datagram (SO_TIMESTAMPNS), so the time spent waiting in the socket buffer and in
+ * the server loop can be told apart from network latency.
+ *
+ * With enableDropCounter() the kernel reports on each datagram how many were dropped
+ * so far because the socket receive buffer was full (SO_RXQ_OVFL); the increase is
+ * accumulated in Stats::drops.
+ */
+class RTYPE_SRV_API DatagramRing final
+{
+    public:
+        /**
+         * @brief A received datagram: sender address and a view over its bytes.
+         */
+        struct View {
+                std::array<uint8_t, 16> ip{};
+                uint16_t port{0};
+                std::span<const uint8_t> data{};
+                std::chrono::steady_clock::time_point received{};///< Kernel receive time, or the drain time without timestamps
+        };
+
+        /**
+         * @brief Receive counters, used to check how well batching works under load.
+         */
+        struct Stats {
+                uint64_t syscalls{0};
+                uint64_t datagrams{0};
+                uint32_t max_batch{0};
+                uint64_t coalesced{0};///< Slots that carried several GRO datagrams
+                uint64_t stamped{0};  ///< Receive buffers carrying a kernel timestamp
+                uint64_t drops{0};    ///< Datagrams the kernel dropped on a full receive buffer (SO_RXQ_OVFL)
+        };
+
+        /**
+         * @brief Constructs a ring and preallocates every slot.
+         * @param nslots The number of datagram slots.
+         * @param slotSize The size of a single slot, must be at least the largest expected datagram.
+         */
+        explicit DatagramRing(std::size_t nslots = DEFAULT_SLOTS, std::size_t slotSize = DEFAULT_SLOT_SIZE);
+
+        /**
+         * @brief Reads every pending datagram from a socket into free slots.
+         * @param handle The UDP socket to read from.
+         * @return The number of datagrams received by this call.
+         * @throws std::runtime_error On a socket error other than EAGAIN / EWOULDBLOCK.
+         */
+        std::size_t drain(network::Handle handle);
+
+        /**
+         * @brief Turns on UDP_GRO for a socket and resizes the slots to hold a coalesced buffer.
+         *
+         * Must be called before the first drain().
+         *
+         * @param handle The UDP socket the ring drains.
+         * @return false if the platform or kernel does not support UDP GRO; the ring is left unchanged.
+         */
+        bool enableGro(network::Handle handle);
+
+        /**
+         * @brief Turns on SO_TIMESTAMPNS so every view carries its kernel receive time.
+         * @param handle The UDP socket the ring drains.
+         * @return false if the platform or kernel does not support it; views then carry the drain time.
+         */
+        bool enableTimestamps(network::Handle handle);
+
+        /**
+         * @brief Turns on SO_RXQ_OVFL so receive buffer overflows are counted in Stats::drops.
+         * @param handle The UDP socket the ring drains.
+         * @return false if the platform or kernel does not support it.
+         */
+        bool enableDropCounter(network::Handle handle);
+
+        /**
+         * @brief Gets the datagrams currently held by the ring.
+         * @return A span of views, in reception order.
+         */
+        [[nodiscard]] std::span<const View> views() const noexcept;
+
+        /**
+         * @brief Releases every slot so the next drain() starts from the beginning.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Builds the view of a received datagram.
+         *
+         * A sender reported with an all-zero IPv4 part is rewritten to 127.0.0.1.
+         *
+         * @param endpoint The sender.
+         * @param data The datagram bytes.
+         * @param received The time the datagram was received.
+         */
+        [[nodiscard]] static View makeView(const network::Endpoint &endpoint, std::span<const uint8_t> data,
+            std::chrono::steady_clock::time_point received) noexcept;
+
+        /**
+         * @brief Gets the receive counters accumulated since the last resetStats().
+         */
+        [[nodiscard]] const Stats &stats() const noexcept;
+
+        /**
+         * @brief Resets the receive counters.
+         */
+        void resetStats() noexcept;
+
+        static constexpr std::size_t DEFAULT_SLOTS = 256;
+        static constexpr std::size_t DEFAULT_SLOT_SIZE = 2048;
+        static constexpr std::size_t BATCH_SIZE = 64;
+        static constexpr std::size_t GRO_SLOTS = 64;
+        static constexpr std::size_t GRO_SLOT_SIZE = 65536;
+        static constexpr std::size_t GRO_MAX_SEGMENTS = 64;///< UDP_MAX_SEGMENTS in the kernel
+
+    private:
+        void _allocate(std::size_t nslots, std::size_t slotSize);
+        void _push(std::size_t slot, std::size_t len, const network::Endpoint &endpoint, std::size_t segment,
+            std::chrono::steady_clock::time_point received);
+
+        std::size_t _slot_size = 0;
+        std::size_t _used = 0;
+        std::vector<uint8_t> _storage;
+        std::vector<View> _views;
+        Stats _stats{};
+#if defined(__linux__)
+        /**
+         * @brief Room for the UDP_GRO segment size, SO_TIMESTAMPNS and SO_RXQ_OVFL control messages.
+         */
+        union RecvControl {
+                cmsghdr align;
+                char buf[CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t))];
+        };
+
+        bool _gro = false;
+        bool _stamps = false;
+        bool _drop_counter = false;
+        uint32_t _kernel_drops = 0;///< Last SO_RXQ_OVFL value, the socket's cumulative drop count
+        std::vector<mmsghdr> _msgs;
+        std::vector<iovec> _iovs;
+        std::vector<sockaddr_storage> _addrs;
+        std::vector<RecvControl> _ctrl;
+#endif
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
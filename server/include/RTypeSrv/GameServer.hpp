@@ -9,12 +9,34 @@
 #include <R-Engine/Application.hpp>
 #include <RTypeNet/Interfaces.hpp>
 #include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/CommandTable.hpp>
+#include <RTypeSrv/Congestion.hpp>
+#include <RTypeSrv/DatagramQueue.hpp>
+#include <RTypeSrv/DatagramRing.hpp>
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/GspHeaderView.hpp>
+#include <RTypeSrv/Interest.hpp>
+#include <RTypeSrv/IoUringEngine.hpp>
+#include <RTypeSrv/Outbox.hpp>
+#include <RTypeSrv/PacketCipher.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/PathMtu.hpp>
+#include <RTypeSrv/PayloadCompressor.hpp>
+#include <RTypeSrv/Priority.hpp>
+#include <RTypeSrv/Reactor.hpp>
+#include <RTypeSrv/ReliableChannel.hpp>
+#include <RTypeSrv/Snapshot.hpp>
+#include <RTypeSrv/SocketBuffers.hpp>
 #include <RTypeSrv/Utils/NonCopyable.hpp>
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -27,15 +49,55 @@ namespace rtype::srv {
 class RTYPE_SRV_API GameServer : public utils::NonCopyable
 {
     public:
+        /**
+         * @brief The worker's slot in a SO_REUSEPORT group sharing one UDP port (see ReusePortGroup).
+         */
+        struct Shard {
+                std::size_t index{0};    ///< Index of the worker's socket in the group.
+                std::size_t count{1};    ///< Number of workers in the group.
+                network::Socket socket{};///< Already bound; closed by the worker on shutdown.
+        };
+
+        /**
+         * @brief The data path used for the UDP socket.
+         */
+        enum class IoEngine : uint8_t {
+            POLL,    ///< recvmmsg/sendmmsg driven by socket readiness (DatagramRing, DatagramQueue).
+            IO_URING,///< Multishot receive and linked sends on an io_uring (IoUringEngine); falls back to POLL if unavailable.
+        };
+
+        /**
+         * @brief Tuning of the UDP data path.
+         */
+        struct UdpOptions {
+                IoEngine engine{IoEngine::POLL};
+                bool gso{false};        ///< UDP_SEGMENT on send and UDP_GRO on receive (poll engine, Linux); ignored if unsupported.
+                SocketBuffers buffers{};///< SO_RCVBUF / SO_SNDBUF of the UDP socket; 0 keeps the kernel default.
+
+                uint16_t mtu{GameServerUDPPacketParser::MAX_PACKET_SIZE};    ///< Datagram size for clients of unknown path MTU.
+                uint16_t max_mtu{GameServerUDPPacketParser::MAX_PROBED_SIZE};///< Largest size probed by path MTU discovery, off if <= mtu.
+                std::size_t max_rate{256 * 1024};                            ///< Highest send rate of a client in B/s, 0 for no limit.
+
+                SnapshotPrecision snapshot_precision{};///< Field precision of the snapshots sent to quantizing clients.
+                bool compression{false};               ///< Compress keyframes with zstd (PayloadCompressor); ignored if unsupported.
+                std::size_t compression_min_saving{16};///< Bytes a keyframe must shrink by to be sent compressed.
+
+                InterestOptions interest{};     ///< Area of interest of each client in the snapshots it gets.
+                std::size_t snapshot_budget{0};///< Payload bytes of a client's snapshot per tick; 0 fills a datagram, the most.
+        };
+
         /**
          * @brief Constructs a new GameServer object.
          * @param baseEndpoint The base endpoint for the server.
          * @param ncores The number of cores to use.
          * @param tcpEndpoint The TCP endpoint for the server.
          * @param quitServer A reference to an atomic boolean that will be set to true when the server should quit.
+         * @param shard The reuseport slot of this worker, or std::nullopt to listen on `baseEndpoint` alone.
+         * @param udp The UDP data path options.
          */
         GameServer(const network::Endpoint &baseEndpoint, std::size_t ncores, const network::Endpoint &tcpEndpoint,
-            const network::Endpoint &externalUdpEndpoint, std::atomic<bool> &quitServer);
+            const network::Endpoint &externalUdpEndpoint, std::atomic<bool> &quitServer, std::optional<Shard> shard,
+            UdpOptions udp);
         ~GameServer() noexcept = default;
 
         /**
@@ -49,6 +111,12 @@ class RTYPE_SRV_API GameServer : public utils::NonCopyable
         static constexpr size_t MAX_BUFFER_SIZE = 64 * 1024;
         static constexpr auto AUTH_TIMEOUT = std::chrono::seconds(5);
         static constexpr auto FRAGMENT_TIMEOUT = std::chrono::seconds(1);
+        static constexpr auto CLIENT_TIMEOUT = std::chrono::seconds(10);///< Silence after which a client is forgotten (PINGed every second)
+        static constexpr std::size_t MAX_FRAGMENTED_MESSAGES = 4;   ///< Messages being reassembled per client
+        static constexpr std::size_t MAX_FRAGMENTS = 64;            ///< Fragments per message
+        static constexpr std::size_t MAX_FRAGMENT_BYTES = 1024 * 1024;///< Reassembly memory of all clients
+        static constexpr auto STATS_INTERVAL = std::chrono::seconds(10);
+        static constexpr auto TICK_RATE = std::chrono::milliseconds(16);// ~60 ticks per seconds
 
         enum class AuthState { NONE, CHALLENGED, AUTHENTICATED };
 
@@ -76,26 +144,91 @@ class RTYPE_SRV_API GameServer : public utils::NonCopyable
                 std::chrono::microseconds min_rtt{(std::chrono::microseconds::max) ()};
                 std::chrono::microseconds max_rtt{(std::chrono::microseconds::min) ()};
                 std::chrono::microseconds avg_rtt{0};
+                std::chrono::microseconds srtt{0};///< Smoothed as TCP's SRTT (1/8 per sample), for congestion control
                 uint32_t samples{0};
                 std::chrono::steady_clock::time_point last_ping;
+                std::chrono::steady_clock::time_point ping_sent;///< Kernel transmit time of the last PING, or when it was flushed
+        };
+
+        /**
+         * @brief Count, mean and maximum of a delay over one stats interval.
+         */
+        struct DelayStats {
+                uint64_t samples{0};
+                std::chrono::nanoseconds total{0};
+                std::chrono::nanoseconds max{0};
+
+                void add(const std::chrono::nanoseconds delay) noexcept
+                {
+                    const auto d = (std::max) (delay, std::chrono::nanoseconds{0});
+                    ++samples;
+                    total += d;
+                    max = (std::max) (max, d);
+                }
         };
 
+        /**
+         * @brief Snapshots sent over one stats interval, by encoding.
+         */
+        struct SnapshotStats {
+                uint64_t keyframes{0};
+                uint64_t keyframe_bytes{0};
+                uint64_t deltas{0};
+                uint64_t delta_bytes{0};
+                uint64_t quantized{0};///< Keyframes and deltas sent bit-packed
+                uint64_t entities{0}; ///< Entities in the keyframes and deltas, changed or not
+                uint64_t fragmented{0};///< Keyframes larger than the client's MTU, sent as fragments
+                uint64_t considered{0};///< Entities in the games' snapshots, once per client
+                uint64_t entered{0};   ///< Entities that entered a client's area of interest
+                uint64_t deferred{0};  ///< Changes left out of a snapshot by its budget, once per tick until sent
+                uint64_t throttled{0}; ///< Snapshots skipped for a client whose datagrams still wait for its rate
+        };
+
+        /**
+         * @brief The key and replay window of a client that encrypts; the server seals what it sends it.
+         */
+        struct SealedSession {
+                PacketCipher::Key key;
+                ReplayWindow replay;
+        };
+
+        /**
+         * @brief Encrypted packets dropped over one stats interval, besides PacketCipher::Stats::rejected.
+         */
+        struct EncryptionStats {
+                uint64_t replayed{0};  ///< F_ENCRYPTED packets whose SEQ was opened already or left the ReplayWindow
+                uint64_t downgraded{0};///< Plaintext packets, other than CMD_JOIN, from a client that encrypts
+                uint64_t keyless{0};   ///< F_ENCRYPTED packets from a client without a session key
+        };
+
+        /**
+         * @brief What a client sees of its game: its area of interest, and the snapshots of it sent, the baselines of its deltas.
+         */
+        struct ClientView {
+                InterestSet interest;
+                PriorityAccumulator priority;
+                SnapshotHistory history;
+        };
+
+        /**
+         * @brief A fragmented message from a client, being reassembled.
+         */
         struct FragmentBuffer {
-                std::vector<std::vector<uint8_t>> fragments;
+                std::vector<uint8_t> message;                          ///< TOTAL_SIZE bytes, filled as fragments arrive
+                std::vector<std::pair<uint32_t, uint32_t>> fragments{};///< [offset, end) of every fragment stored
+                std::size_t received{0};                               ///< Bytes stored so far
                 std::chrono::steady_clock::time_point first_fragment;
-                size_t total_size{0};
-                uint32_t base_seq{0};
         };
 
-        struct PairKeyHash {
-                std::size_t operator()(const std::pair<network::Handle, uint32_t> &p) const noexcept
-                {
-                    uint64_t key = (static_cast<uint64_t>(static_cast<uint64_t>(p.first)) << 32) ^ p.second;
-                    return std::hash<uint64_t>{}(key);
-                }
+        /**
+         * @brief Fragmented messages from clients over one stats interval.
+         */
+        struct FragmentStats {
+                uint64_t reassembled{0};
+                uint64_t expired{0}; ///< Still incomplete after FRAGMENT_TIMEOUT
+                uint64_t rejected{0};///< Malformed, overlapping, or over a memory cap
         };
 
-        using FdsType = std::vector<network::PollFD>;
         using IP = std::pair<std::array<uint8_t, 16>, uint16_t>;
         struct IPHash {
                 std::size_t operator()(const IP &p) const noexcept
@@ -108,8 +241,13 @@ class RTYPE_SRV_API GameServer : public utils::NonCopyable
                     return h1 ^ (h2 << 1);
                 }
         };
-        using SeqMapType = std::unordered_map<network::Handle, uint32_t>;
-        using SackBitsType = std::unordered_map<network::Handle, uint8_t>;
+        using FragmentKey = std::pair<IP, uint32_t>;///< Client endpoint, BASE_SEQ
+        struct FragmentKeyHash {
+                std::size_t operator()(const FragmentKey &k) const noexcept
+                {
+                    return IPHash{}(k.first) ^ (std::hash<uint32_t>{}(k.second) << 1);
+                }
+        };
         using PlayerStatesType = std::unordered_map<uint32_t, PlayerState>;
         using ClientIDsType = std::unordered_map<uint32_t, network::Handle>;
         using ParseErrorsType = std::unordered_map<network::Handle, uint8_t>;
@@ -119,98 +257,191 @@ class RTYPE_SRV_API GameServer : public utils::NonCopyable
         using ClientStatesType = std::unordered_map<network::Handle, ClientState>;
         using EndpointToHandleType = std::unordered_map<IP, network::Handle, IPHash>;
         using RecvSpanType = std::unordered_map<network::Handle, std::vector<uint8_t>>;
-        using LatencyMetricsType = std::unordered_map<network::Handle, LatencyMetrics>;
+        using LatencyMetricsType = std::unordered_map<IP, LatencyMetrics, IPHash>;
         using ClientEndpointsType = std::unordered_map<network::Handle, network::Endpoint>;
-        using SendSpanType = std::unordered_map<IP, std::vector<std::vector<uint8_t>>, IPHash>;
-        using RecvPacketsType = std::unordered_map<IP, std::vector<std::vector<uint8_t>>, IPHash>;
-        using TcpSendSpanType = std::unordered_map<network::Handle, std::vector<std::vector<uint8_t>>>;
-        using FragBufType = std::unordered_map<std::pair<network::Handle, uint32_t>, FragmentBuffer, PairKeyHash>;
+        using SendSpanType = std::unordered_map<IP, std::vector<PacketBuffer>, IPHash>;
+        using StampedSpanType = std::unordered_map<IP, std::size_t, IPHash>;
+        using TcpSendSpanType = std::unordered_map<network::Handle, std::vector<PacketBuffer>>;
+        using FragBufType = std::unordered_map<FragmentKey, FragmentBuffer, FragmentKeyHash>;
 
         void _initServer();
         void _serverLoop();
         void _cleanupServer();
-        void _parsePackets();
+        void _reportStats();
+        void _reportIo();
+        void _reportLatency();
+        void _reportCommands();
+        void _reportSnapshots();
+        void _reportFragments();
+        void _reportReliability();
+        void _reportCongestion();
+        void _reportPathMtu();
+        void _reportEncryption();
+        void _reportOutbox();
+        void _reportLoop();
+        void _parsePackets(std::span<const DatagramRing::View> datagrams);
         void _recvTcpPackets();
         void _sendTcpPackets();
         void _parseTcpPackets();
         void _sendGSRegistration();
         void _acceptClients() noexcept;
-        void _recvPackets(network::NFDS i);
-        void _sendPackets(network::NFDS i);
-        void _handleLoop(network::NFDS &i);
+        void _recvPackets(network::Handle handle);
+        void _sendPackets(network::Handle handle);
+        bool _flushDatagrams();
+        void _reapSendStamps();
+        void _applySendStamps();
+        void _onTick();
+        void _handleEvent(const Reactor::Event &event);
         void _cleanupExpiredAuthChallenges() noexcept;
-        void _handleClients(network::NFDS &i) noexcept;
+        void _cleanupExpiredFragments() noexcept;
+        void _cleanupIdleClients() noexcept;
+        void _serviceChannels();
+        void _flushOutbox(const IP &endpoint, Outbox &outbox, ReliableChannel &channel, std::chrono::steady_clock::time_point now);
+        void _sendProbe(const IP &endpoint, ReliableChannel &channel, PathMtu &path, uint16_t size,
+            std::chrono::steady_clock::time_point now);
+        [[nodiscard]] std::chrono::microseconds _pingRtt(const IP &endpoint) const noexcept;
+        void _handleClients(network::Handle handle) noexcept;
         void sendErrorResponse(network::Handle handle);
-        void _handleClientsSend(network::NFDS &i) noexcept;
+        void _handleClientsSend(network::Handle handle) noexcept;
         void setPolloutForHandle(network::Handle h) noexcept;
         void _recordAuthAttempt(const network::Handle &handle) noexcept;
         void _disconnectByHandle(const network::Handle &handle) noexcept;
+        void _forgetEndpoint(const IP &endpoint) noexcept;
         network::Endpoint GetEndpointFromHandle(const network::Handle &handle);
         std::vector<uint8_t> buildJoinMsgForClient(const uint8_t *data, std::size_t offset);
-        void _handleOccupancyRequest(const uint8_t *data, std::size_t &offset, std::size_t bufsize);
+        void _handleOccupancyRequest(network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize);
         void handleOKKO(network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize);
         void handleCreate(network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize);
         void handleOccupancy(network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize);
-        static void _handleGatewayOKKO(const uint8_t cmd, const uint8_t *data, std::size_t &offset, std::size_t bufsize);
-        // UDP handlers now operate with endpoint (IP + port) as identifier for incoming packets.
-        void handleUDPJoin(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId);
-        void handleUDPPing(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId);
-        void handleUDPPong(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId);
-        void handleUDPInput(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId);
-        void handleUDPResync(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId);
-        void handleUDPAuthResponse(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId);
+        void _handleGatewayOKKO(network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize);
+        // UDP handlers operate with endpoint (IP + port) as identifier, the validated header and the datagram receive time.
+        void handleUDPJoin(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPPing(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPPong(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPInput(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPResync(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPAuthResponse(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPFragment(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPAck(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void handleUDPBatch(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void _deliverUDP(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        void _releaseHeld(const IP &endpoint, std::chrono::steady_clock::time_point now);
+        void _dispatchUDP(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received);
+        [[nodiscard]] bool _isAuthenticated(const IP &endpoint) const noexcept;
+        [[nodiscard]] uint16_t _clientMtu(const IP &endpoint) const noexcept;
+        [[nodiscard]] std::size_t _clientPacketSize(const IP &endpoint) const noexcept;
+        [[nodiscard]] const PacketCipher::Key *_sessionKey(const IP &endpoint) const noexcept;
+        [[nodiscard]] std::optional<std::span<const uint8_t>> _openDatagram(const IP &endpoint, const GspHeaderView &header,
+            std::span<const uint8_t> datagram);
+
+        using UdpHandler = void (GameServer::*)(const IP &, const GspHeaderView &, std::chrono::steady_clock::time_point);
+        using TcpHandler = void (GameServer::*)(network::Handle, const uint8_t *, std::size_t &, std::size_t);
+        using UdpCommandTable = CommandTable<GSPcol::CMD, UdpHandler>;
+        using TcpCommandTable = CommandTable<GWPcol::CMD, TcpHandler>;
+
+        static const UdpCommandTable UDP_COMMANDS;///< Client commands, see ParsePackets.cpp
+        static const TcpCommandTable TCP_COMMANDS;///< Gateway commands, see TcpGateway.cpp
         uint32_t generate_unique_game_id();
         void _game_loop_tick();
         void _send_game_snapshots();
+        [[nodiscard]] const SnapshotHistory &_clientView(const IP &endpoint, uint32_t clientId, const GameStateSnapshot &state,
+            const SnapshotHistory &game, const InterestGrid &grid);
+        void _queueClientSnapshot(const IP &endpoint, uint32_t gameId, const SnapshotHistory &history);
         std::vector<uint32_t> get_clients_in_game(uint32_t game_id);
 
-        FdsType _fds{};
-        network::NFDS _nfds = 1;
+        PacketPool _packet_pool;///< Declared first so it outlives every queue holding its buffers.
+        Reactor _reactor;
+        bool _udp_flush_pending = false;
         SocketsMapType _sockets;
         network::Socket _sock{};
         std::size_t _ncores = 4;
         SendSpanType _send_spans;
+        StampedSpanType _stamped_spans;///< Index in `_send_spans` of the datagram carrying a PING, sent stamped
+        DatagramQueue _send_queue;
         std::size_t _next_id = 0;
         bool _is_running = false;
-        SackBitsType _sack_bits{};
         ClientIDsType _client_ids{};
         network::Socket _tcp_sock{};
         ParseErrorsType parseErrors;
         RecvSpanType _tcp_recv_spans;
         TcpSendSpanType _tcp_send_spans;
+        std::size_t _tcp_send_offset = 0;///< Bytes of the first queued TCP packet already sent.
         network::Handle _tcp_handle{};
-        RecvPacketsType _recv_packets;
+        StreamSendStats _tcp_stats{};
+        DatagramRing _recv_ring;
+        UdpOptions _udp{};
+        std::unique_ptr<IoUringEngine> _uring;
         EndpointToHandleType _endpoint_to_handle;
         EndpointToClientType _endpoint_to_client;
         AuthStatesType _auth_states{};
         network::Socket _server_sock{};
-        SeqMapType _last_received_seq{};
         FragBufType _fragment_buffers{};
+        std::size_t _fragment_bytes = 0;///< Sum of the TOTAL_SIZE of _fragment_buffers
+        FragmentStats _fragment_stats{};
         network::Endpoint _tcp_endpoint{};
         PlayerStatesType _player_states{};
         ClientStatesType _client_states{};
-        SeqMapType _client_sequence_nums{};
         network::Endpoint _base_endpoint{};
         network::Endpoint _my_tcp_endpoint{};
-        LatencyMetricsType _latency_metrics{};
+        LatencyMetricsType _latency_metrics{};///< PING / PONG RTT of each authenticated client
+        DelayStats _server_delay{};///< Kernel receive to handler, every datagram
+        DelayStats _input_age{};   ///< Kernel receive to the simulation tick consuming the input
+        CommandCounters _udp_commands{};
+        CommandCounters _tcp_commands{};
+        std::vector<std::chrono::steady_clock::time_point> _pending_inputs;
         ClientEndpointsType _client_endpoints;
         network::Endpoint _external_endpoint{};
+        std::chrono::steady_clock::time_point _last_stats{};
         std::atomic<bool> *_quit_server = nullptr;
         std::unordered_map<uint32_t, uint32_t> _client_to_game;
         u_int32_t _next_game_id = 1;
+        u_int32_t _game_id_stride = 1;
+        std::optional<Shard> _shard;
         std::unordered_map<uint32_t, std::unique_ptr<r::Application>> _game_instances;
         // Per-endpoint state for UDP clients that are not yet associated with a handle
-        using EndpointSeqType = std::unordered_map<IP, uint32_t, IPHash>;
-        using EndpointLastRecvType = std::unordered_map<IP, uint32_t, IPHash>;
-        using EndpointSackType = std::unordered_map<IP, uint8_t, IPHash>;
+        using EndpointChannelType = std::unordered_map<IP, ReliableChannel, IPHash>;
+        using EndpointOutboxType = std::unordered_map<IP, Outbox, IPHash>;
+        using EndpointCongestionType = std::unordered_map<IP, CongestionController, IPHash>;
         using EndpointClientStatesType = std::unordered_map<IP, ClientState, IPHash>;
         using EndpointAuthStatesType = std::unordered_map<IP, AuthChallenge, IPHash>;
+        using EndpointSnapshotAcksType = std::unordered_map<IP, SnapshotAcks, IPHash>;
+        using EndpointSnapshotEncodingType = std::unordered_map<IP, snapshot::Encoding, IPHash>;
+        using EndpointMtuType = std::unordered_map<IP, PathMtu, IPHash>;
+        using EndpointViewType = std::unordered_map<IP, ClientView, IPHash>;
+        using EndpointSessionType = std::unordered_map<IP, SealedSession, IPHash>;
+        using SnapshotHistoryType = std::unordered_map<uint32_t, SnapshotHistory>;///< Game ID -> recent snapshots
+        using CompressionStatsType = std::unordered_map<uint32_t, PayloadCompressor::Stats>;///< Game ID -> compression counters
 
-        EndpointSeqType _ep_sequence_nums;
-        EndpointLastRecvType _ep_last_received_seq;
-        EndpointSackType _ep_sack_bits;
+        EndpointChannelType _ep_channels;///< Sequence numbers, acknowledgements and retransmissions of each client
+        ReliableChannel::Stats _reliable_stats{};
+        std::vector<uint32_t> _ack_scratch;
+        std::vector<IP> _held_scratch;
+        EndpointOutboxType _ep_outboxes;///< Messages of the current tick, sent by _serviceChannels()
+        Outbox::Stats _outbox_stats{};
+        std::vector<uint8_t> _batch_scratch;///< One message of a CMD_BATCH from a client, rebuilt as a packet
+        EndpointCongestionType _ep_congestion;///< Send rate of each client, with UdpOptions::max_rate set
+        CongestionController::Stats _congestion_stats{};
+        EndpointSessionType _ep_sessions;///< Clients that sent an F_ENCRYPTED packet, reset by CMD_JOIN
+        PacketCipher _cipher;            ///< Of this worker thread, for every client
+        EncryptionStats _encryption_stats{};
+        std::vector<uint8_t> _open_scratch;///< The datagram being handled, opened
         EndpointClientStatesType _ep_client_states;
         EndpointAuthStatesType _ep_auth_states;
+        EndpointSnapshotAcksType _ep_snapshot_acks;
+        EndpointSnapshotEncodingType _ep_snapshot_encoding;///< Clients absent use snapshot::Encoding::FLOAT
+        EndpointMtuType _ep_mtu;                           ///< Path MTU of each authenticated client; others use UdpOptions::mtu
+        PathMtu::Stats _mtu_stats{};
+        SnapshotHistoryType _snapshot_history;
+        EndpointViewType _ep_views;
+        InterestGrid _interest_grid;///< Of the game whose snapshots are being sent, rebuilt for each
+        std::vector<SnapshotEntity> _view_scratch;    ///< Area of interest of the client being sent a snapshot
+        std::vector<SnapshotEntity> _schedule_scratch;///< Its state within the budget
+        std::vector<uint8_t> _keyframe_scratch;  ///< Encoded state of the keyframe being queued
+        std::vector<uint8_t> _compressed_scratch;///< [SEQ:4][state] as one zstd frame; empty if not worth it
+        std::unique_ptr<PayloadCompressor> _compressor;///< Null when compression is off or unsupported
+        std::vector<uint8_t> _compress_scratch;
+        CompressionStatsType _compression_stats;
+        SnapshotStats _snapshot_stats{};
 };
 
 }// namespace rtype::srv
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/PacketWriter.hpp>
+#include <RTypeSrv/ProtocolSchema.hpp>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -16,7 +20,7 @@ namespace rtype::srv {
  * This class provides static methods to build and parse packets according to the
  * R-Type Gateway Protocol specification.
  */
-class GameServerPacketParser final
+class RTYPE_SRV_API GameServerPacketParser final
 {
     public:
         /**
@@ -78,17 +82,28 @@ class GameServerPacketParser final
          */
         static std::uint8_t parseHeader(const uint8_t *data, std::size_t &offset, std::size_t bufsize);
 
+        /**
+         * @brief Serializes a gateway protocol packet header into a writer.
+         *
+         * @param out The destination, advanced by 5 bytes.
+         * @param cmd The command identifier.
+         * @param flags Optional flags byte (default: 0).
+         * @throws std::length_error If fewer than 5 bytes remain.
+         */
+        static void writeHeader(PacketWriter &out, uint8_t cmd, uint8_t flags = 0);
+
         /**
          * @brief Builds a complete gateway protocol packet header.
          *
          * Creates the standard header: [MAGIC:2][VERSION:1][FLAGS:1][CMD:1]
          * Total size: 5 bytes
          *
+         * @param pool The worker pool the packet is taken from.
          * @param cmd The command identifier.
          * @param flags Optional flags byte (default: 0).
-         * @return Vector containing the 5-byte header.
+         * @return Pooled buffer containing the 5-byte header.
          */
-        static std::vector<uint8_t> buildHeader(uint8_t cmd, uint8_t flags = 0);
+        static PacketBuffer buildHeader(PacketPool &pool, uint8_t cmd, uint8_t flags = 0);
 
         /**
          * @brief Builds a GS registration packet.
@@ -96,11 +111,12 @@ class GameServerPacketParser final
          * Format: [HEADER:5][CMD:20][IP:16][PORT:2]
          * Total size: 23 bytes
          *
+         * @param pool The worker pool the packet is taken from.
          * @param ip Server's IPv6 address (or IPv4-mapped IPv6).
          * @param port Server's UDP port (host byte order, will be converted to big-endian).
-         * @return Vector containing the complete registration packet.
+         * @return Pooled buffer containing the complete registration packet.
          */
-        static std::vector<uint8_t> buildGSRegistration(const std::array<uint8_t, 16> &ip, uint16_t port);
+        static PacketBuffer buildGSRegistration(PacketPool &pool, const std::array<uint8_t, 16> &ip, uint16_t port);
 
         /**
          * @brief Builds an OCCUPANCY packet.
@@ -108,10 +124,11 @@ class GameServerPacketParser final
          * Format: [HEADER:5][CMD:23][OCCUPANCY:1]
          * Total size: 6 bytes
          *
+         * @param pool The worker pool the packet is taken from.
          * @param occupancy Number of active games on this server.
-         * @return Vector containing the complete OCCUPANCY packet.
+         * @return Pooled buffer containing the complete OCCUPANCY packet.
          */
-        static std::vector<uint8_t> buildOccupancy(uint8_t occupancy);
+        static PacketBuffer buildOccupancy(PacketPool &pool, uint8_t occupancy);
 
         /**
          * @brief Builds a JOIN response packet for gateway.
@@ -119,12 +136,13 @@ class GameServerPacketParser final
          * Format: [HEADER:5][CMD:1][GAME_ID:4][IP:16][PORT:2]
          * Total size: 27 bytes
          *
+         * @param pool The worker pool the packet is taken from.
          * @param game_id The ID of the created game.
          * @param ip Server's IPv6 address for clients to connect to.
          * @param port Server's UDP port for clients to connect to.
-         * @return Vector containing the complete JOIN packet.
+         * @return Pooled buffer containing the complete JOIN packet.
          */
-        static std::vector<uint8_t> buildJoinResponse(uint32_t game_id, const std::array<uint8_t, 16> &ip, uint16_t port);
+        static PacketBuffer buildJoinResponse(PacketPool &pool, uint32_t game_id, const std::array<uint8_t, 16> &ip, uint16_t port);
 
         /**
          * @brief Builds a CREATE_KO error response.
@@ -132,9 +150,10 @@ class GameServerPacketParser final
          * Format: [HEADER:5][CMD:4]
          * Total size: 5 bytes
          *
-         * @return Vector containing the CREATE_KO packet.
+         * @param pool The worker pool the packet is taken from.
+         * @return Pooled buffer containing the CREATE_KO packet.
          */
-        static std::vector<uint8_t> buildCreateKO();
+        static PacketBuffer buildCreateKO(PacketPool &pool);
 
         /**
          * @brief Builds a GAME_END notification packet.
@@ -142,10 +161,11 @@ class GameServerPacketParser final
          * Format: [HEADER:5][CMD:5][GAME_ID:4]
          * Total size: 9 bytes
          *
+         * @param pool The worker pool the packet is taken from.
          * @param game_id The ID of the game that ended.
-         * @return Vector containing the complete GAME_END packet.
+         * @return Pooled buffer containing the complete GAME_END packet.
          */
-        static std::vector<uint8_t> buildGameEnd(uint32_t game_id);
+        static PacketBuffer buildGameEnd(PacketPool &pool, uint32_t game_id);
 
         /**
          * @brief Builds a GID registration packet.
@@ -153,10 +173,11 @@ class GameServerPacketParser final
          * Format: [HEADER:5][CMD:24][LEN:1][GAME_ID:4]...
          * Total size: 6 + (LEN * 4) bytes
          *
+         * @param pool The worker pool the packet is taken from.
          * @param game_ids Vector of game IDs this server is hosting.
-         * @return Vector containing the complete GID packet.
+         * @return Pooled buffer containing the complete GID packet.
          */
-        static std::vector<uint8_t> buildGIDRegistration(const std::vector<uint32_t> &game_ids);
+        static PacketBuffer buildGIDRegistration(PacketPool &pool, const std::vector<uint32_t> &game_ids);
 
         // Constants
         static constexpr uint16_t HEADER_MAGIC = 0x4257;///< Gateway protocol magic number
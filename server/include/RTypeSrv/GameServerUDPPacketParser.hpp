@@ -1,150 +1,116 @@
 #pragma once
 
-#include <RTypeSrv/Protocol.hpp>
-#include <array>
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/PacketWriter.hpp>
+#include <RTypeSrv/ProtocolSchema.hpp>
 #include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <span>
 #include <vector>
 
 namespace rtype::srv {
 
 /**
- * @brief Helper class for building and parsing Game Server Protocol (UDP) packets.
+ * @brief Helper class for building Game Server Protocol (UDP) packets.
  *
- * This class provides static methods to build and parse UDP packets according to
- * the Game Server Protocol specification (GSPcol).
+ * This class provides static methods to build UDP packets according to the Game
+ * Server Protocol specification (GSPcol); received packets are read through GspHeaderView.
  *
  * @note All multi-byte values are transmitted in big-endian (network) byte order
  */
-class GameServerUDPPacketParser final
+class RTYPE_SRV_API GameServerUDPPacketParser final
 {
     public:
         /**
-         * @brief Validates and parses a UDP packet header.
-         *
-         * Header format (21 bytes total):
-         * [MAGIC:2][VERSION:1][FLAGS:1][SEQ:4][ACKBASE:4][ACKBITS:1][CHANNEL:1][SIZE:2][ID:4][CMD:1]
-         *
-         * @param data Pointer to packet data
-         * @param offset Current position in buffer (will be advanced past header)
-         * @param bufsize Total size of buffer
-         * @return Command byte from header
-         * @throws std::runtime_error If header is invalid or incomplete
+         * @brief The per-peer fields of an outgoing header, see ReliableChannel::header().
          */
-        static std::uint8_t parseHeader(const uint8_t *data, std::size_t &offset, std::size_t bufsize);
+        struct HeaderFields {
+                uint32_t seq{0};
+                uint32_t ack_base{0};
+                uint32_t ack_bits{0};    ///< Bit i set if packet ack_base - 1 - i was received; VERSION 1 sends the low 8 bits
+                uint16_t order{0};       ///< Position among the sender's RO messages, sent from VERSION 2
+                uint8_t version{VERSION};///< The header VERSION the peer speaks
+        };
 
         /**
-         * @brief Creates a complete UDP packet header.
+         * @brief Serializes a UDP packet header into a writer.
          *
-         * @param cmd Command identifier
-         * @param flags Control flags
-         * @param seq Sequence number
-         * @param ackBase Base sequence for selective ACK
-         * @param ackBits SACK bits for previous 8 packets
-         * @param channel Delivery channel
-         * @param size Total packet size including header
-         * @param clientId Client/Player ID
-         * @return Vector containing the 21-byte header
-         */
-        static std::vector<uint8_t> buildHeader(GSPcol::CMD cmd, GSPcol::FLAGS flags, uint32_t seq, uint32_t ackBase, uint8_t ackBits,
-            GSPcol::CHANNEL channel, uint16_t size, uint32_t clientId);
-
-        /**
-         * @brief Builds a PONG response packet.
+         * The building block of every build* method; callers that own their memory
+         * (a stack buffer, a batch slot) can use it directly.
          *
-         * Format: [HEADER:21]
-         * Total size: 21 bytes
-         * Used to respond to PING requests for latency measurement.
-         *
-         * @param seq Current sequence number
-         * @param ackBase Last received sequence from peer
-         * @param ackBits SACK bitfield
-         * @param clientId Client ID to respond to
-         * @return Vector containing complete PONG packet
+         * @param out The destination, advanced by headerSize(header.version) bytes
+         * @param header Sequence, acknowledgements, order and version
+         * @throws std::length_error If fewer than headerSize(header.version) bytes remain
          */
-        static std::vector<uint8_t> buildPongResponse(uint32_t seq, uint32_t ackBase, uint8_t ackBits, uint32_t clientId);
-
-        /**
-         * @brief Builds a SNAPSHOT packet containing game state.
-         *
-         * Format: [HEADER:21][SNAPSHOT_SEQ:4][STATE_DATA:N]
-         * Uses reliable ordered delivery channel.
-         *
-         * @param seq Packet sequence number
-         * @param ackBase Last received sequence
-         * @param ackBits SACK bitfield
-         * @param clientId Target client
-         * @param snapshotSeq Game state sequence number
-         * @param stateData Serialized game state
-         * @return Vector containing complete snapshot packet
-         */
-        static std::vector<uint8_t> buildSnapshot(uint32_t seq, uint32_t ackBase, uint8_t ackBits, uint32_t clientId, uint32_t snapshotSeq,
-            const std::vector<uint8_t> &stateData);
+        static void writeHeader(PacketWriter &out, GSPcol::CMD cmd, GSPcol::FLAGS flags, const HeaderFields &header,
+            GSPcol::CHANNEL channel, uint16_t size, uint32_t clientId);
 
         /**
-         * @brief Build an authentication challenge packet.
-         *
-         * Format: [HEADER:21][CHALLENGE:32]
-         * Uses reliable ordered delivery with encryption flag.
+         * @brief Appends a message to a send queue, as one packet or, if it exceeds the MTU, as a train of fragments.
          *
-         * @param seq Current sequence number
-         * @param ackBase Last received sequence
-         * @param ackBits SACK bitfield
-         * @param clientId Target client ID
-         * @param challenge 32-byte random challenge data
-         * @return Vector containing complete challenge packet
-         */
-        static std::vector<uint8_t> buildChallenge(uint32_t seq, uint32_t ackBase, uint8_t ackBits, uint32_t clientId,
-            const std::array<uint8_t, 32> &challenge);
-
-        /**
-         * @brief Build an authentication challenge containing a timestamp and server-generated cookie.
+         * A fragmented message is the packet it would have been, header included, cut into
+         * CMD_FRAGMENT packets of at most mtu bytes (see buildFragment()). BASE_SEQ is the
+         * sequence number of the first fragment, which the inner header carries too; the
+         * fragments take consecutive sequence numbers and the flags, channel and order of
+         * the message.
          *
-         * Format: [HEADER:21][TIMESTAMP:8][COOKIE:32]
-         * Total payload size: 40 bytes
+         * @param out The queue the packets are appended to
+         * @param header The header of the message; its seq goes to the first packet
+         * @param payload The message payload, as consecutive pieces
+         * @param mtu The largest datagram the client accepts, clamped to [MIN_PACKET_SIZE, MAX_PROBED_SIZE]
+         * @param overhead Bytes each packet gains once built (a cipher tag), taken from the clamped mtu
+         * @return The number of packets appended, which use the sequence numbers header.seq to header.seq + n - 1
+         * @throws std::length_error If the message, header included, exceeds MAX_MESSAGE_SIZE
          */
-        static std::vector<uint8_t> buildChallengeWithCookie(uint32_t seq, uint32_t ackBase, uint8_t ackBits, uint32_t clientId,
-            uint64_t timestamp, const std::array<uint8_t, 32> &cookie);
+        static std::size_t appendMessage(PacketPool &pool, std::vector<PacketBuffer> &out, GSPcol::CMD cmd, GSPcol::FLAGS flags,
+            GSPcol::CHANNEL channel, const HeaderFields &header, uint32_t clientId,
+            std::initializer_list<std::span<const uint8_t>> payload, uint16_t mtu = MAX_PACKET_SIZE, std::size_t overhead = 0);
 
         /**
          * @brief Build a fragment of a larger message.
          *
          * Format: [HEADER:21][BASE_SEQ:4][TOTAL_SIZE:4][FRAGMENT_OFFSET:4][FRAGMENT_DATA:N]
+         * TOTAL_SIZE and FRAGMENT_OFFSET count in the message, which is a whole packet,
+         * header included (see appendMessage()).
          *
-         * @param seq Current sequence number
-         * @param ackBase Last received sequence
-         * @param ackBits SACK bitfield
+         * @param pool The worker pool the packet is taken from
+         * @param header Sequence, acknowledgements, order and version of this fragment
          * @param clientId Target client ID
          * @param baseSeq Base sequence number of the complete message
          * @param totalSize Total size of the complete message
          * @param offset Offset of this fragment in the complete message
          * @param fragmentData This fragment's data
-         * @return Vector containing the fragment packet
+         * @param flags Flags of the complete message, added to F_FRAGMENT (e.g. F_RELIABLE, F_COMPRESSED)
+         * @param channel Channel of the complete message
+         * @return Pooled buffer containing the fragment packet
          */
-        static std::vector<uint8_t> buildFragment(uint32_t seq, uint32_t ackBase, uint8_t ackBits, uint32_t clientId, uint32_t baseSeq,
-            uint32_t totalSize, uint32_t offset, const std::vector<uint8_t> &fragmentData);
+        static PacketBuffer buildFragment(PacketPool &pool, const HeaderFields &header, uint32_t clientId, uint32_t baseSeq,
+            uint32_t totalSize, uint32_t offset, std::span<const uint8_t> fragmentData, GSPcol::FLAGS flags = {},
+            GSPcol::CHANNEL channel = GSPcol::CHANNEL::RO);
 
         /**
-         * @brief Build an AUTH_OK packet for successful authentication.
-         *
-         * Format: [HEADER:21][ID:4][SESSION_KEY:32]
-         * Total size: 57 bytes
-         *
-         * @param seq Current sequence number
-         * @param ackBase Last received sequence
-         * @param ackBits SACK bitfield
-         * @param clientId Target client ID
-         * @param sessionKey 32-byte session key
-         * @return Vector containing complete AUTH_OK packet
+         * @brief Gets the size of a header, GSPcol::HeaderExtension included from EXTENDED_HEADER_VERSION.
          */
-        static std::vector<uint8_t> buildAuthOkPacket(uint32_t seq, uint32_t ackBase, uint8_t ackBits, uint32_t clientId,
-            const std::array<uint8_t, 32> &sessionKey);
+        [[nodiscard]] static constexpr std::size_t headerSize(const uint8_t version) noexcept
+        {
+            return version >= EXTENDED_HEADER_VERSION ? EXTENDED_HEADER_SIZE : HEADER_SIZE;
+        }
 
         static constexpr uint16_t HEADER_MAGIC = GSPCOL_MAGIC;
         static constexpr uint8_t VERSION = 0x01;
-        static constexpr uint16_t MAX_PACKET_SIZE = 1200;
-        static constexpr uint16_t HEADER_SIZE = 21;
-        static constexpr uint16_t MAX_PAYLOAD_SIZE = MAX_PACKET_SIZE - HEADER_SIZE;
+        static constexpr uint8_t EXTENDED_HEADER_VERSION = 0x02;   ///< Header VERSION with 32 ack bits and ORDER (GSPcol::HeaderExtension)
+        static constexpr uint8_t BATCH_VERSION = 0x03;             ///< Header VERSION of the peers taking CMD_BATCH; header of VERSION 2
+        static constexpr uint8_t QUANTIZED_SNAPSHOT_VERSION = 0x02;///< Client VERSION in CMD_JOIN from which snapshots are quantized
+        static constexpr uint16_t MAX_PACKET_SIZE = 1200;   ///< Largest datagram sent before path MTU discovery confirms more
+        static constexpr uint16_t MAX_PROBED_SIZE = 1472;   ///< 1500, Ethernet's MTU, minus the IPv4 and UDP headers
+        static constexpr uint16_t MAX_PROBED_SIZE_V6 = 1452;///< The same under the IPv6 header, 20 bytes longer
+        static constexpr uint16_t MIN_PACKET_SIZE = 548;    ///< 576, the smallest datagram IPv4 reassembles, minus the IP and UDP headers
+        static constexpr uint16_t HEADER_SIZE = static_cast<uint16_t>(GSPcol::Header::size);
+        static constexpr uint16_t EXTENDED_HEADER_SIZE = static_cast<uint16_t>(HEADER_SIZE + GSPcol::HeaderExtension::size);
+        static constexpr std::size_t MAX_MESSAGE_SIZE = UINT16_MAX;///< A fragmented message, header included, bounded by its SIZE field
+        static constexpr std::size_t MAX_ACKS = (MIN_PACKET_SIZE - EXTENDED_HEADER_SIZE) / GSPcol::AckEntry::size;///< Per CMD_ACK
 };
 
 }// namespace rtype::srv
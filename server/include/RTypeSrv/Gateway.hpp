@@ -7,11 +7,17 @@
 
 #include <RTypeNet/Interfaces.hpp>
 #include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/CommandTable.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/Protocol.hpp>
+#include <RTypeSrv/Reactor.hpp>
+#include <RTypeSrv/SocketBuffers.hpp>
 #include <RTypeSrv/Utils/Singleton.hpp>
 #include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <optional>
 #include <thread>
@@ -110,8 +116,9 @@ class RTYPE_SRV_API Gateway final : public utils::Singleton<Gateway>
          * @brief Initializes the server.
          * @param tcp_endpoint The TCP endpoint to use.
          * @param quit_server A pointer to an atomic boolean that will be set to true when the server should quit.
+         * @param buffers The SO_RCVBUF / SO_SNDBUF sizes of the listening socket, inherited by accepted connections.
          */
-        void initServer(const network::Endpoint &tcp_endpoint, std::atomic<bool> &quit_server);
+        void initServer(const network::Endpoint &tcp_endpoint, std::atomic<bool> &quit_server, const SocketBuffers &buffers = {});
 
     protected:
         explicit Gateway() = default;
@@ -127,66 +134,81 @@ class RTYPE_SRV_API Gateway final : public utils::Singleton<Gateway>
         static constexpr uint8_t MAX_PARSE_ERRORS = 3;      ///< The maximum number of parse errors before a client is disconnected.
         static constexpr size_t MAX_BUFFER_SIZE = 64 * 1024;///< The maximum buffer size for a client.
         static constexpr auto OCCUPANCY_INTERVAL = std::chrono::seconds(60);///< The interval at which to send occupancy requests.
+        static constexpr auto WAIT_TIMEOUT = std::chrono::milliseconds(100);///< The longest a quit request can go unnoticed.
+        static constexpr std::size_t RECV_CHUNK_SIZE = 4096;                ///< The size of a single recv() call.
+        static constexpr auto STATS_INTERVAL = std::chrono::seconds(10);    ///< The interval at which send pressure is logged.
 
         using clock = std::chrono::steady_clock;
         using IP = std::pair<std::array<uint8_t, 16>, uint16_t>;
 
-        using FdsType = std::vector<network::PollFD>;
+        /**
+         * @brief The state of one accepted TCP connection.
+         */
+        struct Connection {
+                network::Socket socket{};
+                std::vector<uint8_t> recv;    ///< Bytes received but not parsed yet.
+                std::deque<PacketBuffer> send;///< Messages waiting for the socket to become writable.
+                std::size_t send_offset = 0;  ///< Bytes of send.front() already written.
+                uint8_t parse_errors = 0;
+                bool open = false;
+        };
+
         using GameToGsType = std::unordered_map<uint32_t, IP>;
-        using GsRegistryType = std::unordered_map<IP, int, pair_hash>;
-        using ParseErrorsType = std::unordered_map<network::Handle, uint8_t>;
-        using OccupancyCacheType = std::unordered_map<IP, uint8_t, pair_hash>;
-        using SocketsMapType = std::unordered_map<std::size_t, network::Socket>;
-        using GsAddrToHandleType = std::unordered_map<IP, network::Handle, pair_hash>;
-        using RecvSpanType = std::unordered_map<network::Handle, std::vector<uint8_t>>;
-        using SendSpanType = std::unordered_map<network::Handle, std::vector<std::vector<uint8_t>>>;
+        using ConnectionsType = std::vector<Connection>;///< Indexed by handle.
+        using GsRegistryType = std::unordered_map<network::Handle, IP>;///< Game server connection -> advertised UDP address.
+        using OccupancyCacheType = std::unordered_map<network::Handle, uint8_t>;
         using PendingCreatesType = std::unordered_map<network::Handle, std::pair<network::Handle, uint8_t>>;
 
         void _serverLoop();
         void _startServer();
         void _cleanupServer();
+        void _reportStats();
 
-        void _parsePackets();
+        void _parsePackets(network::Handle handle);
         void sendOccupancyRequests();
         void _acceptClients() noexcept;
-        void _recvPackets(network::NFDS i);
-        void _sendPackets(network::NFDS i);
-        void _handleLoop(network::NFDS &i) noexcept;
-        void _handleClients(network::NFDS &i) noexcept;
-        void _handleClientsSend(network::NFDS &i) noexcept;
+        [[nodiscard]] bool _recvPackets(network::Handle handle);
+        void _sendPackets(network::Handle handle);
+        void _handleEvent(const Reactor::Event &event) noexcept;
+        void _handleClients(network::Handle handle) noexcept;
+        void _handleClientsSend(network::Handle handle) noexcept;
         void _disconnectByHandle(const network::Handle &handle) noexcept;
 
-        void setPolloutForHandle(network::Handle h) noexcept;
+        void _queueSend(network::Handle handle, PacketBuffer &&data);
+        [[nodiscard]] Connection *_connection(network::Handle handle) noexcept;
         void handleGID(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
         void handleJoin(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
         void handleCreate(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
         void handleOccupancy(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
         void handleGameEnd(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
-        static void handleKO(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
-        static void handleOK(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
+        void handleKO(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
+        void handleOK(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
         void handleGSRegistration(network::Handle handle, const uint8_t *data, size_t &offset, size_t bufsize);
 
+        using Handler = void (Gateway::*)(network::Handle, const uint8_t *, size_t &, size_t);
+        using GatewayCommandTable = CommandTable<GWPcol::CMD, Handler>;
+
+        static const GatewayCommandTable COMMANDS;///< Client and game server commands, see ParsePackets.cpp
+
         void sendErrorResponse(network::Handle handle, uint8_t error_cmd);
         std::optional<GsRegistryType::iterator> findLeastOccupiedGS();
-        [[nodiscard]] network::Handle getGSHandle(const IP &gs_key) const;
         [[nodiscard]] std::optional<IP> findGSKeyByHandle(network::Handle handle) const noexcept;
 
-        FdsType _fds;
+        Reactor _reactor;
+        PacketPool _packet_pool;///< Outgoing messages; only touched by the gateway thread.
         bool _is_init = false;
-        network::NFDS _nfds = 1;
         network::Socket _sock{};
-        SocketsMapType _sockets;
-        SendSpanType _send_spans;
-        RecvSpanType _recv_spans;
-        std::size_t _next_id = 0;
+        ConnectionsType _connections;
         bool _is_running = false;
         GameToGsType _game_to_gs;
         GsRegistryType _gs_registry;
-        ParseErrorsType _parseErrors;
         network::Endpoint _tcp_endpoint{};
         PendingCreatesType _pending_creates;
         OccupancyCacheType _occupancy_cache;
-        GsAddrToHandleType _gs_addr_to_handle;
+        SocketBuffers _buffers{};
+        StreamSendStats _send_stats{};
+        CommandCounters _commands{};
+        clock::time_point _last_stats{};
         std::atomic<bool> *_quit_server = nullptr;
 };
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <RTypeSrv/Gateway.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/PacketWriter.hpp>
+#include <RTypeSrv/ProtocolSchema.hpp>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -103,17 +106,28 @@ class Gateway::PacketParser final
          */
         static std::vector<uint32_t> parseGIDs(const uint8_t *data, std::size_t start, std::size_t bufsize);
 
+        /**
+         * @brief Serializes a gateway protocol packet header into a writer.
+         *
+         * @param out The destination, advanced by 5 bytes.
+         * @param cmd The command identifier.
+         * @param flags Optional flags byte (default: 0).
+         * @throws std::length_error If fewer than 5 bytes remain.
+         */
+        static void writeHeader(PacketWriter &out, uint8_t cmd, uint8_t flags = 0);
+
         /**
          * @brief Builds a complete gateway protocol packet header.
          *
          * Creates the standard header: [MAGIC:2][VERSION:1][FLAGS:1][CMD:1]
          * Total size: 5 bytes
          *
+         * @param pool The gateway pool the packet is taken from.
          * @param cmd The command identifier.
          * @param flags Optional flags byte (default: 0).
-         * @return Vector containing the 5-byte header.
+         * @return Pooled buffer containing the 5-byte header.
          */
-        static std::vector<uint8_t> buildHeader(uint8_t cmd, uint8_t flags = 0);
+        static PacketBuffer buildHeader(PacketPool &pool, uint8_t cmd, uint8_t flags = 0);
 
         /**
          * @brief Builds a CREATE packet message for game server.
@@ -121,10 +135,11 @@ class Gateway::PacketParser final
          * Format: [HEADER:5][GAMETYPE:1]
          * Total size: 6 bytes
          *
+         * @param pool The gateway pool the packet is taken from.
          * @param gametype The type of game to create.
-         * @return Vector containing the complete CREATE packet.
+         * @return Pooled buffer containing the complete CREATE packet.
          */
-        static std::vector<uint8_t> buildCreateMsg(uint8_t gametype);
+        static PacketBuffer buildCreateMsg(PacketPool &pool, uint8_t gametype);
 
         /**
          * @brief Builds a JOIN message for a client.
@@ -132,11 +147,12 @@ class Gateway::PacketParser final
          * Format: [HEADER:5][GAME_ID:4][IP:16][PORT:2]
          * Total size: 27 bytes
          *
+         * @param pool The gateway pool the packet is taken from.
          * @param data Source data buffer containing game ID, IP, and port.
          * @param offset Offset in the source buffer (points to start of game ID).
-         * @return Vector containing the complete JOIN packet for client.
+         * @return Pooled buffer containing the complete JOIN packet for client.
          */
-        static std::vector<uint8_t> buildJoinMsgForClient(const uint8_t *data, std::size_t offset);
+        static PacketBuffer buildJoinMsgForClient(PacketPool &pool, const uint8_t *data, std::size_t offset);
 
         /**
          * @brief Builds a JOIN message for a game server (GW->GS).
@@ -147,12 +163,13 @@ class Gateway::PacketParser final
          * Format: [HEADER:5][CMD:1][GAME_ID:4][IP:16][PORT:2]
          * Total size: 28 bytes
          *
+         * @param pool The gateway pool the packet is taken from.
          * @param ip Client's IPv6 address.
          * @param port Client's port number.
          * @param id Game ID the client is joining.
-         * @return Vector containing the complete packet.
+         * @return Pooled buffer containing the complete packet.
          */
-        static std::vector<uint8_t> buildJoinMsgForGS(const std::array<uint8_t, 16> &ip, uint16_t port, uint32_t id);
+        static PacketBuffer buildJoinMsgForGS(PacketPool &pool, const std::array<uint8_t, 16> &ip, uint16_t port, uint32_t id);
 
         /**
          * @brief Builds a simple response packet with just command byte.
@@ -162,10 +179,11 @@ class Gateway::PacketParser final
          *
          * Used for: GS_OK, GS_KO, CREATE_KO, JOIN_KO
          *
+         * @param pool The gateway pool the packet is taken from.
          * @param cmd The command/response identifier.
-         * @return Vector containing the complete response packet.
+         * @return Pooled buffer containing the complete response packet.
          */
-        static std::vector<uint8_t> buildSimpleResponse(uint8_t cmd);
+        static PacketBuffer buildSimpleResponse(PacketPool &pool, uint8_t cmd);
 };
 
 }// namespace rtype::srv
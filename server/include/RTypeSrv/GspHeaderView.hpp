@@ -0,0 +1,154 @@
+#pragma once
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/ProtocolSchema.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+
+namespace rtype::srv {
+
+/**
+ * @brief Validated, zero-copy view of one received GSPcol datagram.
+ *
+ * parse() checks the header once (length, magic, version and SIZE against the
+ * datagram length); every accessor is then a single load at a constant offset,
+ * byte-swapped from big-endian. The view is what the UDP handlers receive, so no
+ * handler looks at the raw header bytes again.
+ *
+ * Header versions 1 to 3 are accepted. VERSION 2 appends GSPcol::HeaderExtension
+ * (32-bit ACKMASK, ORDER) to the VERSION 1 fields, which keep their offsets; the
+ * accessors hide the difference. VERSION 3 has the VERSION 2 header.
+ *
+ * The view does not own the bytes: it is only valid while the datagram it was
+ * parsed from (a DatagramRing or io_uring buffer) is.
+ */
+class RTYPE_SRV_API GspHeaderView final
+{
+    public:
+        /**
+         * @brief Why a datagram was rejected.
+         */
+        enum class Error : uint8_t {
+            TOO_SHORT,  ///< Shorter than the header
+            BAD_MAGIC,  ///< Not a GSPcol packet
+            BAD_VERSION,///< Unsupported protocol version
+            BAD_SIZE,   ///< SIZE does not match the datagram length
+        };
+
+        /**
+         * @brief Validates the header at the start of a datagram.
+         * @param datagram The received bytes, exactly one packet.
+         * @return The view, or the first check that failed.
+         */
+        [[nodiscard]] static std::expected<GspHeaderView, Error> parse(std::span<const uint8_t> datagram) noexcept;
+
+        /**
+         * @brief Gets a short description of a parse error, for logs.
+         */
+        [[nodiscard]] static const char *describe(Error error) noexcept;
+
+        [[nodiscard]] uint8_t version() const noexcept
+        {
+            return _header().get<GSPcol::field::Version>();
+        }
+        [[nodiscard]] GSPcol::FLAGS flags() const noexcept
+        {
+            return _header().get<GSPcol::field::Flags>();
+        }
+        [[nodiscard]] bool hasFlag(const GSPcol::FLAGS flag) const noexcept
+        {
+            return (static_cast<uint8_t>(flags()) & static_cast<uint8_t>(flag)) != 0;
+        }
+        [[nodiscard]] uint32_t seq() const noexcept
+        {
+            return _header().get<GSPcol::field::Seq>();
+        }
+        [[nodiscard]] uint32_t ackBase() const noexcept
+        {
+            return _header().get<GSPcol::field::AckBase>();
+        }
+        /**
+         * @brief Gets the acknowledgement bits: bit i set if packet ACKBASE - 1 - i was received.
+         *
+         * 32 packets from VERSION 2 (ACKMASK), 8 in VERSION 1, see ackWidth().
+         */
+        [[nodiscard]] uint32_t ackBits() const noexcept
+        {
+            return _extended() ? _extension().get<GSPcol::field::AckMask>() : _header().get<GSPcol::field::AckBits>();
+        }
+        [[nodiscard]] unsigned ackWidth() const noexcept
+        {
+            return _extended() ? 32 : 8;
+        }
+        /**
+         * @brief Gets the position of an RO message among those of its sender, or 0 in VERSION 1.
+         */
+        [[nodiscard]] uint16_t order() const noexcept
+        {
+            return _extended() ? _extension().get<GSPcol::field::Order>() : uint16_t{0};
+        }
+        [[nodiscard]] GSPcol::CHANNEL channel() const noexcept
+        {
+            return _header().get<GSPcol::field::Channel>();
+        }
+        [[nodiscard]] uint16_t size() const noexcept
+        {
+            return _header().get<GSPcol::field::Size>();
+        }
+        [[nodiscard]] uint32_t clientId() const noexcept
+        {
+            return _header().get<GSPcol::field::ClientId>();
+        }
+        [[nodiscard]] GSPcol::CMD cmd() const noexcept
+        {
+            return _header().get<GSPcol::field::Cmd>();
+        }
+
+        /**
+         * @brief Gets the whole packet, header included.
+         */
+        [[nodiscard]] std::span<const uint8_t> bytes() const noexcept
+        {
+            return _packet;
+        }
+
+        /**
+         * @brief Gets the command payload, i.e. the bytes following the header.
+         */
+        [[nodiscard]] std::span<const uint8_t> payload() const noexcept
+        {
+            return _packet.subspan(headerSize());
+        }
+
+        /**
+         * @brief Gets the size of the header, extension included.
+         */
+        [[nodiscard]] std::size_t headerSize() const noexcept
+        {
+            return _extended() ? GSPcol::Header::size + GSPcol::HeaderExtension::size : GSPcol::Header::size;
+        }
+
+    private:
+        explicit GspHeaderView(const std::span<const uint8_t> packet) noexcept : _packet(packet)
+        {
+        }
+
+        [[nodiscard]] GSPcol::Header::View _header() const noexcept
+        {
+            return GSPcol::Header::at(_packet.data());
+        }
+        [[nodiscard]] GSPcol::HeaderExtension::View _extension() const noexcept
+        {
+            return GSPcol::HeaderExtension::at(_packet.data() + GSPcol::Header::size);
+        }
+        [[nodiscard]] bool _extended() const noexcept
+        {
+            return version() != 1;// parse() accepts 1 to 3 only
+        }
+
+        std::span<const uint8_t> _packet;
+};
+
+}// namespace rtype::srv
@@ -0,0 +1,103 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/Components.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace rtype::srv {
+
+/**
+ * @brief How far from its player a client sees entities.
+ *
+ * An entity enters a client's view within radius of its player, and leaves it only
+ * beyond radius + hysteresis, so one moving along the edge does not flicker in and out.
+ */
+struct InterestOptions {
+        float radius{1024.0f};   ///< 0 sends every entity to every client
+        float hysteresis{128.0f};///< Extra distance an entity in view keeps it
+
+        [[nodiscard]] constexpr bool enabled() const noexcept
+        {
+            return radius > 0.0f;
+        }
+};
+
+/**
+ * @brief Uniform grid over the entities of one snapshot, for the queries of InterestSet.
+ *
+ * Each entity is filed under the cell of its position; the cells are kept as one
+ * vector sorted by cell, so a rebuild does not allocate once it has grown.
+ */
+class RTYPE_SRV_API InterestGrid final
+{
+    public:
+        /**
+         * @brief Files the entities of a snapshot, replacing the previous ones.
+         * @param cellSize The side of a cell; queries of about that radius visit 4 to 9 cells.
+         */
+        void build(std::span<const SnapshotEntity> entities, float cellSize);
+
+        /**
+         * @brief Appends the index of every entity whose cell is within radius of (x, y), in no particular order.
+         *
+         * Entities up to a cell farther than radius are included: callers check the distance.
+         */
+        void query(float x, float y, float radius, std::vector<uint32_t> &out) const;
+
+        static constexpr float MIN_CELL_SIZE = 16.0f;
+
+    private:
+        struct Item {
+                uint64_t cell;
+                uint32_t index;
+        };
+
+        [[nodiscard]] int32_t _coordinate(float value) const noexcept;
+        [[nodiscard]] static uint64_t _key(int32_t cx, int32_t cy) noexcept;
+
+        std::vector<Item> _items;///< Sorted by cell
+        float _cell_size{MIN_CELL_SIZE};
+};
+
+/**
+ * @brief The entities one client sees, kept from tick to tick for the hysteresis.
+ */
+class RTYPE_SRV_API InterestSet final
+{
+    public:
+        /**
+         * @brief Recomputes the view around the client's player.
+         *
+         * The player itself is always in view. A client without a player in the
+         * snapshot, not spawned yet, sees every entity.
+         *
+         * @param entities The snapshot the grid was built from, sorted by id.
+         * @param focus The entity id of the client's player, if it has one.
+         * @param out Receives the entities in view, sorted by id.
+         * @return The number of entities that entered the view.
+         */
+        std::size_t update(const InterestGrid &grid, std::span<const SnapshotEntity> entities, std::optional<uint32_t> focus,
+            const InterestOptions &options, std::vector<SnapshotEntity> &out);
+
+    private:
+        [[nodiscard]] bool _contains(uint32_t id) const noexcept;
+
+        std::vector<uint32_t> _ids;       ///< In view after the last update, sorted
+        std::vector<uint32_t> _candidates;///< Reused by update()
+        std::vector<uint32_t> _next;      ///< Reused by update()
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
@@ -0,0 +1,133 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeNet/Interfaces.hpp>
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/DatagramRing.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/Utils/NonCopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rtype::srv {
+
+/**
+ * @brief io_uring data path for a UDP socket, an alternative to DatagramRing + DatagramQueue.
+ *
+ * Receive uses a single multishot recvmsg backed by a provided buffer ring: the kernel
+ * picks a free buffer for each datagram and posts one completion per datagram without
+ * any further submission. Buffers referenced by views() are handed back to the kernel
+ * by clear(); when the receive stops on a dry buffer ring, drain() re-arms it as soon
+ * as it reaps the final completion. Views carry the kernel receive time when SO_TIMESTAMPNS is available,
+ * and receive buffer overflows are counted through SO_RXQ_OVFL.
+ *
+ * Send gathers the datagrams pushed during a tick and submits them as one chain of
+ * hard-linked sendmsg requests, so a tick flush costs a single io_uring_enter() and
+ * one failing destination does not cancel the rest of the chain.
+ *
+ * The ring file descriptor becomes readable when completions are pending, so it is
+ * registered in the Reactor in place of the socket.
+ *
+ * Only available on Linux builds with liburing (RTYPE_SRV_HAS_IO_URING); otherwise
+ * the constructor throws and callers keep the poll path.
+ */
+class RTYPE_SRV_API IoUringEngine final : public utils::NonCopyable
+{
+    public:
+        /**
+         * @brief Engine counters, reported next to the poll path counters.
+         */
+        struct Stats {
+                uint64_t submits{0};     ///< io_uring_submit() calls
+                uint64_t recv_datagrams{0};
+                uint64_t send_datagrams{0};
+                uint64_t send_errors{0};
+                uint64_t recv_rearms{0}; ///< Multishot receive re-armed (buffer ring ran dry or error)
+                uint64_t recv_drops{0};  ///< Datagrams the kernel dropped on a full receive buffer (SO_RXQ_OVFL)
+        };
+
+        /**
+         * @brief Sets up the ring, registers the buffer ring and arms the multishot receive.
+         * @param handle The bound UDP socket.
+         * @param entries The submission queue size, also the maximum number of sends in flight.
+         * @param nbufs The number of receive buffers (rounded up to a power of two).
+         * @param bufSize The size of a receive buffer, including the recvmsg header, address and control data.
+         * @throws Exception If io_uring is unavailable or the kernel rejects the setup.
+         */
+        explicit IoUringEngine(network::Handle handle, unsigned entries = DEFAULT_ENTRIES, std::size_t nbufs = DEFAULT_BUFFERS,
+            std::size_t bufSize = DEFAULT_BUFFER_SIZE);
+        ~IoUringEngine() noexcept;
+
+        /**
+         * @brief Tells whether the server was built with io_uring support.
+         */
+        [[nodiscard]] static bool available() noexcept;
+
+        /**
+         * @brief Gets the ring file descriptor to register in the reactor.
+         */
+        [[nodiscard]] network::Handle eventHandle() const noexcept;
+
+        /**
+         * @brief Reaps every pending completion, and re-arms the multishot receive if it stopped.
+         * @return The number of datagrams received by this call.
+         */
+        std::size_t drain();
+
+        /**
+         * @brief Gets the datagrams received since the last clear().
+         * @return A span of views into the receive buffers, in reception order.
+         */
+        [[nodiscard]] std::span<const DatagramRing::View> views() const noexcept;
+
+        /**
+         * @brief Returns the buffers behind views() to the kernel.
+         */
+        void clear();
+
+        /**
+         * @brief Queues a datagram for the next flush().
+         * @param endpoint The destination.
+         * @param data The datagram, held by the engine until the send completes.
+         */
+        void push(const network::Endpoint &endpoint, PacketBuffer data);
+
+        /**
+         * @brief Submits the queued datagrams as one linked chain.
+         * @return true if every queued datagram was submitted, false if the ring was full.
+         */
+        bool flush();
+
+        /**
+         * @brief Gets the counters accumulated since the last resetStats().
+         */
+        [[nodiscard]] const Stats &stats() const noexcept;
+
+        /**
+         * @brief Resets the counters.
+         */
+        void resetStats() noexcept;
+
+        static constexpr unsigned DEFAULT_ENTRIES = 256;
+        static constexpr std::size_t DEFAULT_BUFFERS = 512;
+        static constexpr std::size_t DEFAULT_BUFFER_SIZE = 2048;
+
+    private:
+        struct Impl;
+
+        std::unique_ptr<Impl> _impl;
+        Stats _stats{};
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
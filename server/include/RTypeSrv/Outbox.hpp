@@ -0,0 +1,144 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/PacketCipher.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/PacketWriter.hpp>
+#include <RTypeSrv/ReliableChannel.hpp>
+#include <RTypeSrv/Snapshot.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace rtype::srv {
+
+/**
+ * @brief The messages queued for one client during a tick, sent together at the end of it.
+ *
+ * Messages are queued as bare payloads: the sequence number, acknowledgements and
+ * ORDER of their header are only known when flush() turns them into datagrams. A
+ * client speaking header VERSION 3 (GameServerUDPPacketParser::BATCH_VERSION) gets
+ * as many messages as fit under its MTU in one CMD_BATCH, each behind a 4-byte
+ * GSPcol::BatchEntry instead of its own header; older clients get one datagram per
+ * message.
+ *
+ * Only messages of the same channel and reliability share a datagram: an unreliable
+ * snapshot is never retransmitted along with a reliable message, and a batch takes
+ * one ORDER, its messages being delivered in the order they were queued.
+ */
+class RTYPE_SRV_API Outbox final
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Where flush() sends the messages.
+         */
+        struct Destination {
+                ReliableChannel &channel;    ///< Gives the headers and records the datagrams
+                SnapshotAcks *acks;          ///< Records the datagrams carrying snapshots; null if the client takes none
+                uint32_t client_id;
+                uint16_t mtu;                ///< Path MTU; PacketCipher::TAG_SIZE bytes of it go to the tag if key is set
+                PacketCipher *cipher;        ///< Seals the datagrams if key is set
+                const PacketCipher::Key *key;///< Of a client that encrypts; null sends the datagrams in clear
+        };
+
+        /**
+         * @brief What a message is, besides its payload.
+         */
+        struct Tag {
+                std::optional<uint32_t> snapshot;///< Snapshot sequence number carried, recorded in Destination::acks
+                bool stamped;                    ///< Wants a transmit timestamp, see flush()
+        };
+
+        /**
+         * @brief Coalescing counters, kept by the caller over all its outboxes.
+         */
+        struct Stats {
+                uint64_t messages{0}; ///< Messages flushed
+                uint64_t datagrams{0};///< Datagrams they took, fragments included
+                uint64_t batched{0};  ///< Messages sent in a CMD_BATCH
+                uint64_t saved{0};    ///< Header bytes batching saved
+        };
+
+        /**
+         * @brief Queues a message, its payload copied from consecutive pieces.
+         */
+        void push(GSPcol::CMD cmd, GSPcol::FLAGS flags, GSPcol::CHANNEL channel, std::initializer_list<std::span<const uint8_t>> payload,
+            const Tag &tag = {});
+
+        /**
+         * @brief Queues a message of size bytes, to be written in place.
+         *
+         * The writer is valid until the next call on the outbox. finish() then
+         * shrinks the payload to what was written, or cancel() drops the message.
+         *
+         * @return A writer over the payload.
+         */
+        [[nodiscard]] PacketWriter append(GSPcol::CMD cmd, GSPcol::FLAGS flags, GSPcol::CHANNEL channel, std::size_t size,
+            const Tag &tag = {});
+
+        /**
+         * @brief Shrinks the payload of the message append() queued last.
+         */
+        void finish(std::size_t size) noexcept;
+
+        /**
+         * @brief Drops the message append() queued last.
+         */
+        void cancel() noexcept;
+
+        /**
+         * @brief Drops every message queued.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Turns the messages queued into datagrams, and empties the outbox.
+         *
+         * Each datagram takes the header of to.channel, which records it as sent,
+         * sealed first if to.key is set: a retransmission resends the same bytes. A
+         * message too large to share a datagram goes alone, fragmented if it exceeds
+         * the MTU (see GameServerUDPPacketParser::appendMessage()).
+         *
+         * @param out The queue the datagrams are appended to
+         * @return The index in out of the datagram carrying a stamped message, if any
+         */
+        std::optional<std::size_t> flush(PacketPool &pool, const Destination &to, std::vector<PacketBuffer> &out, Clock::time_point now,
+            ReliableChannel::Stats &reliable, Stats &stats);
+
+        [[nodiscard]] bool empty() const noexcept;
+
+    private:
+        struct Message {
+                GSPcol::CMD cmd{};
+                GSPcol::FLAGS flags{};
+                GSPcol::CHANNEL channel{};
+                std::size_t offset{0};///< In _payloads
+                std::size_t size{0};
+                Tag tag{};
+                bool sent{false};
+        };
+
+        [[nodiscard]] std::span<const uint8_t> _payload(const Message &message) const noexcept;
+        [[nodiscard]] static bool _compatible(const Message &a, const Message &b) noexcept;
+
+        std::vector<Message> _messages;
+        std::vector<uint8_t> _payloads;
+        std::vector<std::size_t> _batch;///< Indices in _messages of the datagram being built, reused by flush()
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
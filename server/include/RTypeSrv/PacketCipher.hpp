@@ -0,0 +1,121 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <RTypeSrv/Utils/NonCopyable.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+struct evp_cipher_ctx_st;
+
+namespace rtype::srv {
+
+/**
+ * @brief ChaCha20-Poly1305 protection of the GSPcol packets of a client that encrypts (F_ENCRYPTED).
+ *
+ * A sealed packet keeps its header in clear as the associated data, with F_ENCRYPTED
+ * set and SIZE counting the TAG_SIZE-byte tag appended after the encrypted payload.
+ * The nonce is the SEQ of the header behind a byte telling the direction, so that the
+ * client and the server never use the same nonce under their shared session key.
+ *
+ * The contexts are created with the cipher once and rekeyed for every packet, so
+ * sealing and opening do not allocate. A cipher belongs to one worker thread, like
+ * its PacketPool.
+ */
+class RTYPE_SRV_API PacketCipher final : public utils::NonCopyable
+{
+    public:
+        using Key = std::array<uint8_t, 32>;
+
+        /**
+         * @brief Who sent a packet, the first byte of its nonce.
+         */
+        enum class Direction : uint8_t { CLIENT = 0, SERVER = 1 };
+
+        /**
+         * @brief Cipher counters; busy over sealed + opened + rejected is the cost of one packet.
+         */
+        struct Stats {
+                uint64_t sealed{0};
+                uint64_t opened{0};
+                uint64_t rejected{0};///< Forged or corrupted packets, or sealed under another key
+                std::chrono::nanoseconds busy{0};
+        };
+
+        /**
+         * @throws std::runtime_error If OpenSSL cannot create the contexts.
+         */
+        PacketCipher();
+        ~PacketCipher() noexcept;
+
+        /**
+         * @brief Encrypts a complete packet in place and appends its tag.
+         * @return false if the packet is malformed, or too large for the tag.
+         */
+        [[nodiscard]] bool seal(const Key &key, Direction from, PacketBuffer &packet) noexcept;
+
+        /**
+         * @brief Checks and decrypts a sealed packet, writing it in clear, without F_ENCRYPTED nor the tag.
+         *
+         * @param datagram A packet whose header was validated (GspHeaderView::parse()).
+         * @param out At least datagram.size() bytes; receives datagram.size() - TAG_SIZE bytes.
+         * @return false if the tag does not match: out must be ignored.
+         */
+        [[nodiscard]] bool open(const Key &key, Direction from, std::span<const uint8_t> datagram, std::span<uint8_t> out) noexcept;
+
+        /**
+         * @brief Gets the counters accumulated since the last resetStats().
+         */
+        [[nodiscard]] const Stats &stats() const noexcept;
+
+        void resetStats() noexcept;
+
+        static constexpr std::size_t TAG_SIZE = 16;
+        static constexpr std::size_t NONCE_SIZE = 12;
+
+    private:
+        evp_cipher_ctx_st *_seal = nullptr;
+        evp_cipher_ctx_st *_open = nullptr;
+        Stats _stats{};
+};
+
+/**
+ * @brief The SEQs of the packets opened for one client, rejecting a packet replayed.
+ *
+ * A SEQ more than WIDTH behind the highest accepted cannot be told apart from a
+ * replay, so it is rejected too.
+ */
+class RTYPE_SRV_API ReplayWindow final
+{
+    public:
+        /**
+         * @brief Tells whether no packet of that SEQ was accepted; checked before opening the packet.
+         */
+        [[nodiscard]] bool fresh(uint32_t seq) const noexcept;
+
+        /**
+         * @brief Records the SEQ of a packet opened.
+         */
+        void accept(uint32_t seq) noexcept;
+
+        static constexpr uint32_t WIDTH = 64;
+
+    private:
+        uint32_t _highest{0};
+        uint64_t _seen{0};///< Bit i: SEQ _highest - i accepted
+        bool _started{false};
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
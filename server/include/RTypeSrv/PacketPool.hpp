@@ -0,0 +1,221 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/Utils/NonCopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace rtype::srv {
+
+class PacketBuffer;
+
+/**
+ * @brief Pool of fixed-size, MTU-sized packet buffers owned by one worker thread.
+ *
+ * Buffers are carved from slabs of SLAB_BUFFERS blocks and recycled through an
+ * intrusive free list, so once the pool has grown to the worker's peak working set
+ * acquiring and releasing a packet never touches the heap. There is no locking:
+ * a pool and every PacketBuffer taken from it must stay on the thread that owns it,
+ * and the pool must outlive its buffers.
+ */
+class RTYPE_SRV_API PacketPool final : public utils::NonCopyable
+{
+    public:
+        /**
+         * @brief Pool counters; slabs > 0 after warm-up means the steady state still allocates.
+         */
+        struct Stats {
+                uint64_t acquired{0};///< Buffers handed out
+                uint64_t slabs{0};   ///< Slabs allocated (one malloc each)
+                std::size_t in_use{0};
+                std::size_t capacity{0};
+        };
+
+        /**
+         * @brief Constructs a pool and preallocates its first slabs.
+         * @param initialBuffers The number of buffers available before the pool has to grow.
+         */
+        explicit PacketPool(std::size_t initialBuffers = SLAB_BUFFERS);
+        ~PacketPool() noexcept;
+
+        /**
+         * @brief Takes an empty buffer from the pool, growing it by one slab if every buffer is in use.
+         */
+        [[nodiscard]] PacketBuffer acquire();
+
+        /**
+         * @brief Gets the counters accumulated since the last resetStats().
+         */
+        [[nodiscard]] const Stats &stats() const noexcept;
+
+        /**
+         * @brief Resets the cumulative counters (in_use and capacity are kept).
+         */
+        void resetStats() noexcept;
+
+        static constexpr std::size_t BUFFER_SIZE = 1536;///< Ethernet MTU, rounded up
+        static constexpr std::size_t SLAB_BUFFERS = 256;
+
+    private:
+        friend class PacketBuffer;
+
+        struct Block {
+                Block *next = nullptr;
+                PacketPool *pool = nullptr;
+                uint32_t refs = 0;
+                uint32_t size = 0;
+                alignas(16) uint8_t data[BUFFER_SIZE];
+        };
+
+        void _grow();
+        static void _release(Block *block) noexcept;
+
+        std::vector<std::unique_ptr<Block[]>> _slabs;
+        Block *_free = nullptr;
+        Stats _stats{};
+};
+
+/**
+ * @brief Reference-counted handle to a PacketPool buffer.
+ *
+ * Copying a handle shares the buffer (no byte copy), which is how one packet is
+ * queued for several destinations; the buffer returns to its pool when the last
+ * handle goes away. The bytes must not be modified once the packet is shared.
+ *
+ * The interface mirrors the parts of std::vector<uint8_t> used by the packet
+ * builders, but the capacity is fixed to PacketPool::BUFFER_SIZE.
+ */
+class RTYPE_SRV_API PacketBuffer final
+{
+    public:
+        PacketBuffer() noexcept = default;
+        PacketBuffer(const PacketBuffer &other) noexcept;
+        PacketBuffer(PacketBuffer &&other) noexcept;
+        PacketBuffer &operator=(const PacketBuffer &rhs) noexcept;
+        PacketBuffer &operator=(PacketBuffer &&rhs) noexcept;
+        ~PacketBuffer() noexcept;
+
+        [[nodiscard]] uint8_t *data() noexcept
+        {
+            return _block ? _block->data : nullptr;
+        }
+        [[nodiscard]] const uint8_t *data() const noexcept
+        {
+            return _block ? _block->data : nullptr;
+        }
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return _block ? _block->size : 0;
+        }
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+        [[nodiscard]] static constexpr std::size_t capacity() noexcept
+        {
+            return PacketPool::BUFFER_SIZE;
+        }
+        [[nodiscard]] std::span<const uint8_t> span() const noexcept
+        {
+            return {data(), size()};
+        }
+
+        /**
+         * @brief Gets the whole writable capacity, for a PacketWriter; publish the bytes with resize().
+         */
+        [[nodiscard]] std::span<uint8_t> storage() noexcept
+        {
+            return _block ? std::span<uint8_t>{_block->data, PacketPool::BUFFER_SIZE} : std::span<uint8_t>{};
+        }
+        [[nodiscard]] uint8_t *begin() noexcept
+        {
+            return data();
+        }
+        [[nodiscard]] uint8_t *end() noexcept
+        {
+            return data() + size();
+        }
+        [[nodiscard]] const uint8_t *begin() const noexcept
+        {
+            return data();
+        }
+        [[nodiscard]] const uint8_t *end() const noexcept
+        {
+            return data() + size();
+        }
+        uint8_t &operator[](const std::size_t i) noexcept
+        {
+            return _block->data[i];
+        }
+        const uint8_t &operator[](const std::size_t i) const noexcept
+        {
+            return _block->data[i];
+        }
+
+        /**
+         * @brief Tells whether the handle refers to a buffer.
+         */
+        explicit operator bool() const noexcept
+        {
+            return _block != nullptr;
+        }
+
+        /**
+         * @brief Gets the number of handles sharing the buffer.
+         */
+        [[nodiscard]] uint32_t useCount() const noexcept
+        {
+            return _block ? _block->refs : 0;
+        }
+
+        /**
+         * @brief Appends a byte.
+         * @throws std::length_error If the buffer is full or the handle is empty.
+         */
+        void push_back(uint8_t byte);
+
+        /**
+         * @brief Appends bytes.
+         * @throws std::length_error If they do not fit or the handle is empty.
+         */
+        void append(std::span<const uint8_t> bytes);
+
+        /**
+         * @brief Sets the payload size; new bytes are left uninitialized.
+         * @throws std::length_error If size exceeds capacity() or the handle is empty.
+         */
+        void resize(std::size_t size);
+
+        /**
+         * @brief Empties the buffer but keeps it.
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Drops this handle's reference.
+         */
+        void reset() noexcept;
+
+    private:
+        friend class PacketPool;
+
+        explicit PacketBuffer(PacketPool::Block *block) noexcept : _block(block)
+        {
+        }
+
+        PacketPool::Block *_block = nullptr;
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
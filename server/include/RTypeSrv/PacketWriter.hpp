@@ -0,0 +1,132 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+namespace rtype::srv {
+
+/**
+ * @brief Big-endian serializer writing straight into caller-provided memory.
+ *
+ * The writer owns nothing: it fills a span (a stack array, PacketBuffer::storage(), ...)
+ * from the front. Integers are byte-swapped in a register and written with one
+ * unaligned store, so building a packet costs a handful of stores and no allocation.
+ *
+ * Typical use with a pooled buffer:
+ * @code
+ * PacketBuffer packet = pool.acquire();
+ * PacketWriter out(packet.storage());
+ * out.u8(cmd).u32(id).bytes(key);
+ * packet.resize(out.size());
+ * @endcode
+ */
+class PacketWriter final
+{
+    public:
+        /**
+         * @brief Constructs a writer over a destination span.
+         * @param out The memory to fill; the writer never writes past its end.
+         */
+        explicit PacketWriter(const std::span<uint8_t> out) noexcept : _out(out)
+        {
+        }
+
+        PacketWriter &u8(const uint8_t value)
+        {
+            return _put(value);
+        }
+        PacketWriter &u16(const uint16_t value)
+        {
+            return _put(value);
+        }
+        PacketWriter &u32(const uint32_t value)
+        {
+            return _put(value);
+        }
+        PacketWriter &u64(const uint64_t value)
+        {
+            return _put(value);
+        }
+
+        /**
+         * @brief Copies raw bytes.
+         * @throws std::length_error If they do not fit.
+         */
+        PacketWriter &bytes(const std::span<const uint8_t> data)
+        {
+            if (!data.empty()) {
+                std::memcpy(claim(data.size()).data(), data.data(), data.size());
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Reserves n bytes at the write position for the caller to fill.
+         *
+         * Lets fixed-size blocks (see schema::Layout) pay for one bounds check.
+         *
+         * @throws std::length_error If fewer than n bytes remain; nothing is reserved then.
+         */
+        [[nodiscard]] std::span<uint8_t> claim(const std::size_t n)
+        {
+            if (n > _out.size() - _pos) {
+                throw std::length_error("PacketWriter overflow");
+            }
+            const std::span<uint8_t> at = _out.subspan(_pos, n);
+            _pos += n;
+            return at;
+        }
+
+        /**
+         * @brief Gets the number of bytes written so far.
+         */
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return _pos;
+        }
+
+        /**
+         * @brief Gets the number of bytes that can still be written.
+         */
+        [[nodiscard]] std::size_t remaining() const noexcept
+        {
+            return _out.size() - _pos;
+        }
+
+        /**
+         * @brief Gets the memory past the write position, for an encoder that fills it directly and then claim()s what it used.
+         */
+        [[nodiscard]] std::span<uint8_t> unwritten() const noexcept
+        {
+            return _out.subspan(_pos);
+        }
+
+        /**
+         * @brief Gets the bytes written so far.
+         */
+        [[nodiscard]] std::span<const uint8_t> written() const noexcept
+        {
+            return _out.first(_pos);
+        }
+
+    private:
+        template<std::unsigned_integral T>
+        PacketWriter &_put(T value)
+        {
+            if constexpr (sizeof(T) > 1 && std::endian::native == std::endian::little) {
+                value = std::byteswap(value);
+            }
+            std::memcpy(claim(sizeof(T)).data(), &value, sizeof(T));
+            return *this;
+        }
+
+        std::span<uint8_t> _out;
+        std::size_t _pos = 0;
+};
+
+}// namespace rtype::srv
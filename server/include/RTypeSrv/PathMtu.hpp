@@ -0,0 +1,99 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace rtype::srv {
+
+/**
+ * @brief Path MTU discovery for one client, after RFC 8899 (DPLPMTUD): the largest datagram its path delivers.
+ *
+ * The search starts from a base known to pass and probes larger sizes with a padded
+ * datagram on UU. The client's acknowledgement of a probe's SEQ confirms its size,
+ * and the size becomes the MTU at once; MAX_PROBES probes of a size lost in a row rule
+ * it out. Sizes are searched by halving the range between the MTU and the smallest
+ * size ruled out, down to STEP bytes.
+ *
+ * Once done, a probe of the MTU itself checks every CONFIRM_INTERVAL that the path
+ * still takes it; MAX_PROBES losses of those fall back to the base, the path having
+ * become a black hole for larger datagrams. Every RAISE_INTERVAL the search resumes
+ * from the MTU, in case the path grew.
+ */
+class RTYPE_SRV_API PathMtu final
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Discovery counters, kept by the caller over all its clients.
+         */
+        struct Stats {
+                uint64_t probes{0};     ///< Probes sent, retries included
+                uint64_t confirmed{0};  ///< Probes acknowledged
+                uint64_t lost{0};       ///< Probes not acknowledged in time
+                uint64_t black_holes{0};///< Falls back to the base
+        };
+
+        /**
+         * @param base The size assumed to pass before any probe, the MTU until one is confirmed.
+         * @param ceiling The largest size probed.
+         */
+        PathMtu(uint16_t base, uint16_t ceiling) noexcept;
+
+        /**
+         * @brief Gets the size of the probe to send now, if one is due; the caller sends it and reports its SEQ to sent().
+         *
+         * A probe not acknowledged within timeout is lost; one at a time is outstanding.
+         */
+        [[nodiscard]] std::optional<uint16_t> due(Clock::time_point now, std::chrono::microseconds timeout, Stats &stats) noexcept;
+
+        /**
+         * @brief Records the SEQ of the probe due() asked for.
+         */
+        void sent(uint32_t seq) noexcept;
+
+        /**
+         * @brief Applies the acknowledgements of a received packet header.
+         * @param width The number of bits of ackBits in use, see GspHeaderView::ackWidth().
+         */
+        void acknowledge(uint32_t ackBase, uint32_t ackBits, unsigned width, Clock::time_point now, Stats &stats) noexcept;
+
+        /**
+         * @brief Gets the largest datagram confirmed to pass, or the base.
+         */
+        [[nodiscard]] uint16_t mtu() const noexcept;
+
+        static constexpr uint16_t STEP = 16;
+        static constexpr unsigned MAX_PROBES = 3;
+        static constexpr auto CONFIRM_INTERVAL = std::chrono::seconds(30);
+        static constexpr auto RAISE_INTERVAL = std::chrono::seconds(300);
+
+    private:
+        enum class Phase : uint8_t { SEARCH, DONE, CONFIRM };
+
+        uint16_t _base;
+        uint16_t _ceiling;
+        uint16_t _mtu;
+        uint16_t _limit;    ///< Largest size not ruled out
+        uint16_t _probe{0}; ///< Size being probed, 0 between sizes
+        unsigned _losses{0};///< Probes of _probe lost in a row
+        uint32_t _probe_seq{0};
+        bool _outstanding{false};
+        Phase _phase{Phase::SEARCH};
+        Clock::time_point _deadline;///< Of the outstanding probe
+        Clock::time_point _confirm; ///< Next probe of the MTU itself, once DONE
+        Clock::time_point _raise;   ///< Next search, once DONE
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
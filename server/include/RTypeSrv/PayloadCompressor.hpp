@@ -0,0 +1,96 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/Utils/NonCopyable.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace rtype::srv {
+
+/**
+ * @brief zstd compression of GSPcol payloads with the dictionary shipped with the server.
+ *
+ * Snapshot payloads are a few hundred bytes at most, too small for a compressor to
+ * learn anything from the payload alone; the dictionary, trained on keyframes,
+ * primes it with the layout and the usual values. The frame records the dictionary
+ * id, so a client holding another version of the dictionary detects it instead of
+ * decoding garbage.
+ *
+ * One compressor per worker thread: the zstd contexts are reused for every payload
+ * and are not thread-safe.
+ *
+ * Only available in builds with zstd (RTYPE_SRV_HAS_ZSTD); otherwise the constructor
+ * throws and callers send uncompressed payloads.
+ */
+class RTYPE_SRV_API PayloadCompressor final : public utils::NonCopyable
+{
+    public:
+        /**
+         * @brief Compression counters, kept per game by the caller.
+         */
+        struct Stats {
+                uint64_t payloads{0};            ///< Payloads offered to compress()
+                uint64_t compressed{0};          ///< Payloads sent compressed
+                uint64_t bytes_in{0};            ///< Size of the payloads offered
+                uint64_t bytes_out{0};           ///< Size actually sent, compressed or not
+                std::chrono::nanoseconds busy{0};///< Time spent compressing, including payloads that did not pay
+        };
+
+        /**
+         * @brief Creates the zstd contexts and loads the dictionary.
+         * @param minSaving The bytes a payload must shrink by to be sent compressed.
+         * @param level The zstd compression level.
+         * @throws Exception If zstd support is missing or the contexts cannot be created.
+         */
+        explicit PayloadCompressor(std::size_t minSaving = DEFAULT_MIN_SAVING, int level = DEFAULT_LEVEL);
+        ~PayloadCompressor() noexcept;
+
+        /**
+         * @brief Tells whether the server was built with zstd.
+         */
+        [[nodiscard]] static bool available() noexcept;
+
+        /**
+         * @brief Compresses a payload into one zstd frame, if that saves enough.
+         * @param out Receives the frame; it needs no more room than the payload itself.
+         * @param stats The counters the attempt is recorded in.
+         * @return The size of the frame, or 0 if it would not save minSaving bytes (send the payload as is).
+         */
+        std::size_t compress(std::span<const uint8_t> payload, std::span<uint8_t> out, Stats &stats) noexcept;
+
+        /**
+         * @brief Decompresses a frame written by compress().
+         * @return The size of the payload, or std::nullopt if the frame is corrupt, uses another dictionary or does not fit in out.
+         */
+        [[nodiscard]] std::optional<std::size_t> decompress(std::span<const uint8_t> frame, std::span<uint8_t> out) noexcept;
+
+        /**
+         * @brief Gets the dictionary shipped with the server (see SnapshotDictionary.cpp).
+         */
+        [[nodiscard]] static std::span<const uint8_t> dictionary() noexcept;
+
+        static constexpr uint32_t DICTIONARY_ID = 1;///< Bumped whenever the dictionary is retrained
+        static constexpr std::size_t DEFAULT_MIN_SAVING = 16;
+        static constexpr int DEFAULT_LEVEL = 3;
+
+    private:
+        struct Impl;
+
+        std::unique_ptr<Impl> _impl;
+        std::size_t _min_saving;
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/Components.hpp>
+#include <RTypeSrv/Snapshot.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace rtype::srv {
+
+/**
+ * @brief Per-client priority accumulators, choosing the changes a snapshot carries when they do not all fit its byte budget.
+ *
+ * Every tick, each entity whose state differs from the client's baseline gains priority:
+ * PLAYER_WEIGHT times more for players than for other entities, more the faster it moves
+ * and the closer it is to the client's player. The snapshot takes the changes of highest
+ * accumulated priority that fit the budget, and their accumulators restart from 0; the
+ * others keep growing until their turn comes.
+ *
+ * A change left out keeps the baseline's value in the state sent, so an entity the client
+ * does not see yet stays unseen, and a removed one stays until its removal is sent.
+ */
+class RTYPE_SRV_API PriorityAccumulator final
+{
+    public:
+        /**
+         * @brief The room for the entity state of one snapshot, and how it is encoded.
+         */
+        struct Budget {
+                std::size_t bytes;///< After the SEQ fields of the CMD_SNAPSHOT or CMD_DELTA
+                snapshot::Encoding encoding;
+                const SnapshotPrecision &precision;
+        };
+
+        /**
+         * @brief What the priorities are computed from, besides the states.
+         */
+        struct Scene {
+                std::span<const SnapshotEntity> previous;///< The game's state of the tick before, for speeds; empty if unknown
+                std::optional<uint32_t> focus;           ///< The entity of the client's player, if it has one
+                std::span<const PlayerEntity> players;   ///< The entities weighted as players
+        };
+
+        /**
+         * @brief Builds the state to send: the baseline, plus as many of the changes to target as fit, highest priority first.
+         *
+         * States are measured with the snapshot:: encoders: a delta against the
+         * baseline, or a keyframe if there is none.
+         *
+         * @param baseline The state the client holds, or nullptr if it must get a keyframe.
+         * @param target The state to reach, sorted by id.
+         * @param out Receives the state to send, sorted by id.
+         * @return The number of changes left out.
+         */
+        std::size_t schedule(const SnapshotHistory::Entry *baseline, std::span<const SnapshotEntity> target, const Scene &scene,
+            const Budget &budget, std::vector<SnapshotEntity> &out);
+
+        static constexpr float PLAYER_WEIGHT = 4.0f;
+        static constexpr float DISTANCE_SCALE = 256.0f;///< Distance at which the priority halves
+        static constexpr float SPEED_SCALE = 4.0f;     ///< Units per tick at which the priority doubles, a bit over a player's
+
+    private:
+        struct Change {
+                uint32_t id{0};
+                float priority{0.0f};
+                std::size_t rank{0};///< In decreasing priority
+        };
+
+        struct Accumulator {
+                uint32_t id{0};
+                float priority{0.0f};
+        };
+
+        [[nodiscard]] float _rate(const SnapshotEntity &entity, const Scene &scene, const SnapshotEntity *player) const noexcept;
+        [[nodiscard]] float _accumulated(uint32_t id) const noexcept;
+        void _build(std::span<const SnapshotEntity> baseline, std::span<const SnapshotEntity> target, std::size_t taken,
+            std::vector<SnapshotEntity> &out) const;
+        [[nodiscard]] bool _fits(const SnapshotHistory::Entry *baseline, std::span<const SnapshotEntity> state, const Budget &budget);
+
+        std::vector<Accumulator> _accumulators;///< Of the changes left out, sorted by id
+        std::vector<Change> _changes;          ///< Sorted by id, reused by schedule()
+        std::vector<std::size_t> _order;       ///< Indices in _changes by decreasing priority, reused by schedule()
+        std::vector<Accumulator> _next;        ///< Reused by schedule()
+        std::vector<uint8_t> _scratch;         ///< Encoded states, reused by _fits()
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
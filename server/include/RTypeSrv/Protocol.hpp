@@ -265,9 +265,9 @@ enum class CMD : std::uint8_t {
  * Connection Type: UDP
  *
  * @note Header structure: [MAGIC:2][VERSION:1][FLAGS:1][SEQ:4][ACKBASE:4][ACKBITS:1][CHANNEL:1][SIZE:2][ID:4][CMD:1][PAYLOAD:N]
- * Total header size: 21 bytes
+ * Total header size: 21 bytes (27 in VERSION 2)
  * - MAGIC: 0x4254 (big-endian uint16) - DIFFERENT from gateway protocol!
- * - VERSION: 0b1 (uint8)
+ * - VERSION: 1, 2 or 3 (uint8)
  * - FLAGS: Packet control flags (uint8, see FLAGS enum)
  * - SEQ: Sequence number unique to sender (big-endian uint32)
  * - ACKBASE: Sequence number of last received packet from peer (big-endian uint32)
@@ -276,22 +276,24 @@ enum class CMD : std::uint8_t {
  * - SIZE: Total packet size including header (big-endian uint16)
  * - ID: Client/player ID (big-endian uint32) - Only useful for CL->GS, sent by GS on connect
  * - CMD: Command identifier (uint8, see CMD enum)
- * - PAYLOAD: Variable length (SIZE - 21 bytes)
+ * - PAYLOAD: Variable length (SIZE - header size)
+ *
+ * VERSION 2 appends [ACKMASK:4][ORDER:2] to the header (see GSPcol::HeaderExtension):
+ * - ACKMASK: Selective ACK for 32 packets before ACKBASE (big-endian uint32); ACKBITS repeats its low 8 bits
+ * - ORDER: Position of an RO message among those of its sender, from 0 since CMD_JOIN (big-endian uint16), 0 otherwise
+ * VERSION 3 has the same header as VERSION 2; a peer speaking it also accepts CMD_BATCH.
  *
  * Maximum packet size: 1200 bytes (to respect MTU)
- * Maximum payload: 1200 - 21 = 1179 bytes
+ * Maximum payload: 1200 - 21 = 1179 bytes (1173 in VERSION 2)
  *
  * AckBits encoding example:
  * If ACKBASE = 1005 and we received all packets except 1002:
- * AckBits = 0b11110111 (bits represent packets 998-1004, LSB = 998)
- * - Bit 0 (LSB): packet 998 received
- * - Bit 1: packet 999 received
- * - Bit 2: packet 1000 received
+ * AckBits = 0b11111011 (bit i represents packet ACKBASE - 1 - i)
+ * - Bit 0 (LSB): packet 1004 received
+ * - Bit 1: packet 1003 received
+ * - Bit 2: packet 1002 NOT received
  * - Bit 3: packet 1001 received
- * - Bit 4: packet 1002 NOT received
- * - Bit 5: packet 1003 received
- * - Bit 6: packet 1004 received
- * - Bit 7 (MSB): (unused in this 8-bit window)
+ * - Bits 4-7: packets 1000 to 997 received
  */
 namespace GSPcol {
 
@@ -343,19 +345,25 @@ enum class CHANNEL : std::uint8_t {
  * Payload formats:
  * - CMD_INPUT: [TYPE:1][VALUE:1]... (multiple pairs, max 1179 bytes total)
  *   Do NOT use F_FRAGMENT for inputs - send multiple INPUT packets instead
- * - CMD_SNAPSHOT: [SEQ:4] (sequence number of state snapshot)
+ * - CMD_SNAPSHOT: [SEQ:4][COUNT:4]([ENTITY:4][X:4][Y:4])... (keyframe: the full state)
  * - CMD_CHAT: [LEN:2][MSG:1]... (LEN = message length, MSG = UTF-8 text)
  *   Can exceed 1200 bytes - use F_FRAGMENT flag for large messages
  * - CMD_PING: No payload
  * - CMD_PONG: No payload
- * - CMD_ACK: [SEQ:4]... (list of sequence numbers being acknowledged)
+ * - CMD_ACK: [SEQ:4]... (F_RELIABLE packets received that the ACKBASE / ACKBITS of the headers did not cover)
  * - CMD_JOIN: [ID:4][NONCE:1][VERSION:1] (client auth request to game server)
+ *   VERSION >= 2: the client takes quantized SNAPSHOT / DELTA state, see snapshot::writeQuantizedKeyframe()
  * - CMD_KICK: [MSG:1]... (kick reason text, max 1179 bytes)
  * - CMD_CHALLENGE: [TIMESTAMP:8][COOKIE:32] (40 bytes) — server → client stateless cookie challenge
  * - CMD_AUTH: [NONCE:1][COOKIE:32] (33 bytes) — client → server authentication response
  * - CMD_AUTH_OK: [ID:4][SESSION_KEY:32] (successful auth, 36 bytes)
  * - CMD_RESYNC: No payload (request full state)
- * - CMD_FRAGMENT: [SEQ:4][PAYLOAD:1]... (fragment sequence + fragment data)
+ * - CMD_FRAGMENT: [BASE_SEQ:4][TOTAL_SIZE:4][FRAGMENT_OFFSET:4][DATA:N] (slice of a whole packet, header included,
+ *   sent with the flags, channel and ORDER of that packet, see GameServerUDPPacketParser::appendMessage())
+ * - CMD_DELTA: [SEQ:4][BASE_SEQ:4][COUNT:2]([ENTITY:4][MASK:1][X:4]?[Y:4]?)... (state relative to the
+ *   acknowledged snapshot BASE_SEQ; MASK bit 0 = X follows, bit 1 = Y follows, bit 7 = entity removed)
+ * - CMD_BATCH: ([CMD:1][FLAGS:1][LEN:2][PAYLOAD:LEN])... (VERSION 3: messages of one channel sharing the header,
+ *   which is F_RELIABLE if they are; each is handled as the packet it would have been alone, in the order listed)
  */
 enum class CMD : std::uint8_t {
     INPUT           = 1,        ///< Player input (movement, shooting, etc.)
@@ -371,6 +379,8 @@ enum class CMD : std::uint8_t {
     AUTH_OK         = 11,       ///< Authentication successful (server -> client)
     RESYNC          = 12,       ///< Request full state resynchronization after desync
     FRAGMENT        = 13,       ///< Fragment of a larger message (use with F_FRAGMENT flag)
+    DELTA           = 14,       ///< Game state snapshot, delta against a snapshot the client acknowledged
+    BATCH           = 15,       ///< Several messages in one datagram (header VERSION 3)
 };
 
 /**
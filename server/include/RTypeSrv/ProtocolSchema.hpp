@@ -0,0 +1,106 @@
+/**
+ * @file ProtocolSchema.hpp
+ * @brief Wire layouts of the GWPcol and GSPcol packets.
+ *
+ * Each block is declared here once; the builders, the parsers and the handlers
+ * all go through these layouts, so a field added or resized in one place moves
+ * every offset on both sides. The command-level documentation stays in Protocol.hpp.
+ */
+
+#pragma once
+
+#include <RTypeSrv/Protocol.hpp>
+#include <RTypeSrv/Schema.hpp>
+#include <array>
+#include <cstdint>
+
+namespace rtype::srv {
+
+namespace GWPcol {
+
+namespace field {
+
+struct Magic : schema::Field<uint16_t> {};
+struct Version : schema::Field<uint8_t> {};
+struct Flags : schema::Field<uint8_t> {};
+struct Cmd : schema::Field<uint8_t> {};
+struct GameId : schema::Field<uint32_t> {};
+struct GameType : schema::Field<uint8_t> {};
+struct Ip : schema::Field<std::array<uint8_t, 16>> {};///< IPv6, or IPv4-mapped IPv6
+struct Port : schema::Field<uint16_t> {};
+struct Occupancy : schema::Field<uint8_t> {};
+struct Count : schema::Field<uint8_t> {};
+struct InnerCmd : schema::Field<uint8_t> {};///< Repeated command byte of the GW -> GS JOIN
+
+}// namespace field
+
+using Header = schema::Layout<field::Magic, field::Version, field::Flags, field::Cmd>;
+
+using JoinRequest = schema::Layout<field::GameId>;                                        ///< CL -> GW JOIN
+using JoinResponse = schema::Layout<field::GameId, field::Ip, field::Port>;               ///< GS -> GW -> CL JOIN
+using PlayerJoin = schema::Layout<field::InnerCmd, field::GameId, field::Ip, field::Port>;///< GW -> GS JOIN
+using Create = schema::Layout<field::GameType>;                                           ///< CL -> GW -> GS CREATE
+using GameEnd = schema::Layout<field::GameId>;                                            ///< GS -> GW GAME_END
+using GsRegistration = schema::Layout<field::Ip, field::Port>;                            ///< GS -> GW GS
+using OccupancyUpdate = schema::Layout<field::Occupancy>;                                 ///< GS -> GW OCCUPANCY
+using GidList = schema::Layout<field::Count>;                                             ///< GS -> GW GID, followed by Count GameId
+using GidEntry = schema::Layout<field::GameId>;                                           ///< One GAME_ID of the GID list
+
+static_assert(Header::size == 5);
+static_assert(JoinResponse::size == 4 + 16 + 2);
+
+}// namespace GWPcol
+
+namespace GSPcol {
+
+namespace field {
+
+struct Magic : schema::Field<uint16_t> {};
+struct Version : schema::Field<uint8_t> {};
+struct Flags : schema::Field<FLAGS> {};
+struct Seq : schema::Field<uint32_t> {};
+struct AckBase : schema::Field<uint32_t> {};
+struct AckBits : schema::Field<uint8_t> {};
+struct AckMask : schema::Field<uint32_t> {};///< VERSION 2: ACKBITS widened to 32 packets
+struct Order : schema::Field<uint16_t> {};  ///< VERSION 2: position among the sender's RO messages
+struct Channel : schema::Field<CHANNEL> {};
+struct Size : schema::Field<uint16_t> {};
+struct ClientId : schema::Field<uint32_t> {};
+struct Cmd : schema::Field<CMD> {};
+struct Nonce : schema::Field<uint8_t> {};
+struct ClientVersion : schema::Field<uint8_t> {};
+struct Timestamp : schema::Field<uint64_t> {};
+struct Cookie : schema::Field<std::array<uint8_t, 32>> {};
+struct SessionKey : schema::Field<std::array<uint8_t, 32>> {};
+struct SnapshotSeq : schema::Field<uint32_t> {};
+struct BaseSeq : schema::Field<uint32_t> {};
+struct TotalSize : schema::Field<uint32_t> {};
+struct FragmentOffset : schema::Field<uint32_t> {};
+struct InputType : schema::Field<uint8_t> {};
+struct Length : schema::Field<uint16_t> {};///< Payload length of a CMD_BATCH entry
+
+}// namespace field
+
+using Header = schema::Layout<field::Magic, field::Version, field::Flags, field::Seq, field::AckBase, field::AckBits, field::Channel,
+    field::Size, field::ClientId, field::Cmd>;
+using HeaderExtension = schema::Layout<field::AckMask, field::Order>;///< Follows Header from VERSION 2, before the payload
+
+using Join = schema::Layout<field::ClientId, field::Nonce, field::ClientVersion>;        ///< CL -> GS JOIN
+using Challenge = schema::Layout<field::Timestamp, field::Cookie>;                       ///< GS -> CL CHALLENGE
+using Auth = schema::Layout<field::Nonce, field::Cookie>;                                ///< CL -> GS AUTH
+using AuthOk = schema::Layout<field::ClientId, field::SessionKey>;                       ///< GS -> CL AUTH_OK
+using Snapshot = schema::Layout<field::SnapshotSeq>;                                     ///< GS -> CL SNAPSHOT, followed by the state
+using Delta = schema::Layout<field::SnapshotSeq, field::BaseSeq>;                       ///< GS -> CL DELTA, followed by the changes
+using Fragment = schema::Layout<field::BaseSeq, field::TotalSize, field::FragmentOffset>;///< Followed by the fragment data
+using Input = schema::Layout<field::InputType>;                                          ///< CL -> GS INPUT, then [TYPE:1][VALUE:1] pairs
+using AckEntry = schema::Layout<field::Seq>;                                             ///< One SEQ of a CMD_ACK list
+using BatchEntry = schema::Layout<field::Cmd, field::Flags, field::Length>;              ///< One message of a CMD_BATCH, then its payload
+
+static_assert(Header::size == 21);
+static_assert(HeaderExtension::size == 6);
+static_assert(BatchEntry::size == 4);
+static_assert(Challenge::size == 40 && Auth::size == 33 && AuthOk::size == 36);
+
+}// namespace GSPcol
+
+}// namespace rtype::srv
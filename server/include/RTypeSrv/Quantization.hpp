@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace rtype::srv {
+
+/**
+ * @brief Fixed-point encoding of a bounded float: [min, max] mapped onto `bits` bits.
+ *
+ * The step is (max - min) / (2^bits - 1); the default covers a 4096-unit playfield
+ * around the screen at 1/16 unit with 16 bits.
+ */
+struct Quantization {
+        float min{-1024.0f};
+        float max{3072.0f};
+        uint8_t bits{16};///< 1 to 24, the precision a float can round-trip
+
+        static constexpr uint8_t MAX_BITS = 24;
+
+        /**
+         * @brief Tells whether the bounds and width are usable.
+         */
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return bits >= 1 && bits <= MAX_BITS && min < max;
+        }
+
+        /**
+         * @brief Tells whether a value can be quantized, i.e. is finite and within the bounds.
+         */
+        [[nodiscard]] bool contains(const float value) const noexcept
+        {
+            return std::isfinite(value) && value >= min && value <= max;
+        }
+
+        /**
+         * @brief Gets the code of a value, rounded to the nearest step.
+         * @note The value must satisfy contains().
+         */
+        [[nodiscard]] uint32_t quantize(const float value) const noexcept
+        {
+            const double scaled = (static_cast<double>(value) - static_cast<double>(min)) / _range() * _steps();
+            return static_cast<uint32_t>(std::lround(scaled));
+        }
+
+        /**
+         * @brief Gets the value a code stands for.
+         */
+        [[nodiscard]] float dequantize(const uint32_t code) const noexcept
+        {
+            return static_cast<float>(static_cast<double>(min) + _range() * code / _steps());
+        }
+
+    private:
+        [[nodiscard]] double _range() const noexcept
+        {
+            return static_cast<double>(max) - static_cast<double>(min);
+        }
+        [[nodiscard]] double _steps() const noexcept
+        {
+            return static_cast<double>((1U << bits) - 1);
+        }
+};
+
+}// namespace rtype::srv
@@ -0,0 +1,161 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeNet/Interfaces.hpp>
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/Utils/NonCopyable.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sys/epoll.h>
+#endif
+
+namespace rtype::srv {
+
+/**
+ * @brief Readiness notification loop with an optional periodic timer.
+ *
+ * On Linux this is an epoll instance plus a timerfd, so the owning thread sleeps
+ * until a registered handle is ready or the timer deadline arrives. Other platforms
+ * fall back to poll() with a timeout computed from the next timer deadline.
+ *
+ * The reactor remembers the interest of every registered handle, so modify() only
+ * reaches the kernel when the interest actually changes.
+ */
+class RTYPE_SRV_API Reactor final : public utils::NonCopyable
+{
+    public:
+        /**
+         * @brief Interest flags passed to add() and modify().
+         */
+        enum Interest : uint32_t {
+            READ = 1 << 0, ///< Report when the handle is readable
+            WRITE = 1 << 1,///< Report when the handle is writable
+            EDGE = 1 << 2, ///< Edge-triggered: only report transitions (the handle is made non-blocking)
+        };
+
+        /**
+         * @brief Readiness flags reported in Event::ready.
+         */
+        enum Ready : uint32_t {
+            READABLE = 1 << 0,
+            WRITABLE = 1 << 1,
+            CLOSED = 1 << 2,///< Error, hang-up (the peer's side included) or invalid handle; data may still be buffered
+        };
+
+        /**
+         * @brief A ready handle returned by wait().
+         */
+        struct Event {
+                network::Handle handle{};
+                uint32_t ready{0};
+        };
+
+        /**
+         * @brief Loop timing counters: time spent sleeping in wait() versus time spent between waits.
+         */
+        struct Stats {
+                uint64_t iterations{0};
+                std::chrono::nanoseconds idle{0};
+                std::chrono::nanoseconds busy{0};
+        };
+
+        Reactor();
+        ~Reactor() noexcept;
+
+        /**
+         * @brief Registers a handle.
+         * @param handle The handle to watch.
+         * @param interest A combination of Interest flags.
+         * @throws std::runtime_error If the kernel rejects the registration.
+         */
+        void add(network::Handle handle, uint32_t interest);
+
+        /**
+         * @brief Changes the interest of a registered handle.
+         * @param handle The handle to update.
+         * @param interest The new combination of Interest flags.
+         */
+        void modify(network::Handle handle, uint32_t interest) noexcept;
+
+        /**
+         * @brief Unregisters a handle. Unknown handles are ignored.
+         * @param handle The handle to forget.
+         */
+        void remove(network::Handle handle) noexcept;
+
+        /**
+         * @brief Gets the current interest of a registered handle.
+         * @return The Interest flags, or 0 if the handle is not registered.
+         */
+        [[nodiscard]] uint32_t interest(network::Handle handle) const noexcept;
+
+        /**
+         * @brief Starts (or restarts) the periodic timer.
+         * @param period The timer period.
+         */
+        void armTimer(std::chrono::nanoseconds period);
+
+        /**
+         * @brief Gets the pseudo-handle reported in Event::handle when the timer expires.
+         */
+        [[nodiscard]] network::Handle timerHandle() const noexcept;
+
+        /**
+         * @brief Acknowledges a timer event.
+         * @return The number of periods elapsed since the last acknowledgement.
+         */
+        uint64_t consumeTimer() noexcept;
+
+        /**
+         * @brief Sleeps until at least one handle is ready, the timer expires or the timeout elapses.
+         * @param timeout The maximum time to sleep, negative to wait for the next event or timer tick.
+         * @return The ready handles; valid until the next call to wait().
+         */
+        std::span<const Event> wait(std::chrono::milliseconds timeout = std::chrono::milliseconds(-1));
+
+        /**
+         * @brief Gets the loop timing counters accumulated since the last resetStats().
+         */
+        [[nodiscard]] const Stats &stats() const noexcept;
+
+        /**
+         * @brief Resets the loop timing counters.
+         */
+        void resetStats() noexcept;
+
+        static constexpr std::size_t MAX_EVENTS = 256;
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        std::unordered_map<network::Handle, uint32_t> _interest;
+        std::vector<Event> _events;
+        Stats _stats{};
+        clock::time_point _last_wake{};
+        std::chrono::nanoseconds _period{0};
+#if defined(__linux__)
+        int _epfd = -1;
+        int _timerfd = -1;
+        std::vector<epoll_event> _kevents;
+#else
+        std::vector<network::PollFD> _pfds;
+        clock::time_point _deadline{};
+        uint64_t _expirations = 0;
+#endif
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
@@ -0,0 +1,252 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/GspHeaderView.hpp>
+#include <RTypeSrv/PacketPool.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace rtype::srv {
+
+/**
+ * @brief Sequencing, acknowledgement and retransmission of the GSPcol packets exchanged with one client.
+ *
+ * Outgoing, every packet takes the SEQ of header() and sent() records it in a window
+ * of WINDOW packets. The client acknowledges them with the ACKBASE / ACKBITS of its
+ * headers (32 bits from header VERSION 2, 8 before) and with CMD_ACK; the delay to the
+ * acknowledgement of a packet sent once is an RTT sample, from which the retransmission
+ * timeout follows (RFC 6298). An F_RELIABLE packet is sent again, same SEQ and same
+ * bytes, when its timeout expires, the timeout doubling each time, and once as soon as
+ * FAST_RETRANSMIT_THRESHOLD newer packets are acknowledged around it. It is given up
+ * after MAX_RETRANSMITS, or when the window needs its slot.
+ *
+ * Incoming, receive() keeps the client's last 32 SEQ for the acknowledgement fields of
+ * header(), and the reliable packets no header will cover for takeAcks(). order()
+ * holds the RO messages arriving ahead of their ORDER until the missing ones arrive, or
+ * ORDER_TIMEOUT passes.
+ */
+class RTYPE_SRV_API ReliableChannel final
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief What receive() made of a packet's SEQ.
+         */
+        enum class Receipt : uint8_t {
+            NEW,      ///< First copy
+            DUPLICATE,///< Already received
+            TOO_OLD,  ///< Older than the receive window, so unknown
+        };
+
+        /**
+         * @brief What order() made of a message.
+         */
+        enum class Delivery : uint8_t {
+            DELIVER,///< Dispatch it now
+            HELD,   ///< Copied; release() hands it out once the messages before it are delivered
+            STALE,  ///< Already delivered, or skipped; drop it
+        };
+
+        /**
+         * @brief Reliability counters, kept by the caller over all its channels.
+         */
+        struct Stats {
+                uint64_t sent{0};            ///< Packets sent, retransmissions excluded
+                uint64_t reliable{0};        ///< Of which F_RELIABLE
+                uint64_t acked{0};           ///< F_RELIABLE packets acknowledged
+                uint64_t retransmits{0};     ///< Retransmissions, fast ones included
+                uint64_t fast_retransmits{0};///< Retransmissions triggered by acknowledgements rather than the timeout
+                uint64_t given_up{0};        ///< F_RELIABLE packets never acknowledged
+                uint64_t duplicates{0};      ///< Packets received twice
+                uint64_t reordered{0};       ///< RO messages received ahead of their turn
+                uint64_t skipped{0};         ///< RO messages never delivered, their gap skipped
+                uint64_t lost{0};            ///< Packets inferred lost from the acknowledgements
+        };
+
+        /**
+         * @brief What the client's acknowledgements told of the path, counted since reset(), for CongestionController.
+         */
+        struct Feedback {
+                uint64_t acked{0};///< Packets acknowledged, reliable or not
+                uint64_t lost{0}; ///< Packets missing from an acknowledgement covering FAST_RETRANSMIT_THRESHOLD newer ones
+        };
+
+        /**
+         * @brief Forgets everything: the next packet sent is SEQ 0 and the next RO message expected ORDER 0.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Records a packet from the client and applies its acknowledgements.
+         *
+         * F_RELIABLE packets are queued for takeAcks() whatever the receipt, so a
+         * retransmission whose acknowledgement was lost is acknowledged again.
+         */
+        Receipt receive(const GspHeaderView &packet, Clock::time_point now, Stats &stats);
+
+        /**
+         * @brief Applies one sequence number of a CMD_ACK.
+         */
+        void acknowledge(uint32_t seq, Clock::time_point now, Stats &stats) noexcept;
+
+        /**
+         * @brief Gets the header fields of the next message: SEQ, acknowledgements, ORDER on RO, and the client's VERSION.
+         */
+        [[nodiscard]] GameServerUDPPacketParser::HeaderFields header(GSPcol::CHANNEL channel = GSPcol::CHANNEL::UU) const noexcept;
+
+        /**
+         * @brief Records the packets of a message built with header(), which must be sent now.
+         *
+         * The packets take the SEQ from header().seq on; F_RELIABLE ones are kept for
+         * retransmission.
+         */
+        void sent(std::span<const PacketBuffer> message, Clock::time_point now, Stats &stats);
+
+        /**
+         * @brief Records a path MTU probe built with header(), which must be sent now.
+         *
+         * As sent(), but the loss of a probe tells about its size, not congestion: it is
+         * not counted in Feedback::lost.
+         */
+        void probed(const PacketBuffer &probe, Clock::time_point now, Stats &stats);
+
+        /**
+         * @brief Appends the F_RELIABLE packets due for retransmission.
+         * @return The number of packets appended.
+         */
+        std::size_t retransmit(Clock::time_point now, std::vector<PacketBuffer> &out, Stats &stats);
+
+        /**
+         * @brief Moves out the reliable packets received that the headers sent since did not acknowledge.
+         * @param out Receives at most MAX_PENDING_ACKS sequence numbers, for a CMD_ACK.
+         */
+        void takeAcks(std::vector<uint32_t> &out);
+
+        /**
+         * @brief Passes a message through the ordering of the RO channel.
+         *
+         * Only RO messages from VERSION 2 on are ordered; others are always delivered. A
+         * fragmented message is ordered once reassembled, not by fragment.
+         */
+        Delivery order(const GspHeaderView &message, Clock::time_point now, Stats &stats);
+
+        /**
+         * @brief Hands out the next held RO message, if its turn has come.
+         *
+         * A gap left ORDER_TIMEOUT after the oldest message held is skipped, so a
+         * message the client gave up on does not stall the ones after it.
+         *
+         * @return The message, a whole packet, or std::nullopt if nothing can be delivered yet.
+         */
+        std::optional<std::vector<uint8_t>> release(Clock::time_point now, Stats &stats);
+
+        /**
+         * @brief Gets the current retransmission timeout.
+         */
+        [[nodiscard]] std::chrono::microseconds rto() const noexcept;
+
+        /**
+         * @brief Gets the smoothed round-trip time, or 0 before the first sample.
+         */
+        [[nodiscard]] std::chrono::microseconds srtt() const noexcept;
+
+        /**
+         * @brief Gets the number of F_RELIABLE packets waiting for an acknowledgement.
+         */
+        [[nodiscard]] std::size_t unacked() const noexcept;
+
+        /**
+         * @brief Gets the acknowledged and lost counters.
+         */
+        [[nodiscard]] const Feedback &feedback() const noexcept;
+
+        /**
+         * @brief Tells whether order() holds messages, for callers that poll release().
+         */
+        [[nodiscard]] bool holding() const noexcept;
+
+        /**
+         * @brief Gets when the last packet from the client was received, to expire silent clients.
+         */
+        [[nodiscard]] Clock::time_point lastReceived() const noexcept;
+
+        static constexpr std::size_t WINDOW = 256;              ///< Packets in flight remembered
+        static constexpr std::size_t ORDER_WINDOW = 32;         ///< RO messages held at most
+        static constexpr std::size_t MAX_PENDING_ACKS = GameServerUDPPacketParser::MAX_ACKS;
+        static constexpr unsigned FAST_RETRANSMIT_THRESHOLD = 3;///< Newer packets acknowledged around a hole
+        static constexpr unsigned MAX_RETRANSMITS = 8;
+        static constexpr std::chrono::microseconds INITIAL_RTO{std::chrono::milliseconds(250)};
+        static constexpr std::chrono::microseconds MIN_RTO{std::chrono::milliseconds(50)};
+        static constexpr std::chrono::microseconds MAX_RTO{std::chrono::seconds(2)};
+        static constexpr std::chrono::microseconds CLOCK_GRANULARITY{std::chrono::milliseconds(16)};///< One server tick
+        static constexpr auto ORDER_TIMEOUT = std::chrono::seconds(1);
+
+    private:
+        struct InFlight {
+                PacketBuffer packet;///< Kept until acknowledged if F_RELIABLE
+                Clock::time_point first_sent;
+                Clock::time_point deadline;
+                uint32_t seq{0};
+                uint8_t transmissions{0};
+                bool valid{false};
+                bool acked{false};
+                bool lost{false};        ///< Counted in Feedback::lost
+                bool fast_pending{false};///< Retransmit at the next retransmit() call
+                bool fast_done{false};   ///< Fast retransmitted already
+                bool probe{false};       ///< A path MTU probe, never counted lost
+        };
+
+        struct Held {
+                std::vector<uint8_t> message;
+                Clock::time_point since;
+                uint16_t order{0};
+                bool valid{false};
+        };
+
+        void _ack(uint32_t seq, Clock::time_point now, Stats &stats) noexcept;
+        void _acknowledge(uint32_t ackBase, uint32_t ackBits, unsigned width, Clock::time_point now, Stats &stats) noexcept;
+        Receipt _record(uint32_t seq) noexcept;
+        void _sampleRtt(std::chrono::microseconds rtt) noexcept;
+        void _release(InFlight &slot) noexcept;
+        [[nodiscard]] unsigned _ackWidth() const noexcept;
+
+        std::array<InFlight, WINDOW> _in_flight{};
+        std::size_t _unacked = 0;
+        uint32_t _next_seq = 0;
+        uint16_t _next_order = 0;
+        uint8_t _peer_version = GameServerUDPPacketParser::VERSION;
+        Feedback _feedback{};
+
+        bool _received = false;
+        Clock::time_point _last_received{};
+        uint32_t _recv_base = 0;///< Newest SEQ received
+        uint32_t _recv_bits = 0;///< Bit i set if _recv_base - 1 - i was received
+        std::vector<uint32_t> _pending_acks;
+
+        std::array<Held, ORDER_WINDOW> _held{};
+        std::size_t _held_count = 0;
+        uint16_t _expected_order = 0;
+
+        bool _rtt_sampled = false;
+        std::chrono::microseconds _srtt{0};
+        std::chrono::microseconds _rttvar{0};
+        std::chrono::microseconds _rto{INITIAL_RTO};
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeNet/Interfaces.hpp>
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/ProtocolSchema.hpp>
+#include <RTypeSrv/Utils/NonCopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtype::srv {
+
+/**
+ * @brief A set of UDP sockets bound to the same address with SO_REUSEPORT.
+ *
+ * The sockets are opened one after the other from the calling thread, so socket i
+ * is index i of the kernel reuseport group. A classic BPF program attached to the
+ * group reads the client ID (bytes 16-19 of the GSPcol header) and returns
+ * `clientId % size()`, which delivers every datagram of a client to the same socket.
+ *
+ * Game IDs created by worker i are congruent to i modulo size(), so a client whose
+ * ID has the same residue as its game ID always lands on the worker hosting it. A
+ * worker still rejects a CMD_JOIN whose ID is of another shard (see shardOf()), as
+ * the kernel steers by its own hash when the program's index is out of the group.
+ *
+ * The kernel compacts the group when a socket is closed, so the mapping only holds
+ * while every socket stays open; workers keep theirs until shutdown.
+ *
+ * Only supported on Linux.
+ */
+class RTYPE_SRV_API ReusePortGroup final : public utils::NonCopyable
+{
+    public:
+        /**
+         * @brief Opens and binds the sockets, then attaches the steering program.
+         * @param endpoint The address shared by every socket.
+         * @param nsockets The number of sockets (one per worker).
+         * @throws Exception If a socket cannot be opened or bound, or the platform lacks SO_REUSEPORT.
+         */
+        ReusePortGroup(const network::Endpoint &endpoint, std::size_t nsockets);
+        ~ReusePortGroup() noexcept;
+
+        /**
+         * @brief Hands a socket over to its worker, which becomes responsible for closing it.
+         * @param index The index of the socket in the group.
+         * @return The bound socket.
+         */
+        [[nodiscard]] network::Socket release(std::size_t index);
+
+        /**
+         * @brief Gets the number of sockets in the group.
+         */
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /**
+         * @brief Gets the index of the worker that receives a client's datagrams.
+         * @param clientId The client ID carried in the GSPcol header.
+         * @param nsockets The number of sockets in the group.
+         */
+        [[nodiscard]] static constexpr std::size_t shardOf(const uint32_t clientId, const std::size_t nsockets) noexcept
+        {
+            return nsockets == 0 ? 0 : clientId % nsockets;
+        }
+
+        static constexpr auto CLIENT_ID_OFFSET =
+            static_cast<uint32_t>(GSPcol::Header::offset<GSPcol::field::ClientId>);///< Offset of the ID field in the GSPcol header.
+
+    private:
+        std::vector<network::Socket> _sockets;
+        std::vector<bool> _released;
+};
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
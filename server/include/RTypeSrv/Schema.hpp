@@ -0,0 +1,233 @@
+#pragma once
+
+#include <RTypeSrv/PacketWriter.hpp>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Compile-time packet layouts.
+ *
+ * A packet block is declared once as an ordered list of field tags:
+ * @code
+ * struct GameId : schema::Field<uint32_t> {};
+ * struct Port : schema::Field<uint16_t> {};
+ * using JoinResponse = schema::Layout<GameId, Port>;
+ * @endcode
+ * and the layout provides everything derived from that list, with every offset
+ * and the total size being constants:
+ * - JoinResponse::size and JoinResponse::offset<Port>;
+ * - JoinResponse::read(data, offset, bufsize) or read(span, offset): one size check, then a zero-copy View;
+ * - view.get<GameId>(): a single load at a constant offset, decoded from big-endian;
+ * - JoinResponse::write(out, id, port): one bounds check, then stores at constant offsets.
+ *
+ * Variable-length tails (snapshot state, GID lists, ...) follow the fixed block
+ * and are read or written by the caller after it.
+ */
+namespace rtype::srv::schema {
+
+namespace detail {
+
+template<typename T>
+struct Wire {
+        using type = T;
+};
+
+template<typename T>
+    requires std::is_enum_v<T>
+struct Wire<T> {
+        using type = std::underlying_type_t<T>;
+};
+
+}// namespace detail
+
+/**
+ * @brief Big-endian encoding of a field type; specialized for unsigned integers, enums and byte arrays.
+ */
+template<typename T>
+struct Codec;
+
+template<typename T>
+    requires std::unsigned_integral<typename detail::Wire<T>::type>
+struct Codec<T> {
+        using wire_type = typename detail::Wire<T>::type;
+        using value_type = T;
+        using arg_type = T;
+
+        static constexpr std::size_t size = sizeof(wire_type);
+
+        [[nodiscard]] static value_type load(const uint8_t *at) noexcept
+        {
+            wire_type value{};
+            std::memcpy(&value, at, size);
+            if constexpr (size > 1 && std::endian::native == std::endian::little) {
+                value = std::byteswap(value);
+            }
+            return static_cast<value_type>(value);
+        }
+
+        static void store(uint8_t *at, const arg_type value) noexcept
+        {
+            auto wire = static_cast<wire_type>(value);
+            if constexpr (size > 1 && std::endian::native == std::endian::little) {
+                wire = std::byteswap(wire);
+            }
+            std::memcpy(at, &wire, size);
+        }
+};
+
+/**
+ * @brief Fixed-size byte strings (addresses, keys, cookies) are viewed in place, never copied on read.
+ */
+template<std::size_t N>
+struct Codec<std::array<uint8_t, N>> {
+        using value_type = std::span<const uint8_t, N>;
+        using arg_type = std::span<const uint8_t, N>;
+
+        static constexpr std::size_t size = N;
+
+        [[nodiscard]] static value_type load(const uint8_t *at) noexcept
+        {
+            return value_type(at, N);
+        }
+
+        static void store(uint8_t *at, const arg_type value) noexcept
+        {
+            std::memcpy(at, value.data(), N);
+        }
+};
+
+/**
+ * @brief Base of a field tag; the tag type names the field, T gives its wire type.
+ */
+template<typename T>
+struct Field {
+        using codec = Codec<T>;
+
+        static constexpr std::size_t size = codec::size;
+};
+
+/**
+ * @brief An ordered block of fields with constant offsets.
+ */
+template<typename... Fields>
+class Layout final
+{
+    private:
+        static constexpr std::array<std::size_t, sizeof...(Fields) + 1> OFFSETS = [] {
+            std::array<std::size_t, sizeof...(Fields) + 1> offsets{};
+            constexpr std::array<std::size_t, sizeof...(Fields)> sizes{Fields::size...};
+            for (std::size_t i = 0; i < sizes.size(); ++i) {
+                offsets[i + 1] = offsets[i] + sizes[i];
+            }
+            return offsets;
+        }();
+
+        template<typename F>
+        static consteval std::size_t _indexOf()
+        {
+            constexpr std::array<bool, sizeof...(Fields)> matches{std::is_same_v<F, Fields>...};
+            std::size_t count = 0;
+            std::size_t index = 0;
+            for (std::size_t i = 0; i < matches.size(); ++i) {
+                if (matches[i]) {
+                    ++count;
+                    index = i;
+                }
+            }
+            if (count != 1) {
+                throw "schema: the field must appear exactly once in the layout";
+            }
+            return index;
+        }
+
+    public:
+        static constexpr std::size_t size = OFFSETS.back();
+
+        template<typename F>
+        static constexpr std::size_t offset = OFFSETS[_indexOf<F>()];
+
+        /**
+         * @brief Zero-copy typed view over a block that is known to be complete.
+         */
+        class View final
+        {
+            public:
+                explicit View(const uint8_t *data) noexcept : _data(data)
+                {
+                }
+
+                template<typename F>
+                [[nodiscard]] typename F::codec::value_type get() const noexcept
+                {
+                    return F::codec::load(_data + offset<F>);
+                }
+
+                [[nodiscard]] std::span<const uint8_t, size> bytes() const noexcept
+                {
+                    return std::span<const uint8_t, size>(_data, size);
+                }
+
+            private:
+                const uint8_t *_data;
+        };
+
+        /**
+         * @brief Tells whether a complete block starts at pos.
+         */
+        [[nodiscard]] static constexpr bool fits(const std::size_t pos, const std::size_t bufsize) noexcept
+        {
+            return pos <= bufsize && bufsize - pos >= size;
+        }
+
+        /**
+         * @brief Views a block without checking its size; the caller guarantees size bytes.
+         */
+        [[nodiscard]] static View at(const uint8_t *data) noexcept
+        {
+            return View(data);
+        }
+
+        /**
+         * @brief Views the block at pos and advances pos past it.
+         * @return The view, or std::nullopt (pos untouched) if the buffer is too short.
+         */
+        [[nodiscard]] static std::optional<View> read(const uint8_t *data, std::size_t &pos, const std::size_t bufsize) noexcept
+        {
+            if (!fits(pos, bufsize)) {
+                return std::nullopt;
+            }
+            const View view(data + pos);
+            pos += size;
+            return view;
+        }
+
+        /**
+         * @brief Views the block at pos within bytes and advances pos past it.
+         */
+        [[nodiscard]] static std::optional<View> read(const std::span<const uint8_t> bytes, std::size_t &pos) noexcept
+        {
+            return read(bytes.data(), pos, bytes.size());
+        }
+
+        /**
+         * @brief Serializes the block, one value per field in declaration order.
+         * @throws std::length_error If fewer than size bytes remain in the writer.
+         */
+        static void write(PacketWriter &out, const typename Fields::codec::arg_type... values)
+        {
+            uint8_t *at = out.claim(size).data();
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (Fields::codec::store(at + OFFSETS[I], values), ...);
+            }(std::index_sequence_for<Fields...>{});
+        }
+};
+
+}// namespace rtype::srv::schema
@@ -0,0 +1,222 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #pragma warning(push)
+    #pragma warning(disable : 4251)
+#endif
+
+#include <RTypeSrv/Api.hpp>
+#include <RTypeSrv/BitStream.hpp>
+#include <RTypeSrv/Components.hpp>
+#include <RTypeSrv/PacketWriter.hpp>
+#include <RTypeSrv/Quantization.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace rtype::srv {
+
+/**
+ * @brief The last snapshots of one game, kept as baselines for delta encoding.
+ *
+ * Entries are stored by sequence number modulo CAPACITY, so a snapshot older than
+ * CAPACITY ticks is gone and a client acknowledging it gets a keyframe instead.
+ * The entity vectors of evicted entries are reused, so the steady state does not allocate.
+ */
+class RTYPE_SRV_API SnapshotHistory final
+{
+    public:
+        struct Entry {
+                uint32_t seq{0};
+                bool valid{false};
+                std::vector<SnapshotEntity> entities;///< Sorted by id
+        };
+
+        /**
+         * @brief Records a snapshot, evicting the one CAPACITY ticks older.
+         * @param entities The state, sorted by entity id.
+         */
+        void push(uint32_t seq, std::span<const SnapshotEntity> entities);
+
+        /**
+         * @brief Gets a snapshot by sequence number.
+         * @return The entry, or nullptr if it was never recorded or has been evicted.
+         */
+        [[nodiscard]] const Entry *find(uint32_t seq) const noexcept;
+
+        /**
+         * @brief Gets the most recent snapshot, or nullptr if none was recorded.
+         */
+        [[nodiscard]] const Entry *latest() const noexcept;
+
+        static constexpr std::size_t CAPACITY = 32;///< About half a second at the simulation rate
+
+    private:
+        std::array<Entry, CAPACITY> _entries{};
+        const Entry *_latest = nullptr;
+};
+
+/**
+ * @brief Tracks which snapshot each server packet sent to a client carried, and which of them the client acknowledged.
+ *
+ * Every GSPcol packet from the client reports the last server sequence it received
+ * (ACKBASE) and the 8 before it (ACKBITS), or 32 from header VERSION 2 (ACKMASK); the
+ * newest snapshot among those becomes the client's baseline.
+ */
+class RTYPE_SRV_API SnapshotAcks final
+{
+    public:
+        /**
+         * @brief Records that server packets carried a snapshot.
+         *
+         * A snapshot fragmented over several packets becomes a baseline only once every
+         * fragment is acknowledged; one longer than WINDOW packets never does.
+         *
+         * @param packetSeq The sequence number of the first packet.
+         * @param parts The number of packets, packetSeq to packetSeq + parts - 1.
+         */
+        void sent(uint32_t packetSeq, uint32_t snapshotSeq, std::size_t parts = 1) noexcept;
+
+        /**
+         * @brief Applies the acknowledgements of a received packet header.
+         * @param width The number of bits of ackBits in use, see GspHeaderView::ackWidth().
+         */
+        void acknowledge(uint32_t ackBase, uint32_t ackBits, unsigned width = 8) noexcept;
+
+        /**
+         * @brief Gets the newest snapshot the client is known to have, or std::nullopt before the first acknowledgement.
+         */
+        [[nodiscard]] std::optional<uint32_t> baseline() const noexcept;
+
+        /**
+         * @brief Forgets the baseline, so the next snapshot is a keyframe.
+         */
+        void reset() noexcept;
+
+        static constexpr std::size_t WINDOW = 64;///< Server packets remembered
+
+    private:
+        struct Slot {
+                uint32_t packet_seq{0};
+                uint32_t snapshot_seq{0};
+                uint32_t first_seq{0};///< First packet of the snapshot
+                uint8_t parts{1};     ///< Packets carrying the snapshot
+                bool valid{false};
+                bool acked{false};
+        };
+
+        void _ack(uint32_t packetSeq) noexcept;
+
+        std::array<Slot, WINDOW> _slots{};
+        std::optional<uint32_t> _baseline;
+};
+
+/**
+ * @brief Precision of each entity field in quantized snapshots.
+ */
+struct SnapshotPrecision {
+        Quantization x{};
+        Quantization y{};
+};
+
+namespace snapshot {
+
+/**
+ * @brief How the entity state of SNAPSHOT and DELTA payloads is encoded for a client.
+ */
+enum class Encoding : uint8_t {
+    FLOAT,    ///< Byte-aligned, 32-bit floats: writeKeyframe() / writeDelta()
+    QUANTIZED,///< Bit-packed fixed point: writeQuantizedKeyframe() / writeQuantizedDelta()
+};
+
+inline constexpr unsigned ID_GROUP_BITS = 4;///< Consecutive ids cost 5 bits
+
+/**
+ * @brief Gets the size of the keyframe state of n entities.
+ */
+[[nodiscard]] constexpr std::size_t keyframeSize(const std::size_t n) noexcept
+{
+    return 4 + n * 12;
+}
+
+/**
+ * @brief Gets an upper bound of the quantized keyframe state of n entities: every id full width, every entity raw.
+ */
+[[nodiscard]] constexpr std::size_t quantizedKeyframeMaxSize(const std::size_t n) noexcept
+{
+    return 2 + (n * (BitWriter::varintSize(UINT32_MAX, ID_GROUP_BITS) + 1 + 64) + 7) / 8;
+}
+
+/**
+ * @brief Writes the full state: [COUNT:4]([ENTITY:4][X:4][Y:4])...
+ * @throws std::length_error If it does not fit in the writer.
+ */
+RTYPE_SRV_API void writeKeyframe(PacketWriter &out, std::span<const SnapshotEntity> entities);
+
+/**
+ * @brief Writes the changes from baseline to current: [COUNT:2]([ENTITY:4][MASK:1][X:4]?[Y:4]?)...
+ *
+ * Entities new since the baseline are sent with every field, removed ones with the
+ * REMOVED bit only, and unchanged ones are not sent. Fields are compared bitwise.
+ *
+ * @param baseline The state the client has, sorted by entity id.
+ * @param current The state to reach, sorted by entity id.
+ * @return false if the delta does not fit in the writer; the caller should send a keyframe then.
+ */
+[[nodiscard]] RTYPE_SRV_API bool writeDelta(PacketWriter &out, std::span<const SnapshotEntity> baseline,
+    std::span<const SnapshotEntity> current);
+
+/**
+ * @brief Writes the full state bit-packed: [COUNT:2] then, per entity, the bit fields
+ * [ID:varint][RAW:1][X][Y], padded to a byte.
+ *
+ * ID is the difference with the previous entity's id (the first is sent as is), as a
+ * varint of ID_GROUP_BITS groups. X and Y take the bits of their Quantization, or 32
+ * bits each, as floats, if RAW is set because one of them is out of bounds.
+ *
+ * @throws std::length_error If it does not fit in the writer.
+ */
+RTYPE_SRV_API void writeQuantizedKeyframe(PacketWriter &out, std::span<const SnapshotEntity> entities,
+    const SnapshotPrecision &precision);
+
+/**
+ * @brief Writes the changes from baseline to current bit-packed: [COUNT:2] then, per changed
+ * entity, [ID:varint][REMOVED:1] and, unless removed, [HAS_X:1][HAS_Y:1][RAW:1][X]?[Y]?.
+ *
+ * Fields are compared after quantization, so a move below the precision is not sent.
+ *
+ * @return false if the delta does not fit in the writer; the caller should send a keyframe then.
+ */
+[[nodiscard]] RTYPE_SRV_API bool writeQuantizedDelta(PacketWriter &out, std::span<const SnapshotEntity> baseline,
+    std::span<const SnapshotEntity> current, const SnapshotPrecision &precision);
+
+/**
+ * @brief Decodes a state written by writeQuantizedKeyframe().
+ * @param out Receives the entities, sorted by id.
+ * @return false if the state is truncated or malformed.
+ */
+[[nodiscard]] RTYPE_SRV_API bool readQuantizedKeyframe(std::span<const uint8_t> in, const SnapshotPrecision &precision,
+    std::vector<SnapshotEntity> &out);
+
+/**
+ * @brief Applies a delta written by writeQuantizedDelta() to the baseline it was computed against.
+ * @param out Receives the new state, sorted by id.
+ * @return false if the delta is truncated or malformed.
+ */
+[[nodiscard]] RTYPE_SRV_API bool readQuantizedDelta(std::span<const uint8_t> in, const SnapshotPrecision &precision,
+    std::span<const SnapshotEntity> baseline, std::vector<SnapshotEntity> &out);
+
+inline constexpr uint8_t FIELD_X = 1 << 0;
+inline constexpr uint8_t FIELD_Y = 1 << 1;
+inline constexpr uint8_t REMOVED = 1 << 7;
+
+}// namespace snapshot
+
+}// namespace rtype::srv
+
+#if defined(_MSC_VER)
+    #pragma warning(pop)
+#endif
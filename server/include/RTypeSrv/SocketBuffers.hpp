@@ -0,0 +1,40 @@
+#pragma once
+
+#include <RTypeNet/Interfaces.hpp>
+#include <RTypeSrv/Api.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace rtype::srv {
+
+/**
+ * @brief Kernel buffer sizes of a socket, in bytes; 0 keeps the kernel default.
+ */
+struct SocketBuffers {
+        std::size_t rcv{0};
+        std::size_t snd{0};
+};
+
+/**
+ * @brief Send-side pressure counters of a stream socket, reported with the periodic stats.
+ */
+struct StreamSendStats {
+        uint64_t would_block{0};///< send() calls that found the kernel buffer full (EAGAIN)
+        uint64_t partial{0};    ///< send() calls that took only part of the bytes
+        uint64_t errors{0};     ///< send() calls that failed with another error
+};
+
+/**
+ * @brief Applies buffer sizes to a socket.
+ *
+ * On Linux SO_RCVBUFFORCE / SO_SNDBUFFORCE are tried first so a process with
+ * CAP_NET_ADMIN is not capped by net.core.rmem_max / wmem_max; otherwise the kernel
+ * silently clamps the request, which is why the effective sizes are read back.
+ *
+ * @param handle The socket. For a listening TCP socket the sizes are inherited by accepted connections.
+ * @param requested The sizes to set; 0 leaves a direction untouched.
+ * @return The sizes the kernel reports afterwards (Linux doubles the request to account for bookkeeping).
+ */
+RTYPE_SRV_API SocketBuffers applySocketBuffers(network::Handle handle, const SocketBuffers &requested) noexcept;
+
+}// namespace rtype::srv
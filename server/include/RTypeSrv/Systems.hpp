@@ -2,9 +2,9 @@
 #include "Components.hpp"
 #include "GameEvents.hpp"
 #include <R-Engine/Application.hpp>
+#include <algorithm>
 #include <cstdint>
 #include <vector>
-#include <cstring>
 #include <iostream>
 #include <iomanip>
 
@@ -77,20 +77,6 @@ inline void movement_system(
     }
 }
 
-template<typename T>
-void write_big_endian(uint8_t*& ptr, T value) {
-    for (int i = sizeof(T) - 1; i >= 0; --i) {
-        *ptr++ = (value >> (i * 8)) & 0xFF;
-    }
-}
-
-inline void write_big_endian(uint8_t*& ptr, float value) {
-    uint32_t as_int;
-    std::memcpy(&as_int, &value, sizeof(float));
-    write_big_endian(ptr, as_int);
-}
-
-
 inline void create_snapshot_system(
     r::ecs::Commands& commands,
     r::ecs::ResMut<SnapshotSequence> snapshot_seq,
@@ -98,38 +84,19 @@ inline void create_snapshot_system(
 ) {
     snapshot_seq.ptr->sequence_number++;
 
-    uint32_t entity_count = 0;
-    for (auto [position, player] : query) {
-        if (player.ptr->clientId != 0) {
-            entity_count++;
-        }
-    }
-
-    if (entity_count == 0) {
-        commands.insert_resource(GameStateSnapshot{});
-        return;
-    }
-
-    size_t payload_size = sizeof(uint32_t) + (entity_count * (sizeof(uint32_t) + sizeof(float) * 2));
-    std::vector<uint8_t> snapshot_data(payload_size);
-    uint8_t* ptr = snapshot_data.data();
-
-    write_big_endian(ptr, entity_count);
-
+    std::vector<SnapshotEntity> entities;
+    std::vector<PlayerEntity> players;
     for (auto it = query.begin(); it != query.end(); ++it) {
         auto [position, player] = *it;
         if (player.ptr->clientId == 0) continue;
 
         r::ecs::Entity entity_id = static_cast<uint32_t>(it.entity());
-        float x = position.ptr->value.x;
-        float y = position.ptr->value.y;
-
-        write_big_endian(ptr, entity_id);
-        write_big_endian(ptr, x);
-        write_big_endian(ptr, y);
+        entities.push_back({entity_id, position.ptr->value.x, position.ptr->value.y});
+        players.push_back({player.ptr->clientId, entity_id});
     }
-    
-    commands.insert_resource(GameStateSnapshot{std::move(snapshot_data)});
+    std::sort(entities.begin(), entities.end(), [](const SnapshotEntity& a, const SnapshotEntity& b) { return a.id < b.id; });
+
+    commands.insert_resource(GameStateSnapshot{std::move(entities), std::move(players)});
 }
 
 inline void assign_player_slot_system(
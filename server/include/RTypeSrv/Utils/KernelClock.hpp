@@ -0,0 +1,25 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+
+namespace rtype::srv::utils {
+
+/**
+ * @brief Gets the offset that moves a CLOCK_REALTIME time onto the steady clock.
+ *
+ * Kernel packet timestamps (SO_TIMESTAMPNS, SO_TIMESTAMPING) are wall-clock times.
+ * Sample the offset once per batch rather than caching it: the wall clock may be stepped.
+ */
+std::chrono::nanoseconds realtimeOffset() noexcept;
+
+/**
+ * @brief Converts a kernel packet timestamp to the steady clock.
+ *
+ * @param ts The timestamp carried by the control message.
+ * @param offset The value returned by realtimeOffset().
+ * @return The matching steady clock time.
+ */
+std::chrono::steady_clock::time_point fromKernelTime(const timespec &ts, std::chrono::nanoseconds offset) noexcept;
+
+}// namespace rtype::srv::utils
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <RTypeNet/Interfaces.hpp>
+
+#if !defined(_WIN32)
+    #include <sys/socket.h>
+
+namespace rtype::srv::utils {
+
+/**
+ * @brief Converts a kernel socket address into an endpoint (IPv4 is stored IPv4-mapped).
+ *
+ * @param addr The address filled by the kernel.
+ * @return The matching endpoint, zeroed for unknown families.
+ */
+network::Endpoint fromSockaddr(const sockaddr_storage &addr) noexcept;
+
+/**
+ * @brief Converts an endpoint into a kernel socket address of the given family.
+ *
+ * @param endpoint The endpoint (IPv4 is stored IPv4-mapped).
+ * @param family AF_INET or AF_INET6, usually the family of the socket used.
+ * @param addr The address to fill.
+ * @return The length of the filled address.
+ */
+socklen_t toSockaddr(const network::Endpoint &endpoint, int family, sockaddr_storage &addr) noexcept;
+
+/**
+ * @brief Gets the address family of a bound socket.
+ *
+ * @param handle The socket.
+ * @return AF_INET or AF_INET6 (the latter if the socket cannot be queried).
+ */
+int socketFamily(network::Handle handle) noexcept;
+
+}// namespace rtype::srv::utils
+
+#endif
@@ -0,0 +1,95 @@
+#include <RTypeSrv/Congestion.hpp>
+#include <algorithm>
+
+void rtype::srv::CongestionController::update(const ReliableChannel &channel, const std::chrono::microseconds fallbackRtt,
+    const Clock::time_point now, const std::size_t maxRate, Stats &stats) noexcept
+{
+    _refill(now);
+    const ReliableChannel::Feedback &feedback = channel.feedback();
+    const uint64_t acked = feedback.acked - _acked;
+    const uint64_t lost = feedback.lost - _lost;
+    _acked = feedback.acked;
+    _lost = feedback.lost;
+    if (acked > 0) {
+        _awaiting = false;
+    }
+
+    _rtt = channel.srtt().count() > 0 ? channel.srtt() : fallbackRtt;
+    if (_rtt.count() > 0 && (_min_rtt.count() == 0 || _rtt < _min_rtt || now - _min_rtt_since > MIN_RTT_LIFETIME)) {
+        _min_rtt = _rtt;
+        _min_rtt_since = now;
+    }
+    const std::chrono::microseconds rtt = _rtt.count() > 0 ? _rtt : INITIAL_RTT;
+    const bool may_cut = now - _cut >= rtt;
+
+    if (lost > 0 && may_cut) {
+        _rate *= LOSS_BACKOFF;
+        _cut = now;
+        ++stats.losses;
+    } else if (_rtt.count() > 0 && _rtt > _min_rtt * 3 / 2 + DELAY_MARGIN && may_cut) {
+        _rate *= DELAY_BACKOFF;
+        _cut = now;
+        ++stats.delays;
+    } else if (_awaiting && now - _progress >= ACK_TIMEOUT) {
+        _rate /= 2;
+        _cut = now;
+        _progress = now;
+        ++stats.timeouts;
+    } else if (_limited && lost == 0) {
+        // One segment more per RTT in the window, which is the rate times the RTT.
+        const auto since = std::chrono::duration_cast<std::chrono::microseconds>(now - _updated);
+        const double elapsed = std::chrono::duration<double>((std::min) (since, rtt)).count();
+        const double seconds = std::chrono::duration<double>(rtt).count();
+        _rate += static_cast<double>(SEGMENT) * elapsed / (seconds * seconds);
+    }
+    _rate = std::clamp(_rate, static_cast<double>(MIN_RATE), static_cast<double>((std::max) (maxRate, MIN_RATE)));
+    _tokens = (std::min) (_tokens, _depth());
+    _limited = false;
+    _updated = now;
+}
+
+bool rtype::srv::CongestionController::consume(const std::size_t bytes, const Clock::time_point now) noexcept
+{
+    _refill(now);
+    if (_tokens <= 0.0) {
+        _limited = true;
+        return false;
+    }
+    _tokens -= static_cast<double>(bytes);
+    if (_tokens <= 0.0) {
+        _limited = true;
+    }
+    if (!_awaiting) {
+        _awaiting = true;
+        _progress = now;
+    }
+    return true;
+}
+
+std::size_t rtype::srv::CongestionController::allowance(const std::chrono::microseconds interval) const noexcept
+{
+    return static_cast<std::size_t>(_rate * std::chrono::duration<double>(interval).count());
+}
+
+std::size_t rtype::srv::CongestionController::rate() const noexcept
+{
+    return static_cast<std::size_t>(_rate);
+}
+
+std::size_t rtype::srv::CongestionController::window() const noexcept
+{
+    return allowance(_rtt.count() > 0 ? _rtt : INITIAL_RTT);
+}
+
+void rtype::srv::CongestionController::_refill(const Clock::time_point now) noexcept
+{
+    // The first call finds the bucket full: _refilled is the clock's epoch.
+    const double elapsed = std::chrono::duration<double>(now - _refilled).count();
+    _tokens = (std::min) (_depth(), _tokens + _rate * elapsed);
+    _refilled = now;
+}
+
+double rtype::srv::CongestionController::_depth() const noexcept
+{
+    return (std::max) (2.0 * static_cast<double>(SEGMENT), _rate * std::chrono::duration<double>(BURST).count());
+}
@@ -0,0 +1,353 @@
+#include <RTypeNet/Send.hpp>
+#include <RTypeSrv/DatagramQueue.hpp>
+#include <RTypeSrv/Utils/Logger.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iterator>
+
+#if defined(__linux__)
+    #include <RTypeSrv/Utils/KernelClock.hpp>
+    #include <RTypeSrv/Utils/SockAddr.hpp>
+    #include <linux/errqueue.h>
+    #include <linux/net_tstamp.h>
+    #include <netinet/in.h>
+    #include <netinet/udp.h>
+#endif
+
+namespace {
+
+void logSendError(const int err)
+{
+#if defined(_WIN32)
+    char error_buf[256];
+    strerror_s(error_buf, sizeof(error_buf), err);
+    rtype::srv::utils::cerr("Could not send packet: ", error_buf, " (errno=", err, ")");
+#else
+    rtype::srv::utils::cerr("Could not send packet: ", std::strerror(err), " (errno=", err, ")");
+#endif
+}
+
+}// namespace
+
+void rtype::srv::DatagramQueue::push(const network::Endpoint &endpoint, PacketBuffer data)
+{
+    _entries.push_back(Entry{endpoint, std::move(data)});
+}
+
+void rtype::srv::DatagramQueue::pushStamped(const network::Endpoint &endpoint, PacketBuffer data)
+{
+    _entries.push_back(Entry{endpoint, std::move(data), true});
+}
+
+bool rtype::srv::DatagramQueue::enableSendTimestamps(const network::Handle handle)
+{
+#if defined(__linux__)
+    // Only datagrams that ask for it (SO_TIMESTAMPING control message) are stamped; OPT_ID numbers
+    // them in send order and OPT_TSONLY keeps the payload off the error queue.
+    constexpr uint32_t flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+    if (::setsockopt(handle, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == -1) {
+        return false;
+    }
+    _tx_stamps = true;
+    _next_key = 0;
+    _in_flight.clear();
+    return true;
+#else
+    (void) handle;
+    return false;
+#endif
+}
+
+/**
+ * @brief Reports the send time of a stamped datagram and waits for its kernel timestamp if enabled.
+ *
+ * @param entry The datagram just accepted by the kernel.
+ * @param sent The time the send call returned.
+ */
+void rtype::srv::DatagramQueue::_recordSend(const Entry &entry, const std::chrono::steady_clock::time_point sent)
+{
+    if (!entry.stamped) {
+        return;
+    }
+    _stamps.push_back(SendStamp{entry.endpoint, sent, false});
+    if (_tx_stamps) {
+        if (_in_flight.size() >= MAX_STAMPS_IN_FLIGHT) {
+            _in_flight.pop_front();
+        }
+        _in_flight.push_back(InFlight{_next_key++, entry.endpoint, sent});
+    }
+}
+
+std::size_t rtype::srv::DatagramQueue::reapTimestamps(const network::Handle handle)
+{
+    std::size_t reaped = 0;
+#if defined(__linux__)
+    const auto offset = utils::realtimeOffset();
+
+    for (;;) {
+        union {
+                cmsghdr align;
+                char buf[CMSG_SPACE(sizeof(scm_timestamping)) + CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+        } ctrl{};
+        msghdr msg{};
+        msg.msg_control = ctrl.buf;
+        msg.msg_controllen = sizeof(ctrl.buf);
+        if (::recvmsg(handle, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+        const scm_timestamping *stamp = nullptr;
+        sock_extended_err err{};
+        bool is_stamp = false;
+        for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPING) {
+                stamp = reinterpret_cast<const scm_timestamping *>(CMSG_DATA(c));
+            } else if ((c->cmsg_level == SOL_IP && c->cmsg_type == IP_RECVERR)
+                || (c->cmsg_level == SOL_IPV6 && c->cmsg_type == IPV6_RECVERR)) {
+                std::memcpy(&err, CMSG_DATA(c), sizeof(err));
+                is_stamp = err.ee_errno == ENOMSG && err.ee_origin == SO_EE_ORIGIN_TIMESTAMPING;
+            }
+        }
+        if (stamp == nullptr || !is_stamp) {
+            continue;
+        }
+        while (!_in_flight.empty() && _in_flight.front().key < err.ee_data) {
+            _in_flight.pop_front();
+        }
+        if (_in_flight.empty() || _in_flight.front().key != err.ee_data) {
+            continue;
+        }
+        timespec ts{};
+        std::memcpy(&ts, &stamp->ts[0], sizeof(ts));
+        const auto sent = utils::fromKernelTime(ts, offset);
+        const InFlight pending = _in_flight.front();
+        _in_flight.pop_front();
+        // A key that drifted from the send order (a send the kernel did not number) shows up as a far-off time.
+        if (sent - pending.sent > STAMP_TOLERANCE || pending.sent - sent > STAMP_TOLERANCE) {
+            continue;
+        }
+        _stamps.push_back(SendStamp{pending.endpoint, sent, true});
+        ++_stats.tx_stamps;
+        ++reaped;
+    }
+    int pending_error = 0;
+    socklen_t len = sizeof(pending_error);
+    if (::getsockopt(handle, SOL_SOCKET, SO_ERROR, &pending_error, &len) == 0 && pending_error != 0) {
+        logSendError(pending_error);
+    }
+#else
+    (void) handle;
+#endif
+    return reaped;
+}
+
+std::span<const rtype::srv::DatagramQueue::SendStamp> rtype::srv::DatagramQueue::sendStamps() const noexcept
+{
+    return {_stamps.data(), _stamps.size()};
+}
+
+void rtype::srv::DatagramQueue::clearSendStamps() noexcept
+{
+    _stamps.clear();
+}
+
+void rtype::srv::DatagramQueue::_compact() noexcept
+{
+    if (_cursor == _entries.size()) {
+        _entries.clear();
+    } else if (_cursor > 0) {
+        _entries.erase(_entries.begin(), _entries.begin() + static_cast<std::ptrdiff_t>(_cursor));
+    }
+    _cursor = 0;
+}
+
+bool rtype::srv::DatagramQueue::enableSegmentation(const network::Handle handle)
+{
+#if defined(__linux__) && defined(UDP_SEGMENT)
+    // A zero segment size leaves plain sends untouched; kernels without GSO reject the option itself.
+    constexpr int zero = 0;
+    if (::setsockopt(handle, SOL_UDP, UDP_SEGMENT, &zero, sizeof(zero)) == -1) {
+        return false;
+    }
+    _gso = true;
+    return true;
+#else
+    (void) handle;
+    return false;
+#endif
+}
+
+/**
+ * @brief Counts the datagrams from `first` on that can share one GSO message.
+ *
+ * They must go to the same destination and have the size of the first one; a
+ * shorter datagram may only end the run. Stamped datagrams always go alone.
+ *
+ * @param first The index of the first datagram.
+ * @param maxCount The maximum number of datagrams the caller can take.
+ */
+std::size_t rtype::srv::DatagramQueue::_segmentRun(const std::size_t first, const std::size_t maxCount) const noexcept
+{
+    const auto &lead = _entries[first];
+    const std::size_t segment = lead.data.size();
+    const std::size_t limit = (std::min) ({GSO_MAX_SEGMENTS, maxCount, _entries.size() - first});
+    std::size_t count = 1;
+    std::size_t bytes = segment;
+
+    if (segment == 0 || lead.stamped) {
+        return 1;
+    }
+    while (count < limit) {
+        const auto &entry = _entries[first + count];
+        if (entry.stamped || entry.endpoint.port != lead.endpoint.port || entry.endpoint.ip != lead.endpoint.ip
+            || entry.data.size() > segment || entry.data.empty() || bytes + entry.data.size() > GSO_MAX_BYTES) {
+            break;
+        }
+        bytes += entry.data.size();
+        ++count;
+        if (entry.data.size() < segment) {
+            break;
+        }
+    }
+    return count;
+}
+
+bool rtype::srv::DatagramQueue::flush(const network::Handle handle)
+{
+#if defined(__linux__)
+    if (_family == AF_UNSPEC) {
+        _family = utils::socketFamily(handle);
+    }
+    while (_cursor < _entries.size()) {
+        std::size_t batch = 0;
+        std::size_t iov = 0;
+        for (std::size_t next = _cursor; batch < BATCH_SIZE && next < _entries.size() && iov < IOV_CAPACITY; ++batch) {
+            const std::size_t count = _gso ? _segmentRun(next, IOV_CAPACITY - iov) : 1;
+            auto &hdr = _msgs[batch].msg_hdr;
+            std::memset(&hdr, 0, sizeof(hdr));
+            hdr.msg_name = &_addrs[batch];
+            hdr.msg_namelen = utils::toSockaddr(_entries[next].endpoint, _family, _addrs[batch]);
+            hdr.msg_iov = &_iovs[iov];
+            hdr.msg_iovlen = count;
+            for (std::size_t k = 0; k < count; ++k) {
+                auto &entry = _entries[next + k];
+                _iovs[iov + k].iov_base = entry.data.data();
+                _iovs[iov + k].iov_len = entry.data.size();
+            }
+    #if defined(UDP_SEGMENT)
+            if (count > 1) {
+                hdr.msg_control = _ctrl[batch].buf;
+                hdr.msg_controllen = sizeof(_ctrl[batch].buf);
+                cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                const auto segment = static_cast<uint16_t>(_entries[next].data.size());
+                std::memcpy(CMSG_DATA(cmsg), &segment, sizeof(segment));
+            }
+    #endif
+            if (_tx_stamps && _entries[next].stamped) {
+                hdr.msg_control = _ctrl[batch].buf;
+                hdr.msg_controllen = sizeof(_ctrl[batch].buf);
+                cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SO_TIMESTAMPING;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint32_t));
+                constexpr uint32_t request = SOF_TIMESTAMPING_TX_SOFTWARE;
+                std::memcpy(CMSG_DATA(cmsg), &request, sizeof(request));
+            }
+            _counts[batch] = count;
+            iov += count;
+            next += count;
+        }
+        const int sent = ::sendmmsg(handle, _msgs.data(), static_cast<unsigned int>(batch), MSG_DONTWAIT);
+        if (sent < 0) {
+            const int err = errno;
+            if (err == EINTR) {
+                continue;
+            }
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                ++_stats.would_block;
+                _compact();
+                return false;
+            }
+            if (_gso && _counts[0] > 1 && (err == EIO || err == EINVAL)) {
+                utils::cerr("UDP GSO send rejected (", std::strerror(err), "), falling back to one datagram per message");
+                _gso = false;
+                continue;
+            }
+            logSendError(err);
+            _stats.errors += _counts[0];
+            _cursor += _counts[0];
+            continue;
+        }
+        ++_stats.syscalls;
+        if (static_cast<std::size_t>(sent) < batch) {
+            ++_stats.partial;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        std::size_t datagrams = 0;
+        for (std::size_t i = 0; i < static_cast<std::size_t>(sent); ++i) {
+            _recordSend(_entries[_cursor + datagrams], now);
+            datagrams += _counts[i];
+            if (_counts[i] > 1) {
+                ++_stats.segmented;
+            }
+        }
+        _stats.datagrams += datagrams;
+        _stats.max_batch = (std::max) (_stats.max_batch, static_cast<uint32_t>(datagrams));
+        _cursor += datagrams;
+    }
+#else
+    while (_cursor < _entries.size()) {
+        const auto &entry = _entries[_cursor];
+        const ssize_t sent =
+            network::sendto(handle, entry.data.data(), static_cast<network::BufLen>(entry.data.size()), 0, entry.endpoint);
+        if (sent < 0) {
+            const int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                ++_stats.would_block;
+                _compact();
+                return false;
+            }
+            logSendError(err);
+            ++_stats.errors;
+        } else {
+            ++_stats.syscalls;
+            ++_stats.datagrams;
+            _stats.max_batch = (std::max) (_stats.max_batch, 1u);
+            _recordSend(entry, std::chrono::steady_clock::now());
+        }
+        ++_cursor;
+    }
+#endif
+    _compact();
+    return true;
+}
+
+bool rtype::srv::DatagramQueue::empty() const noexcept
+{
+    return _cursor == _entries.size();
+}
+
+std::size_t rtype::srv::DatagramQueue::size() const noexcept
+{
+    return _entries.size() - _cursor;
+}
+
+void rtype::srv::DatagramQueue::clear() noexcept
+{
+    _entries.clear();
+    _cursor = 0;
+}
+
+const rtype::srv::DatagramQueue::Stats &rtype::srv::DatagramQueue::stats() const noexcept
+{
+    return _stats;
+}
+
+void rtype::srv::DatagramQueue::resetStats() noexcept
+{
+    _stats = {};
+}
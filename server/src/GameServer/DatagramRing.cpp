@@ -0,0 +1,251 @@
+#include <RTypeNet/Recv.hpp>
+#include <RTypeSrv/DatagramRing.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+    #include <RTypeSrv/Utils/KernelClock.hpp>
+    #include <RTypeSrv/Utils/SockAddr.hpp>
+    #include <netinet/udp.h>
+#endif
+
+namespace {
+
+[[noreturn]] void throwRecvError(const int err)
+{
+#if defined(_WIN32)
+    char error_buf[256];
+    strerror_s(error_buf, sizeof(error_buf), err);
+    throw std::runtime_error("recvfrom error: " + std::string(error_buf));
+#else
+    throw std::runtime_error("recvfrom error: " + std::string(strerror(err)));
+#endif
+}
+
+}// namespace
+
+rtype::srv::DatagramRing::DatagramRing(const std::size_t nslots, const std::size_t slotSize)
+{
+    _allocate(nslots, slotSize);
+}
+
+void rtype::srv::DatagramRing::_allocate(const std::size_t nslots, const std::size_t slotSize)
+{
+    _slot_size = slotSize;
+    _used = 0;
+    _storage.assign(nslots * slotSize, 0);
+    _views.clear();
+#if defined(__linux__)
+    _views.reserve(_gro ? nslots * GRO_MAX_SEGMENTS : nslots);
+    _msgs.assign(nslots, mmsghdr{});
+    _iovs.assign(nslots, iovec{});
+    _addrs.assign(nslots, sockaddr_storage{});
+    _ctrl.assign(_gro || _stamps || _drop_counter ? nslots : 0, RecvControl{});
+    for (std::size_t i = 0; i < nslots; ++i) {
+        _iovs[i].iov_base = _storage.data() + i * _slot_size;
+        _iovs[i].iov_len = _slot_size;
+    }
+#else
+    _views.reserve(nslots);
+#endif
+}
+
+bool rtype::srv::DatagramRing::enableGro(const network::Handle handle)
+{
+#if defined(__linux__) && defined(UDP_GRO)
+    constexpr int one = 1;
+    if (::setsockopt(handle, SOL_UDP, UDP_GRO, &one, sizeof(one)) == -1) {
+        return false;
+    }
+    _gro = true;
+    // A coalesced buffer can hold up to 64 KiB; fewer, larger slots keep the footprint bounded.
+    _allocate(GRO_SLOTS, GRO_SLOT_SIZE);
+    return true;
+#else
+    (void) handle;
+    return false;
+#endif
+}
+
+bool rtype::srv::DatagramRing::enableTimestamps(const network::Handle handle)
+{
+#if defined(__linux__)
+    constexpr int one = 1;
+    if (::setsockopt(handle, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == -1) {
+        return false;
+    }
+    _stamps = true;
+    _ctrl.assign(_msgs.size(), RecvControl{});
+    return true;
+#else
+    (void) handle;
+    return false;
+#endif
+}
+
+bool rtype::srv::DatagramRing::enableDropCounter(const network::Handle handle)
+{
+#if defined(__linux__) && defined(SO_RXQ_OVFL)
+    constexpr int one = 1;
+    if (::setsockopt(handle, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one)) == -1) {
+        return false;
+    }
+    _drop_counter = true;
+    _ctrl.assign(_msgs.size(), RecvControl{});
+    return true;
+#else
+    (void) handle;
+    return false;
+#endif
+}
+
+rtype::srv::DatagramRing::View rtype::srv::DatagramRing::makeView(const network::Endpoint &endpoint,
+    const std::span<const uint8_t> data, const std::chrono::steady_clock::time_point received) noexcept
+{
+    View view;
+    view.ip = endpoint.ip;
+    view.port = endpoint.port;
+    if (std::memcmp(view.ip.data() + network::IPv4Offset, "\0\0\0\0", 4) == 0) {
+        constexpr uint8_t loopback[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 0x7F, 0, 0, 1};
+        std::copy(std::begin(loopback), std::end(loopback), view.ip.begin());
+    }
+    view.data = data;
+    view.received = received;
+    return view;
+}
+
+/**
+ * @brief Adds the views of a filled slot, splitting a GRO buffer into its datagrams.
+ *
+ * @param slot The slot index.
+ * @param len The number of bytes received in the slot.
+ * @param endpoint The sender.
+ * @param segment The GRO segment size, or 0 if the slot holds a single datagram.
+ * @param received The receive time shared by every datagram of the slot.
+ */
+void rtype::srv::DatagramRing::_push(const std::size_t slot, const std::size_t len, const network::Endpoint &endpoint,
+    const std::size_t segment, const std::chrono::steady_clock::time_point received)
+{
+    const std::span<const uint8_t> data(_storage.data() + slot * _slot_size, len);
+
+    if (segment == 0 || segment >= len) {
+        _views.push_back(makeView(endpoint, data, received));
+        ++_stats.datagrams;
+        return;
+    }
+    ++_stats.coalesced;
+    for (std::size_t off = 0; off < len; off += segment) {
+        _views.push_back(makeView(endpoint, data.subspan(off, (std::min) (segment, len - off)), received));
+        ++_stats.datagrams;
+    }
+}
+
+std::size_t rtype::srv::DatagramRing::drain(const network::Handle handle)
+{
+    const std::size_t nslots = _storage.size() / _slot_size;
+    const std::size_t first = _views.size();
+
+#if defined(__linux__)
+    while (_used < nslots) {
+        const std::size_t head = _used;
+        const std::size_t batch = (std::min) (BATCH_SIZE, nslots - head);
+        for (std::size_t i = head; i < head + batch; ++i) {
+            std::memset(&_msgs[i].msg_hdr, 0, sizeof(_msgs[i].msg_hdr));
+            _msgs[i].msg_hdr.msg_name = &_addrs[i];
+            _msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            _msgs[i].msg_hdr.msg_iov = &_iovs[i];
+            _msgs[i].msg_hdr.msg_iovlen = 1;
+            if (!_ctrl.empty()) {
+                _msgs[i].msg_hdr.msg_control = _ctrl[i].buf;
+                _msgs[i].msg_hdr.msg_controllen = sizeof(_ctrl[i].buf);
+            }
+        }
+        const int ret = ::recvmmsg(handle, &_msgs[head], static_cast<unsigned int>(batch), MSG_DONTWAIT, nullptr);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                throwRecvError(errno);
+            }
+            break;
+        }
+        ++_stats.syscalls;
+        _stats.max_batch = (std::max) (_stats.max_batch, static_cast<uint32_t>(ret));
+        const auto drained = std::chrono::steady_clock::now();
+        const auto offset = _stamps ? utils::realtimeOffset() : std::chrono::nanoseconds{0};
+        for (std::size_t i = head; i < head + static_cast<std::size_t>(ret); ++i) {
+            std::size_t segment = 0;
+            auto received = drained;
+            for (cmsghdr *c = CMSG_FIRSTHDR(&_msgs[i].msg_hdr); c != nullptr; c = CMSG_NXTHDR(&_msgs[i].msg_hdr, c)) {
+    #if defined(UDP_GRO)
+                if (c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO) {
+                    int size = 0;
+                    std::memcpy(&size, CMSG_DATA(c), sizeof(size));
+                    segment = size > 0 ? static_cast<std::size_t>(size) : 0;
+                }
+    #endif
+                if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                    timespec ts{};
+                    std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                    received = utils::fromKernelTime(ts, offset);
+                    ++_stats.stamped;
+                }
+    #if defined(SO_RXQ_OVFL)
+                if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_RXQ_OVFL) {
+                    uint32_t dropped = 0;
+                    std::memcpy(&dropped, CMSG_DATA(c), sizeof(dropped));
+                    _stats.drops += static_cast<uint32_t>(dropped - _kernel_drops);
+                    _kernel_drops = dropped;
+                }
+    #endif
+            }
+            _push(i, _msgs[i].msg_len, utils::fromSockaddr(_addrs[i]), segment, received);
+        }
+        _used += static_cast<std::size_t>(ret);
+        if (static_cast<std::size_t>(ret) < batch) {
+            break;
+        }
+    }
+#else
+    if (_used < nslots) {
+        const std::size_t slot = _used;
+        network::Endpoint endpoint;
+        const ssize_t ret =
+            recvfrom(handle, _storage.data() + slot * _slot_size, static_cast<network::BufLen>(_slot_size), 0, endpoint);
+        if (ret > 0) {
+            ++_stats.syscalls;
+            _stats.max_batch = (std::max) (_stats.max_batch, 1u);
+            _push(slot, static_cast<std::size_t>(ret), endpoint, 0, std::chrono::steady_clock::now());
+            ++_used;
+        } else if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            throwRecvError(errno);
+        }
+    }
+#endif
+    return _views.size() - first;
+}
+
+std::span<const rtype::srv::DatagramRing::View> rtype::srv::DatagramRing::views() const noexcept
+{
+    return {_views.data(), _views.size()};
+}
+
+void rtype::srv::DatagramRing::clear() noexcept
+{
+    _views.clear();
+    _used = 0;
+}
+
+const rtype::srv::DatagramRing::Stats &rtype::srv::DatagramRing::stats() const noexcept
+{
+    return _stats;
+}
+
+void rtype::srv::DatagramRing::resetStats() noexcept
+{
+    _stats = {};
+}
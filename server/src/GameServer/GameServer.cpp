@@ -12,15 +12,24 @@
  * @param ncores The number of cores to use.
  * @param tcpEndpoint The TCP endpoint of the server.
  * @param quitServer A reference to an atomic boolean that will be set to true when the server should quit.
+ * @param shard The reuseport slot of this worker, or std::nullopt to listen on `baseEndpoint` alone.
+ * @param udp The UDP data path options.
  */
 rtype::srv::GameServer::GameServer(const network::Endpoint &baseEndpoint, std::size_t ncores, const network::Endpoint &tcpEndpoint,
-    const network::Endpoint &externalUdpEndpoint, std::atomic<bool> &quitServer)
+    const network::Endpoint &externalUdpEndpoint, std::atomic<bool> &quitServer, std::optional<Shard> shard, const UdpOptions udp)
 {
     _ncores = ncores;
     _quit_server = &quitServer;
     _tcp_endpoint = tcpEndpoint;
     _base_endpoint = baseEndpoint;
     _external_endpoint = externalUdpEndpoint;
+    _shard = std::move(shard);
+    _udp = udp;
+    if (_shard) {
+        // Game IDs of worker i are congruent to i modulo the group size, see ReusePortGroup.
+        _game_id_stride = static_cast<uint32_t>(_shard->count);
+        _next_game_id = static_cast<uint32_t>(_shard->count + _shard->index);
+    }
 }
 
 /**
@@ -40,6 +49,13 @@ void rtype::srv::GameServer::StartServer() noexcept
     }
 }
 
+/**
+ * @brief Records the snapshot of every game in its history and sends it to the game's clients.
+ *
+ * Each client gets a delta against the newest snapshot of its view it acknowledged, or a
+ * keyframe if it has not acknowledged any still in the history. Both are limited to the
+ * entities around the client's player, and to the changes that fit its budget (see _clientView()).
+ */
 void rtype::srv::GameServer::_send_game_snapshots()
 {
     for (auto &[game_id, app_ptr] : _game_instances) {
@@ -49,52 +65,205 @@ void rtype::srv::GameServer::_send_game_snapshots()
         auto *snapshot_res = app_ptr->get_resource_ptr<GameStateSnapshot>();
         auto *snapshot_seq_res = app_ptr->get_resource_ptr<SnapshotSequence>();
 
-        if (!snapshot_res || !snapshot_seq_res || snapshot_res->data.empty()) {
+        if (!snapshot_res || !snapshot_seq_res) {
             continue;
         }
 
+        SnapshotHistory &history = _snapshot_history[game_id];
+        if (history.latest() == nullptr || history.latest()->seq != snapshot_seq_res->sequence_number) {
+            history.push(snapshot_seq_res->sequence_number, snapshot_res->entities);
+        }
+
+        if (_udp.interest.enabled()) {
+            _interest_grid.build(history.latest()->entities, _udp.interest.radius + _udp.interest.hysteresis);
+        }
+
         std::vector<uint32_t> clients_in_game = get_clients_in_game(game_id);
 
         for (uint32_t client_id : clients_in_game) {
-            // if (_client_ids.count(client_id)) {
-            //     network::Handle handle = _client_ids.at(client_id);
-
-            //     auto packet = rtype::srv::GameServerUDPPacketParser::buildSnapshot(_client_sequence_nums[handle]++,
-            //         _last_received_seq[handle], _sack_bits[handle], client_id, snapshot_seq_res->sequence_number, snapshot_res->data);
-
-            //     for (const auto &epkv : _endpoint_to_handle) {
-            //         if (epkv.second == handle) {
-            //             _send_spans[epkv.first].push_back(std::move(packet));
-            //             setPolloutForHandle(_sock.handle);
-            //             break;
-            //         }
-            //     }
-            // }
             std::optional<IP> client_endpoint;
-            for (const auto& [ep, cid] : _endpoint_to_client) {
+            for (const auto &[ep, cid] : _endpoint_to_client) {
                 if (cid == client_id) {
                     client_endpoint = ep;
                     break;
                 }
             }
-            
-            if (client_endpoint.has_value()) {
-                const auto& ep = client_endpoint.value();
-
-                // Utiliser les maps basées sur l'endpoint pour les numéros de séquence
-                auto packet = rtype::srv::GameServerUDPPacketParser::buildSnapshot(
-                    _ep_sequence_nums[ep]++,
-                    _ep_last_received_seq[ep],
-                    _ep_sack_bits[ep],
-                    client_id,
-                    snapshot_seq_res->sequence_number,
-                    snapshot_res->data);
-                
-                _send_spans[ep].push_back(std::move(packet));
-                setPolloutForHandle(_sock.handle);
+
+            if (!client_endpoint.has_value()) {
+                continue;
+            }
+            // A client whose datagrams still wait for its rate skips a tick rather than queue more behind them.
+            if (const auto queued = _send_spans.find(*client_endpoint);
+                queued != _send_spans.end() && !queued->second.empty() && _ep_congestion.contains(*client_endpoint)) {
+                ++_snapshot_stats.throttled;
+                continue;
+            }
+            _queueClientSnapshot(client_endpoint.value(), game_id,
+                _clientView(client_endpoint.value(), client_id, *snapshot_res, history, _interest_grid));
+        }
+    }
+}
+
+/**
+ * @brief Computes the state a client gets this tick, and records it in the client's view.
+ *
+ * The latest snapshot of the game is filtered down to the area of interest of the client,
+ * if UdpOptions::interest is enabled. Of the changes from the client's baseline, those of
+ * highest priority that fit its snapshot budget are then applied (see PriorityAccumulator),
+ * so the snapshot always fits one datagram, and the client's send rate over a tick. Since the client's deltas are computed against
+ * the snapshots of its view, entities leaving it are sent as removed and those entering it
+ * as new.
+ *
+ * @param state The game's snapshot resource, for the entity of each client.
+ * @param grid The entities of the latest snapshot of the game, if UdpOptions::interest is enabled.
+ * @return The history of the client's view.
+ */
+const rtype::srv::SnapshotHistory &rtype::srv::GameServer::_clientView(const IP &endpoint, const uint32_t clientId,
+    const GameStateSnapshot &state, const SnapshotHistory &game, const InterestGrid &grid)
+{
+    const SnapshotHistory::Entry &current = *game.latest();
+    ClientView &view = _ep_views[endpoint];
+    if (view.history.latest() != nullptr && view.history.latest()->seq == current.seq) {
+        return view.history;
+    }
+    _snapshot_stats.considered += current.entities.size();
+    std::optional<uint32_t> focus;
+    if (const auto player = std::ranges::find(state.players, clientId, &PlayerEntity::clientId); player != state.players.end()) {
+        focus = player->entity;
+    }
+    if (_udp.interest.enabled()) {
+        _snapshot_stats.entered += view.interest.update(grid, current.entities, focus, _udp.interest, _view_scratch);
+    } else {
+        _view_scratch.assign(current.entities.begin(), current.entities.end());
+    }
+
+    // The baseline _queueClientSnapshot() will find: pushing the current snapshot evicts the one CAPACITY ticks older.
+    const SnapshotHistory::Entry *base = nullptr;
+    if (const std::optional<uint32_t> baseline = _ep_snapshot_acks[endpoint].baseline();
+        baseline && current.seq - *baseline < SnapshotHistory::CAPACITY) {
+        base = view.history.find(*baseline);
+    }
+    const std::size_t header_size = GameServerUDPPacketParser::headerSize(_ep_channels[endpoint].header().version);
+    const std::size_t packet_size = _clientPacketSize(endpoint);
+    std::size_t budget = packet_size - header_size;
+    if (_udp.snapshot_budget > 0) {
+        budget = (std::min) (budget, _udp.snapshot_budget);
+    }
+    if (const auto congestion = _ep_congestion.find(endpoint); congestion != _ep_congestion.end()) {
+        const std::size_t allowance = congestion->second.allowance(TICK_RATE);
+        budget = (std::min) (budget, allowance - (std::min) (allowance, header_size));
+    }
+    budget -= (std::min) (budget, base != nullptr ? GSPcol::Delta::size : GSPcol::Snapshot::size);
+    const auto encoding = _ep_snapshot_encoding.find(endpoint);
+    const PriorityAccumulator::Budget room{.bytes = budget,
+        .encoding = encoding != _ep_snapshot_encoding.end() ? encoding->second : snapshot::Encoding::FLOAT,
+        .precision = _udp.snapshot_precision};
+    const SnapshotHistory::Entry *previous = game.find(current.seq - 1);
+    const PriorityAccumulator::Scene scene{.previous = previous != nullptr ? std::span<const SnapshotEntity>(previous->entities)
+                                                                           : std::span<const SnapshotEntity>{},
+        .focus = focus,
+        .players = state.players};
+    _snapshot_stats.deferred += view.priority.schedule(base, _view_scratch, scene, room, _schedule_scratch);
+    view.history.push(current.seq, _schedule_scratch);
+    return view.history;
+}
+
+/**
+ * @brief Queues the next snapshot of a client in its outbox: a delta if it acknowledged a snapshot still in the history,
+ * else a keyframe, fragmented when sent if it exceeds the client's MTU.
+ *
+ * Sizes are counted as if each message went alone, header included, whether or not it is batched.
+ */
+void rtype::srv::GameServer::_queueClientSnapshot(const IP &endpoint, uint32_t gameId, const SnapshotHistory &history)
+{
+    const SnapshotHistory::Entry &current = *history.latest();
+    const SnapshotAcks &acks = _ep_snapshot_acks[endpoint];
+    Outbox &outbox = _ep_outboxes[endpoint];
+    const std::size_t header_size = GameServerUDPPacketParser::headerSize(_ep_channels[endpoint].header().version);
+    const std::size_t packet_size = _clientPacketSize(endpoint);
+    const Outbox::Tag tag{.snapshot = current.seq, .stamped = false};
+
+    const auto encoding_it = _ep_snapshot_encoding.find(endpoint);
+    const snapshot::Encoding encoding = encoding_it != _ep_snapshot_encoding.end() ? encoding_it->second : snapshot::Encoding::FLOAT;
+    const SnapshotPrecision &precision = _udp.snapshot_precision;
+
+    // A delta must fit in one datagram; the keyframe replaces it otherwise.
+    bool delta = false;
+    if (const std::optional<uint32_t> baseline = acks.baseline()) {
+        if (const SnapshotHistory::Entry *base = history.find(*baseline)) {
+            PacketWriter payload = outbox.append(GSPcol::CMD::DELTA, GSPcol::FLAGS{}, GSPcol::CHANNEL::UU, packet_size - header_size, tag);
+            GSPcol::Delta::write(payload, current.seq, base->seq);
+            if (encoding == snapshot::Encoding::QUANTIZED) {
+                delta = snapshot::writeQuantizedDelta(payload, base->entities, current.entities, precision);
+            } else {
+                delta = snapshot::writeDelta(payload, base->entities, current.entities);
+            }
+            if (delta) {
+                outbox.finish(payload.size());
+                ++_snapshot_stats.deltas;
+                _snapshot_stats.delta_bytes += header_size + payload.size();
+            } else {
+                outbox.cancel();
             }
         }
     }
+    if (!delta) {
+        // Each client's keyframe is the state of its own view, so there is nothing to share between clients.
+        if (encoding == snapshot::Encoding::QUANTIZED) {
+            _keyframe_scratch.resize(snapshot::quantizedKeyframeMaxSize(current.entities.size()));
+            PacketWriter out(_keyframe_scratch);
+            snapshot::writeQuantizedKeyframe(out, current.entities, precision);
+            _keyframe_scratch.resize(out.size());
+        } else {
+            _keyframe_scratch.resize(snapshot::keyframeSize(current.entities.size()));
+            PacketWriter out(_keyframe_scratch);
+            snapshot::writeKeyframe(out, current.entities);
+        }
+        _compressed_scratch.clear();
+        if (_compressor) {
+            _compress_scratch.resize(GSPcol::Snapshot::size + _keyframe_scratch.size());
+            PacketWriter payload(_compress_scratch);
+            GSPcol::Snapshot::write(payload, current.seq);
+            payload.bytes(_keyframe_scratch);
+            _compressed_scratch.resize(_compress_scratch.size());
+            _compressed_scratch.resize(_compressor->compress(_compress_scratch, _compressed_scratch, _compression_stats[gameId]));
+        }
+        std::size_t size = _compressed_scratch.size();
+        if (!_compressed_scratch.empty()) {
+            outbox.push(GSPcol::CMD::SNAPSHOT, GSPcol::FLAGS::COMPRESSED, GSPcol::CHANNEL::UU, {_compressed_scratch}, tag);
+        } else {
+            std::array<uint8_t, GSPcol::Snapshot::size> snapshot_seq{};
+            PacketWriter seq_out(snapshot_seq);
+            GSPcol::Snapshot::write(seq_out, current.seq);
+            outbox.push(GSPcol::CMD::SNAPSHOT, GSPcol::FLAGS{}, GSPcol::CHANNEL::UU, {snapshot_seq, _keyframe_scratch}, tag);
+            size = snapshot_seq.size() + _keyframe_scratch.size();
+        }
+        ++_snapshot_stats.keyframes;
+        _snapshot_stats.keyframe_bytes += header_size + size;
+        if (header_size + size > packet_size) {
+            ++_snapshot_stats.fragmented;
+        }
+    }
+    if (encoding == snapshot::Encoding::QUANTIZED) {
+        ++_snapshot_stats.quantized;
+    }
+    _snapshot_stats.entities += current.entities.size();
+}
+
+uint16_t rtype::srv::GameServer::_clientMtu(const IP &endpoint) const noexcept
+{
+    const auto it = _ep_mtu.find(endpoint);
+    return it != _ep_mtu.end() ? it->second.mtu() : _udp.mtu;
+}
+
+/**
+ * @brief Gets the room for a client's packet before sealing: its MTU, clamped as the outbox does, less the tag if it encrypts.
+ */
+std::size_t rtype::srv::GameServer::_clientPacketSize(const IP &endpoint) const noexcept
+{
+    const std::size_t mtu =
+        std::clamp(_clientMtu(endpoint), GameServerUDPPacketParser::MIN_PACKET_SIZE, GameServerUDPPacketParser::MAX_PROBED_SIZE);
+    return _ep_sessions.contains(endpoint) ? mtu - PacketCipher::TAG_SIZE : mtu;
 }
 
 std::vector<uint32_t> rtype::srv::GameServer::get_clients_in_game(uint32_t game_id)
@@ -23,125 +23,121 @@ std::uint8_t GameServerPacketParser::parseHeader(const uint8_t *data, std::size_
         return ss.str();
     };
 
-    if (offset + 5 > bufsize) {
+    if (!GWPcol::Header::fits(offset, bufsize)) {
         std::ostringstream msg;
         msg << "Incomplete Header (need 5 bytes, have " << (bufsize - offset) << ") - bytes: " << make_hex(offset, 32);
         throw std::runtime_error(msg.str());
     }
-    if (getNextVal<std::uint16_t>(data, offset, bufsize) != HEADER_MAGIC) {
+    const auto header = GWPcol::Header::at(data + offset);
+    if (header.get<GWPcol::field::Magic>() != HEADER_MAGIC) {
         std::ostringstream msg;
         msg << "Invalid magic number - starting bytes: " << make_hex(start, 32);
         throw std::runtime_error(msg.str());
     }
-    std::uint8_t ver = getNextVal<std::uint8_t>(data, offset, bufsize);
+    const std::uint8_t ver = header.get<GWPcol::field::Version>();
     if (ver != VERSION) {
         std::ostringstream msg;
         msg << "Invalid version (got " << static_cast<int>(ver) << ") - bytes: " << make_hex(start, 32);
         throw std::runtime_error(msg.str());
     }
-    [[maybe_unused]] std::uint8_t flags = getNextVal<std::uint8_t>(data, offset, bufsize);
+    // The offset is left on the CMD byte: the command handlers skip it themselves.
+    offset += GWPcol::Header::offset<GWPcol::field::Cmd>;
+    return header.get<GWPcol::field::Cmd>();
+}
 
-    if (offset >= bufsize) {
-        std::ostringstream msg;
-        msg << "Incomplete Header (no CMD byte) - bytes: " << make_hex(start, 32);
-        throw std::runtime_error(msg.str());
-    }
-    return data[offset];
+/**
+ * @brief Serializes a gateway protocol packet header.
+ */
+void GameServerPacketParser::writeHeader(PacketWriter &out, uint8_t cmd, uint8_t flags)
+{
+    GWPcol::Header::write(out, HEADER_MAGIC, VERSION, flags, cmd);
 }
 
 /**
  * @brief Builds a complete gateway protocol packet header.
  */
-std::vector<uint8_t> GameServerPacketParser::buildHeader(uint8_t cmd, uint8_t flags)
+PacketBuffer GameServerPacketParser::buildHeader(PacketPool &pool, uint8_t cmd, uint8_t flags)
 {
-    std::vector<uint8_t> header;
-    header.reserve(5);
-    header.push_back(0x42);
-    header.push_back(0x57);
-    header.push_back(VERSION);
-    header.push_back(flags);
-    header.push_back(cmd);
+    PacketBuffer header = pool.acquire();
+    PacketWriter out(header.storage());
+    writeHeader(out, cmd, flags);
+    header.resize(out.size());
     return header;
 }
 
 /**
  * @brief Builds a GS registration packet.
  */
-std::vector<uint8_t> GameServerPacketParser::buildGSRegistration(const std::array<uint8_t, 16> &ip, uint16_t port)
+PacketBuffer GameServerPacketParser::buildGSRegistration(PacketPool &pool, const std::array<uint8_t, 16> &ip, uint16_t port)
 {
-    std::vector<uint8_t> packet = buildHeader(20);
-
-    packet.reserve(23);
-    packet.insert(packet.end(), ip.begin(), ip.end());
-    packet.push_back(static_cast<uint8_t>(port >> 8));
-    packet.push_back(static_cast<uint8_t>(port & 0xFF));
+    PacketBuffer packet = pool.acquire();
+    PacketWriter out(packet.storage());
+    writeHeader(out, 20);
+    GWPcol::GsRegistration::write(out, ip, port);
+    packet.resize(out.size());
     return packet;
 }
 
 /**
  * @brief Builds an OCCUPANCY packet.
  */
-std::vector<uint8_t> GameServerPacketParser::buildOccupancy(uint8_t occupancy)
+PacketBuffer GameServerPacketParser::buildOccupancy(PacketPool &pool, uint8_t occupancy)
 {
-    std::vector<uint8_t> packet = buildHeader(23);
-    packet.push_back(occupancy);
+    PacketBuffer packet = pool.acquire();
+    PacketWriter out(packet.storage());
+    writeHeader(out, 23);
+    GWPcol::OccupancyUpdate::write(out, occupancy);
+    packet.resize(out.size());
     return packet;
 }
 
 /**
  * @brief Builds a JOIN response packet.
  */
-std::vector<uint8_t> GameServerPacketParser::buildJoinResponse(uint32_t game_id, const std::array<uint8_t, 16> &ip, uint16_t port)
+PacketBuffer GameServerPacketParser::buildJoinResponse(PacketPool &pool, uint32_t game_id, const std::array<uint8_t, 16> &ip, uint16_t port)
 {
-    std::vector<uint8_t> packet = buildHeader(1);
-
-    packet.reserve(27);
-    packet.push_back(static_cast<uint8_t>((game_id >> 24) & 0xFF));
-    packet.push_back(static_cast<uint8_t>((game_id >> 16) & 0xFF));
-    packet.push_back(static_cast<uint8_t>((game_id >> 8) & 0xFF));
-    packet.push_back(static_cast<uint8_t>(game_id & 0xFF));
-    packet.insert(packet.end(), ip.begin(), ip.end());
-    packet.push_back(static_cast<uint8_t>(port >> 8));
-    packet.push_back(static_cast<uint8_t>(port & 0xFF));
+    PacketBuffer packet = pool.acquire();
+    PacketWriter out(packet.storage());
+    writeHeader(out, 1);
+    GWPcol::JoinResponse::write(out, game_id, ip, port);
+    packet.resize(out.size());
     return packet;
 }
 
 /**
  * @brief Builds a CREATE_KO error response.
  */
-std::vector<uint8_t> GameServerPacketParser::buildCreateKO()
+PacketBuffer GameServerPacketParser::buildCreateKO(PacketPool &pool)
 {
-    return buildHeader(4);
+    return buildHeader(pool, 4);
 }
 
 /**
  * @brief Builds a GAME_END notification packet.
  */
-std::vector<uint8_t> GameServerPacketParser::buildGameEnd(uint32_t game_id)
+PacketBuffer GameServerPacketParser::buildGameEnd(PacketPool &pool, uint32_t game_id)
 {
-    std::vector<uint8_t> packet = buildHeader(5);
-
-    packet.push_back(static_cast<uint8_t>((game_id >> 24) & 0xFF));
-    packet.push_back(static_cast<uint8_t>((game_id >> 16) & 0xFF));
-    packet.push_back(static_cast<uint8_t>((game_id >> 8) & 0xFF));
-    packet.push_back(static_cast<uint8_t>(game_id & 0xFF));
+    PacketBuffer packet = pool.acquire();
+    PacketWriter out(packet.storage());
+    writeHeader(out, 5);
+    GWPcol::GameEnd::write(out, game_id);
+    packet.resize(out.size());
     return packet;
 }
 
 /**
  * @brief Builds a GID registration packet.
  */
-std::vector<uint8_t> GameServerPacketParser::buildGIDRegistration(const std::vector<uint32_t> &game_ids)
+PacketBuffer GameServerPacketParser::buildGIDRegistration(PacketPool &pool, const std::vector<uint32_t> &game_ids)
 {
-    std::vector<uint8_t> packet = buildHeader(24);
-
-    packet.push_back(static_cast<uint8_t>(game_ids.size()));
-    for (uint32_t game_id : game_ids) {
-        packet.push_back(static_cast<uint8_t>((game_id >> 24) & 0xFF));
-        packet.push_back(static_cast<uint8_t>((game_id >> 16) & 0xFF));
-        packet.push_back(static_cast<uint8_t>((game_id >> 8) & 0xFF));
-        packet.push_back(static_cast<uint8_t>(game_id & 0xFF));
+    PacketBuffer packet = pool.acquire();
+    PacketWriter out(packet.storage());
+    writeHeader(out, 24);
+    GWPcol::GidList::write(out, static_cast<uint8_t>(game_ids.size()));
+    for (const uint32_t game_id : game_ids) {
+        out.u32(game_id);
     }
+    packet.resize(out.size());
     return packet;
 }
 
@@ -0,0 +1,41 @@
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/GspHeaderView.hpp>
+
+std::expected<rtype::srv::GspHeaderView, rtype::srv::GspHeaderView::Error> rtype::srv::GspHeaderView::parse(
+    const std::span<const uint8_t> datagram) noexcept
+{
+    if (datagram.size() < GSPcol::Header::size) {
+        return std::unexpected(Error::TOO_SHORT);
+    }
+    const auto header = GSPcol::Header::at(datagram.data());
+    if (header.get<GSPcol::field::Magic>() != GameServerUDPPacketParser::HEADER_MAGIC) {
+        return std::unexpected(Error::BAD_MAGIC);
+    }
+    const uint8_t version = header.get<GSPcol::field::Version>();
+    if (version < GameServerUDPPacketParser::VERSION || version > GameServerUDPPacketParser::BATCH_VERSION) {
+        return std::unexpected(Error::BAD_VERSION);
+    }
+    if (datagram.size() < GameServerUDPPacketParser::headerSize(version)) {
+        return std::unexpected(Error::TOO_SHORT);
+    }
+    if (header.get<GSPcol::field::Size>() != datagram.size()) {
+        return std::unexpected(Error::BAD_SIZE);
+    }
+    return GspHeaderView(datagram);
+}
+
+const char *rtype::srv::GspHeaderView::describe(const Error error) noexcept
+{
+    switch (error) {
+        case Error::TOO_SHORT:
+            return "packet shorter than the header";
+        case Error::BAD_MAGIC:
+            return "invalid magic number";
+        case Error::BAD_VERSION:
+            return "unsupported protocol version";
+        case Error::BAD_SIZE:
+            return "SIZE field does not match the datagram length";
+        default:
+            return "unknown error";
+    }
+}
@@ -3,41 +3,66 @@
 #include <RTypeSrv/GameServer.hpp>
 #include <RTypeSrv/Utils/IPToStr.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
+#include <algorithm>
 #include <ranges>
 
 void rtype::srv::GameServer::_disconnectByHandle(const network::Handle &handle) noexcept
 {
+    _reactor.remove(handle);
     if (const auto it = std::ranges::find_if(_sockets, [handle](const auto &pair) { return pair.second.handle == handle; });
         it != _sockets.end()) {
         utils::cout("Disconnecting client at ", utils::ipToStr(it->second.endpoint.ip), ":", it->second.endpoint.port);
         disconnect(it->second);
         _sockets.erase(it);
     }
-    std::vector<decltype(_endpoint_to_handle.begin())> to_erase;
-    for (auto it = _endpoint_to_handle.begin(); it != _endpoint_to_handle.end(); ++it) {
-        if (it->second == handle) {
-            _send_spans.erase(it->first);
-            _endpoint_to_client.erase(it->first);
-            to_erase.push_back(it);
+    std::vector<IP> to_erase;
+    for (const auto &[endpoint, client_handle] : _endpoint_to_handle) {
+        if (client_handle == handle) {
+            to_erase.push_back(endpoint);
         }
     }
-    for (auto &it : to_erase) {
-        _endpoint_to_handle.erase(it->first);
+    for (const IP &endpoint : to_erase) {
+        _forgetEndpoint(endpoint);
     }
-    if (const auto it = std::ranges::find_if(_fds.begin(), _fds.end(), [handle](const auto &elem) { return elem.handle == handle; });
-        it != _fds.end()) {
-        _fds.erase(it);
-        --_nfds;
+}
+
+/**
+ * @brief Drops everything kept for a client endpoint, when it disconnects or expires.
+ *
+ * Every per-endpoint map is cleared here, so none outlives the client.
+ */
+void rtype::srv::GameServer::_forgetEndpoint(const IP &endpoint) noexcept
+{
+    if (const auto client = _endpoint_to_client.find(endpoint); client != _endpoint_to_client.end()) {
+        const uint32_t client_id = client->second;
+        _endpoint_to_client.erase(client);
+        // Unless the client joined again from another endpoint.
+        if (std::ranges::none_of(_endpoint_to_client | std::views::values, [client_id](const uint32_t id) { return id == client_id; })) {
+            _client_to_game.erase(client_id);
+        }
     }
+    _endpoint_to_handle.erase(endpoint);
+    _ep_client_states.erase(endpoint);
+    _ep_auth_states.erase(endpoint);
+    _ep_channels.erase(endpoint);
+    _ep_outboxes.erase(endpoint);
+    _ep_congestion.erase(endpoint);
+    _ep_sessions.erase(endpoint);
+    _ep_snapshot_acks.erase(endpoint);
+    _ep_snapshot_encoding.erase(endpoint);
+    _ep_views.erase(endpoint);
+    _ep_mtu.erase(endpoint);
+    _latency_metrics.erase(endpoint);
+    _send_spans.erase(endpoint);
+    _stamped_spans.erase(endpoint);
 }
 
 void rtype::srv::GameServer::_acceptClients() noexcept
 {
     try {
         const network::Socket client_sock = network::accept(_sock.handle);
-        _fds.push_back({client_sock.handle, POLLIN | POLLOUT, 0});
+        _reactor.add(client_sock.handle, Reactor::READ | Reactor::WRITE);
         _sockets[_next_id] = client_sock;
-        ++_nfds;
         ++_next_id;
         utils::cout("New client connected: ", utils::ipToStr(client_sock.endpoint.ip), ":", client_sock.endpoint.port);
     } catch (const std::exception &e) {
@@ -47,5 +72,7 @@ void rtype::srv::GameServer::_acceptClients() noexcept
 
 uint32_t rtype::srv::GameServer::generate_unique_game_id()
 {
-    return _next_game_id++;
+    const uint32_t id = _next_game_id;
+    _next_game_id += _game_id_stride;
+    return id;
 }
@@ -2,7 +2,6 @@
 #include <RTypeNet/Connect.hpp>
 #include <RTypeNet/Disconnect.hpp>
 #include <RTypeNet/Listen.hpp>
-#include <RTypeNet/Poll.hpp>
 #include <RTypeNet/Startup.hpp>
 #include <RTypeSrv/Exception.hpp>
 #include <RTypeSrv/GameServer.hpp>
@@ -12,75 +11,127 @@
 void rtype::srv::GameServer::_initServer()
 {
     network::startup();
-    try {
-        _sock = listen(_base_endpoint, network::Protocol::UDP);
-    } catch (const std::exception &e) {
-        throw Exception("startServer", "Could not start listening on ", utils::ipToStr(_base_endpoint.ip), ":", _base_endpoint.port, ": ",
-            e.what());
+    if (_shard) {
+        _sock = _shard->socket;
+    } else {
+        try {
+            _sock = listen(_base_endpoint, network::Protocol::UDP);
+        } catch (const std::exception &e) {
+            throw Exception("startServer", "Could not start listening on ", utils::ipToStr(_base_endpoint.ip), ":", _base_endpoint.port,
+                ": ", e.what());
+        }
+    }
+    if (_udp.engine == IoEngine::IO_URING) {
+        try {
+            _uring = std::make_unique<IoUringEngine>(_sock.handle);
+        } catch (const Exception &e) {
+            utils::cerr("io_uring engine unavailable, falling back to poll: ", e.what());
+        }
     }
-    _fds.push_back({_sock.handle, POLLIN, 0});
+    if (_udp.gso && _uring) {
+        utils::cerr("UDP GSO/GRO is only used by the poll engine, ignoring it");
+    } else if (_udp.gso) {
+        if (!_send_queue.enableSegmentation(_sock.handle)) {
+            utils::cerr("UDP GSO not supported, sending one datagram per message");
+        }
+        if (!_recv_ring.enableGro(_sock.handle)) {
+            utils::cerr("UDP GRO not supported, receiving one datagram per slot");
+        }
+    }
+    if (!_uring && (!_recv_ring.enableTimestamps(_sock.handle) || !_send_queue.enableSendTimestamps(_sock.handle))) {
+        utils::cerr("Kernel packet timestamps not supported, latency is measured from the server loop");
+    }
+    if (!_uring && !_recv_ring.enableDropCounter(_sock.handle)) {
+        utils::cerr("SO_RXQ_OVFL not supported, receive buffer drops are not counted");
+    }
+    if (_udp.compression) {
+        try {
+            _compressor = std::make_unique<PayloadCompressor>(_udp.compression_min_saving);
+        } catch (const Exception &e) {
+            utils::cerr("Snapshot compression unavailable, sending keyframes uncompressed: ", e.what());
+        }
+    }
+    const SocketBuffers buffers = applySocketBuffers(_sock.handle, _udp.buffers);
+    utils::cout("UDP socket buffers: ", buffers.rcv, " bytes receive, ", buffers.snd, " bytes send");
+    if (buffers.rcv < _udp.buffers.rcv || buffers.snd < _udp.buffers.snd) {
+        utils::cerr("UDP socket buffers capped by the kernel (raise net.core.rmem_max / wmem_max or grant CAP_NET_ADMIN)");
+    }
+    // With io_uring the socket is never polled: completions wake the reactor through the ring fd.
+    _reactor.add(_uring ? _uring->eventHandle() : _sock.handle, Reactor::READ);
     _is_running = true;
-    utils::cout("Game server listening on ", utils::ipToStr(_base_endpoint.ip), ":", _base_endpoint.port, "...");
+    if (_shard) {
+        utils::cout("Game server worker ", _shard->index, "/", _shard->count, " listening on ", utils::ipToStr(_base_endpoint.ip), ":",
+            _base_endpoint.port, " (SO_REUSEPORT)...");
+    } else {
+        utils::cout("Game server listening on ", utils::ipToStr(_base_endpoint.ip), ":", _base_endpoint.port, "...");
+    }
     _my_tcp_endpoint.ip = _base_endpoint.ip;
     _my_tcp_endpoint.port = 0;
     _tcp_handle = connect(_my_tcp_endpoint, _tcp_endpoint, network::Protocol::TCP);
     if (_tcp_handle == -1) {
         throw Exception("_initServer", "Failed to connect to TCP gateway at ", utils::ipToStr(_tcp_endpoint.ip), ":", _tcp_endpoint.port);
     }
-    _fds.push_back({_tcp_handle, POLLIN, 0});
-    _nfds = static_cast<network::NFDS>(_fds.size());
+    _reactor.add(_tcp_handle, Reactor::READ);
     utils::cout("Connected to TCP gateway at ", utils::ipToStr(_tcp_endpoint.ip), ":", _tcp_endpoint.port);
     _sendGSRegistration();
 }
 
-void rtype::srv::GameServer::_handleClients(network::NFDS &i) noexcept
+void rtype::srv::GameServer::_handleClients(const network::Handle handle) noexcept
 {
     try {
-        _recvPackets(i);
-        _parsePackets();
+        _recvPackets(handle);
+        _parsePackets(_uring ? _uring->views() : _recv_ring.views());
     } catch (const std::exception &e) {
         utils::cerr("Error handling client socket: ", e.what());
-        _disconnectByHandle(_fds[i].handle);
-        --i;
+        _disconnectByHandle(handle);
     }
 }
 
-void rtype::srv::GameServer::_handleClientsSend(network::NFDS &i) noexcept
+void rtype::srv::GameServer::_handleClientsSend(const network::Handle handle) noexcept
 {
     try {
-        _sendPackets(i);
+        _sendPackets(handle);
     } catch (const std::exception &e) {
         utils::cerr("Error handling client socket: ", e.what());
-        _disconnectByHandle(_fds[i].handle);
-        --i;
+        _disconnectByHandle(handle);
     }
 }
 
-void rtype::srv::GameServer::_handleLoop(network::NFDS &i)
+void rtype::srv::GameServer::_handleEvent(const Reactor::Event &event)
 {
-    if (_fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
-        if (_fds[i].handle == _tcp_handle) {
+    if (event.handle == _reactor.timerHandle()) {
+        if (_reactor.consumeTimer() > 0) {
+            _onTick();
+        }
+        return;
+    }
+
+    if (event.handle == _sock.handle && (event.ready & Reactor::CLOSED)) {
+        _reapSendStamps();
+    } else if (event.ready & Reactor::CLOSED) {
+        if (event.handle == _tcp_handle) {
             throw Exception("TCP gateway connection lost!");
         }
-        _disconnectByHandle(_fds[i].handle);
-        --i;
+        _disconnectByHandle(event.handle);
         return;
     }
 
-    if (_fds[i].handle == _sock.handle) {
-        if (_fds[i].revents & POLLIN) {
-            _handleClients(i);
+    if (_uring && event.handle == _uring->eventHandle()) {
+        _handleClients(_sock.handle);
+    } else if (event.handle == _sock.handle) {
+        if (event.ready & Reactor::READABLE) {
+            _handleClients(event.handle);
         }
-        if (_fds[i].revents & POLLOUT) {
-            _handleClientsSend(i);
+        if (event.ready & Reactor::WRITABLE) {
+            _handleClientsSend(event.handle);
         }
-    } else if (_fds[i].handle == _tcp_handle) {
+    } else if (event.handle == _tcp_handle) {
         try {
-            if (_fds[i].revents & POLLIN) {
+            if (event.ready & Reactor::READABLE) {
                 _recvTcpPackets();
                 _parseTcpPackets();
             }
-            if (_fds[i].revents & POLLOUT) {
+            if (event.ready & Reactor::WRITABLE) {
                 _sendTcpPackets();
             }
         } catch (const std::exception &e) {
@@ -89,27 +140,38 @@ void rtype::srv::GameServer::_handleLoop(network::NFDS &i)
     }
 }
 
-void rtype::srv::GameServer::_serverLoop()
+/**
+ * @brief Runs one simulation step, triggered by the reactor timer every TICK_RATE.
+ *
+ * The messages handlers queued since the last tick leave with the snapshots, one
+ * batch of datagrams per client.
+ */
+void rtype::srv::GameServer::_onTick()
 {
-    using namespace std::chrono;
-    auto last_tick = steady_clock::now();
-    const milliseconds tick_rate(16);// ~60 ticks per seconds
+    _cleanupIdleClients();
+    _game_loop_tick();
+    _send_game_snapshots();
+    _serviceChannels();
+    _flushDatagrams();
+}
 
+/**
+ * @brief Sleeps in the reactor until a socket is ready or the tick timer fires.
+ *
+ * Handlers queue their replies in the client outboxes, sent on the next tick; a
+ * flush still pending (the socket was full) resumes once all events are processed.
+ */
+void rtype::srv::GameServer::_serverLoop()
+{
+    _reactor.armTimer(TICK_RATE);
     while (!(*_quit_server)) {
-        if (network::poll(_fds.data(), _nfds, 0) == -1) {
-            utils::cerr("Poll error, stopping server...");
-            break;
+        for (const auto &event : _reactor.wait()) {
+            _handleEvent(event);
         }
-        for (network::NFDS i = 0; i < _nfds; ++i) {
-            _handleLoop(i);
-        }
-        auto now = steady_clock::now();
-        if (now - last_tick >= tick_rate) {
-            _game_loop_tick();
-            last_tick = now;
-
-            _send_game_snapshots();
+        if (_udp_flush_pending) {
+            _flushDatagrams();
         }
+        _reportStats();
     }
 }
 
@@ -121,19 +183,28 @@ void rtype::srv::GameServer::_game_loop_tick()
             app->tick();
         }
     }
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto &received : _pending_inputs) {
+        _input_age.add(now - received);
+    }
+    _pending_inputs.clear();
 }
 
 void rtype::srv::GameServer::_cleanupServer()
 {
     _send_spans.clear();
-    _recv_packets.clear();
+    _stamped_spans.clear();
+    _send_queue.clear();
+    _recv_ring.clear();
     _client_endpoints.clear();
     _tcp_recv_spans.clear();
     _tcp_send_spans.clear();
+    _tcp_send_offset = 0;
     _sockets.clear();
-    _fds.clear();
-    _nfds = 0;
+    _reactor.remove(_uring ? _uring->eventHandle() : _sock.handle);
+    _reactor.remove(_tcp_handle);
     _next_id = 0;
+    _uring.reset();
     disconnect(_sock);
     if (_tcp_handle != -1) {
         network::Socket s{_tcp_endpoint, _tcp_handle, network::Protocol::TCP};
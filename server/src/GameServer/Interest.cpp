@@ -0,0 +1,96 @@
+#include <RTypeSrv/Interest.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float MAX_COORDINATE = 1 << 30;///< Cells farther out are merged, keeping the cast defined
+
+}// namespace
+
+void rtype::srv::InterestGrid::build(const std::span<const SnapshotEntity> entities, const float cellSize)
+{
+    _cell_size = (std::max) (cellSize, MIN_CELL_SIZE);
+    _items.clear();
+    for (uint32_t i = 0; i < entities.size(); ++i) {
+        const SnapshotEntity &entity = entities[i];
+        if (!std::isfinite(entity.x) || !std::isfinite(entity.y)) {
+            continue;
+        }
+        _items.push_back({_key(_coordinate(entity.x), _coordinate(entity.y)), i});
+    }
+    std::ranges::sort(_items, {}, &Item::cell);
+}
+
+void rtype::srv::InterestGrid::query(const float x, const float y, const float radius, std::vector<uint32_t> &out) const
+{
+    const int32_t y0 = _coordinate(y - radius);
+    const int32_t y1 = _coordinate(y + radius);
+    for (int32_t cx = _coordinate(x - radius); cx <= _coordinate(x + radius); ++cx) {
+        // The cells of a column are consecutive keys: one search finds them all.
+        const uint64_t last = _key(cx, y1);
+        auto it = std::ranges::lower_bound(_items, _key(cx, y0), {}, &Item::cell);
+        for (; it != _items.end() && it->cell <= last; ++it) {
+            out.push_back(it->index);
+        }
+    }
+}
+
+int32_t rtype::srv::InterestGrid::_coordinate(const float value) const noexcept
+{
+    return static_cast<int32_t>(std::floor(std::clamp(value / _cell_size, -MAX_COORDINATE, MAX_COORDINATE)));
+}
+
+uint64_t rtype::srv::InterestGrid::_key(const int32_t cx, const int32_t cy) noexcept
+{
+    // Biased so that the keys sort like the coordinates, column first.
+    const auto ux = static_cast<uint32_t>(cx) ^ 0x80000000U;
+    const auto uy = static_cast<uint32_t>(cy) ^ 0x80000000U;
+    return (static_cast<uint64_t>(ux) << 32) | uy;
+}
+
+std::size_t rtype::srv::InterestSet::update(const InterestGrid &grid, const std::span<const SnapshotEntity> entities,
+    const std::optional<uint32_t> focus, const InterestOptions &options, std::vector<SnapshotEntity> &out)
+{
+    const auto player = focus ? std::ranges::lower_bound(entities, *focus, {}, &SnapshotEntity::id) : entities.end();
+    const bool placed = player != entities.end() && player->id == *focus && std::isfinite(player->x) && std::isfinite(player->y);
+
+    _candidates.clear();
+    if (!placed) {
+        for (uint32_t i = 0; i < entities.size(); ++i) {
+            _candidates.push_back(i);
+        }
+    } else {
+        const float leave = options.radius + options.hysteresis;
+        const float enter_sq = options.radius * options.radius;
+        const float leave_sq = leave * leave;
+        grid.query(player->x, player->y, leave, _candidates);
+        std::erase_if(_candidates, [&](const uint32_t i) {
+            const SnapshotEntity &entity = entities[i];
+            const float dx = entity.x - player->x;
+            const float dy = entity.y - player->y;
+            const float distance_sq = dx * dx + dy * dy;
+            return !(distance_sq <= enter_sq || (distance_sq <= leave_sq && _contains(entity.id)));
+        });
+        // The player is at distance 0, so always kept. The entities are sorted by id, so their indices are too.
+        std::ranges::sort(_candidates);
+    }
+
+    out.clear();
+    _next.clear();
+    std::size_t entered = 0;
+    for (const uint32_t i : _candidates) {
+        out.push_back(entities[i]);
+        _next.push_back(entities[i].id);
+        if (!_contains(entities[i].id)) {
+            ++entered;
+        }
+    }
+    _ids.swap(_next);
+    return entered;
+}
+
+bool rtype::srv::InterestSet::_contains(const uint32_t id) const noexcept
+{
+    return std::ranges::binary_search(_ids, id);
+}
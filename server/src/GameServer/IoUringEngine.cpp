@@ -0,0 +1,353 @@
+#include <RTypeSrv/Exception.hpp>
+#include <RTypeSrv/IoUringEngine.hpp>
+#include <RTypeSrv/Utils/Logger.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <deque>
+
+#if defined(RTYPE_SRV_HAS_IO_URING)
+    #include <RTypeSrv/Utils/KernelClock.hpp>
+    #include <RTypeSrv/Utils/SockAddr.hpp>
+    #include <liburing.h>
+
+namespace {
+
+constexpr int BUFFER_GROUP = 0;
+constexpr uint64_t RECV_TAG = 1ULL << 63;
+constexpr uint64_t SEND_TAG = 1ULL << 62;
+constexpr unsigned CQE_BATCH = 256;
+
+}// namespace
+
+/**
+ * @brief The liburing state, kept out of the header so builds without liburing still see the class.
+ */
+struct rtype::srv::IoUringEngine::Impl {
+        /**
+         * @brief A send in flight; the kernel reads msg, addr, iov and data until its completion.
+         */
+        struct SendSlot {
+                PacketBuffer data;
+                sockaddr_storage addr{};
+                iovec iov{};
+                msghdr msg{};
+        };
+
+        struct Pending {
+                network::Endpoint endpoint{};
+                PacketBuffer data;
+        };
+
+        io_uring ring{};
+        io_uring_buf_ring *buf_ring = nullptr;
+        network::Handle handle{};
+        int family = AF_INET6;
+        std::size_t nbufs = 0;
+        std::size_t buf_size = 0;
+        std::vector<uint8_t> storage;
+        msghdr recv_msg{};
+        bool recv_armed = false;
+        uint32_t kernel_drops = 0;///< Last SO_RXQ_OVFL value
+        std::vector<uint16_t> held;///< Buffer ids referenced by views
+        std::vector<DatagramRing::View> views;
+        std::vector<SendSlot> slots;
+        std::vector<uint32_t> free_slots;
+        std::deque<Pending> pending;
+
+        bool armRecv() noexcept
+        {
+            io_uring_sqe *sqe = io_uring_get_sqe(&ring);
+            if (sqe == nullptr) {
+                return false;
+            }
+            io_uring_prep_recvmsg_multishot(sqe, handle, &recv_msg, 0);
+            sqe->flags |= IOSQE_BUFFER_SELECT;
+            sqe->buf_group = BUFFER_GROUP;
+            io_uring_sqe_set_data64(sqe, RECV_TAG);
+            recv_armed = true;
+            return true;
+        }
+
+        /**
+         * @brief Re-arms the multishot receive if its last completion ended it, and submits at once.
+         * @return true if a receive was re-armed.
+         */
+        bool rearmRecv() noexcept
+        {
+            if (recv_armed || !armRecv()) {
+                return false;
+            }
+            io_uring_submit(&ring);
+            return true;
+        }
+
+        void recycle(const std::span<const uint16_t> bids) noexcept
+        {
+            const int mask = io_uring_buf_ring_mask(static_cast<uint32_t>(nbufs));
+            int i = 0;
+            for (const uint16_t bid : bids) {
+                io_uring_buf_ring_add(buf_ring, storage.data() + bid * buf_size, static_cast<unsigned>(buf_size), bid, mask, i++);
+            }
+            io_uring_buf_ring_advance(buf_ring, i);
+        }
+};
+
+rtype::srv::IoUringEngine::IoUringEngine(const network::Handle handle, const unsigned entries, const std::size_t nbufs,
+    const std::size_t bufSize)
+    : _impl(std::make_unique<Impl>())
+{
+    Impl &im = *_impl;
+    im.handle = handle;
+    im.family = utils::socketFamily(handle);
+    im.nbufs = std::bit_ceil(nbufs);
+    im.buf_size = bufSize;
+    im.storage.resize(im.nbufs * im.buf_size);
+    im.views.reserve(im.nbufs);
+    im.held.reserve(im.nbufs);
+    im.slots.resize(entries);
+    im.free_slots.reserve(entries);
+    for (uint32_t i = entries; i > 0; --i) {
+        im.free_slots.push_back(i - 1);
+    }
+    im.recv_msg.msg_namelen = sizeof(sockaddr_storage);
+    // Kernel receive times and drop counts are optional: without them the views carry the completion reap time.
+    constexpr int one = 1;
+    if (::setsockopt(handle, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one)) == 0) {
+        im.recv_msg.msg_controllen += CMSG_SPACE(sizeof(timespec));
+    }
+    if (::setsockopt(handle, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one)) == 0) {
+        im.recv_msg.msg_controllen += CMSG_SPACE(sizeof(uint32_t));
+    }
+
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = static_cast<uint32_t>(im.nbufs + entries);
+    if (const int ret = io_uring_queue_init_params(entries, &im.ring, &params); ret < 0) {
+        throw Exception("IoUringEngine", "io_uring_queue_init failed: ", std::strerror(-ret));
+    }
+    int ret = 0;
+    im.buf_ring = io_uring_setup_buf_ring(&im.ring, static_cast<unsigned>(im.nbufs), BUFFER_GROUP, 0, &ret);
+    if (im.buf_ring == nullptr) {
+        io_uring_queue_exit(&im.ring);
+        throw Exception("IoUringEngine", "io_uring_setup_buf_ring failed: ", std::strerror(-ret));
+    }
+    for (std::size_t i = 0; i < im.nbufs; ++i) {
+        im.held.push_back(static_cast<uint16_t>(i));
+    }
+    im.recycle(im.held);
+    im.held.clear();
+    im.armRecv();
+    if (const int sret = io_uring_submit(&im.ring); sret < 0) {
+        io_uring_free_buf_ring(&im.ring, im.buf_ring, static_cast<unsigned>(im.nbufs), BUFFER_GROUP);
+        io_uring_queue_exit(&im.ring);
+        throw Exception("IoUringEngine", "io_uring_submit failed: ", std::strerror(-sret));
+    }
+}
+
+rtype::srv::IoUringEngine::~IoUringEngine() noexcept
+{
+    if (_impl) {
+        io_uring_free_buf_ring(&_impl->ring, _impl->buf_ring, static_cast<unsigned>(_impl->nbufs), BUFFER_GROUP);
+        io_uring_queue_exit(&_impl->ring);
+    }
+}
+
+bool rtype::srv::IoUringEngine::available() noexcept
+{
+    return true;
+}
+
+rtype::network::Handle rtype::srv::IoUringEngine::eventHandle() const noexcept
+{
+    return _impl->ring.ring_fd;
+}
+
+std::size_t rtype::srv::IoUringEngine::drain()
+{
+    Impl &im = *_impl;
+    const std::size_t first = im.views.size();
+    std::array<io_uring_cqe *, CQE_BATCH> cqes{};
+    const auto reaped = std::chrono::steady_clock::now();
+    const auto offset = im.recv_msg.msg_controllen > 0 ? utils::realtimeOffset() : std::chrono::nanoseconds{0};
+
+    while (const unsigned n = io_uring_peek_batch_cqe(&im.ring, cqes.data(), CQE_BATCH)) {
+        for (unsigned i = 0; i < n; ++i) {
+            const io_uring_cqe *cqe = cqes[i];
+            const uint64_t tag = io_uring_cqe_get_data64(cqe);
+            if (tag == RECV_TAG) {
+                if (!(cqe->flags & IORING_CQE_F_MORE)) {
+                    im.recv_armed = false;
+                }
+                if (cqe->res < 0 || !(cqe->flags & IORING_CQE_F_BUFFER)) {
+                    continue;
+                }
+                const auto bid = static_cast<uint16_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                im.held.push_back(bid);
+                auto *out = io_uring_recvmsg_validate(im.storage.data() + bid * im.buf_size, cqe->res, &im.recv_msg);
+                if (out == nullptr || (out->flags & MSG_TRUNC)) {
+                    continue;
+                }
+                sockaddr_storage addr{};
+                std::memcpy(&addr, io_uring_recvmsg_name(out), (std::min) (static_cast<std::size_t>(out->namelen), sizeof(addr)));
+                const auto *payload = static_cast<const uint8_t *>(io_uring_recvmsg_payload(out, &im.recv_msg));
+                const std::size_t len = io_uring_recvmsg_payload_length(out, cqe->res, &im.recv_msg);
+                auto received = reaped;
+                for (cmsghdr *c = io_uring_recvmsg_cmsg_firsthdr(out, &im.recv_msg); c != nullptr;
+                    c = io_uring_recvmsg_cmsg_nexthdr(out, &im.recv_msg, c)) {
+                    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                        timespec ts{};
+                        std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                        received = utils::fromKernelTime(ts, offset);
+                    } else if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_RXQ_OVFL) {
+                        uint32_t dropped = 0;
+                        std::memcpy(&dropped, CMSG_DATA(c), sizeof(dropped));
+                        _stats.recv_drops += static_cast<uint32_t>(dropped - im.kernel_drops);
+                        im.kernel_drops = dropped;
+                    }
+                }
+                im.views.push_back(DatagramRing::makeView(utils::fromSockaddr(addr), std::span<const uint8_t>(payload, len), received));
+                ++_stats.recv_datagrams;
+            } else if (tag & SEND_TAG) {
+                const auto idx = static_cast<uint32_t>(tag & ~SEND_TAG);
+                if (cqe->res < 0) {
+                    ++_stats.send_errors;
+                    utils::cerr("Could not send packet: ", std::strerror(-cqe->res), " (errno=", -cqe->res, ")");
+                } else {
+                    ++_stats.send_datagrams;
+                }
+                im.slots[idx].data.reset();
+                im.free_slots.push_back(idx);
+            }
+        }
+        io_uring_cq_advance(&im.ring, n);
+    }
+    // Re-arm as soon as the final completion is reaped: waiting for the next clear() would leave the socket
+    // unread until a send completion happens to wake the ring. The buffers behind views() stay held; if the
+    // ring is still dry the kernel ends the receive again and that completion wakes the next drain().
+    if (im.rearmRecv()) {
+        ++_stats.recv_rearms;
+        ++_stats.submits;
+    }
+    return im.views.size() - first;
+}
+
+std::span<const rtype::srv::DatagramRing::View> rtype::srv::IoUringEngine::views() const noexcept
+{
+    return {_impl->views.data(), _impl->views.size()};
+}
+
+void rtype::srv::IoUringEngine::clear()
+{
+    Impl &im = *_impl;
+    im.views.clear();
+    if (!im.held.empty()) {
+        im.recycle(im.held);
+        im.held.clear();
+    }
+    // drain() re-arms a stopped receive; this only catches a re-arm that found the submission queue full.
+    if (im.rearmRecv()) {
+        ++_stats.recv_rearms;
+        ++_stats.submits;
+    }
+}
+
+void rtype::srv::IoUringEngine::push(const network::Endpoint &endpoint, PacketBuffer data)
+{
+    _impl->pending.push_back(Impl::Pending{endpoint, std::move(data)});
+}
+
+bool rtype::srv::IoUringEngine::flush()
+{
+    Impl &im = *_impl;
+    io_uring_sqe *last = nullptr;
+
+    while (!im.pending.empty() && !im.free_slots.empty()) {
+        io_uring_sqe *sqe = io_uring_get_sqe(&im.ring);
+        if (sqe == nullptr) {
+            break;
+        }
+        const uint32_t idx = im.free_slots.back();
+        im.free_slots.pop_back();
+        auto &slot = im.slots[idx];
+        auto &entry = im.pending.front();
+        slot.data = std::move(entry.data);
+        slot.iov.iov_base = slot.data.data();
+        slot.iov.iov_len = slot.data.size();
+        slot.msg = msghdr{};
+        slot.msg.msg_name = &slot.addr;
+        slot.msg.msg_namelen = utils::toSockaddr(entry.endpoint, im.family, slot.addr);
+        slot.msg.msg_iov = &slot.iov;
+        slot.msg.msg_iovlen = 1;
+        im.pending.pop_front();
+
+        io_uring_prep_sendmsg(sqe, im.handle, &slot.msg, 0);
+        io_uring_sqe_set_data64(sqe, SEND_TAG | idx);
+        sqe->flags |= IOSQE_IO_HARDLINK;
+        last = sqe;
+    }
+    if (last != nullptr) {
+        last->flags &= static_cast<uint8_t>(~IOSQE_IO_HARDLINK);
+        io_uring_submit(&im.ring);
+        ++_stats.submits;
+    }
+    return im.pending.empty();
+}
+
+#else
+
+struct rtype::srv::IoUringEngine::Impl {
+};
+
+rtype::srv::IoUringEngine::IoUringEngine(const network::Handle, const unsigned, const std::size_t, const std::size_t)
+{
+    throw Exception("IoUringEngine", "The server was built without io_uring support");
+}
+
+rtype::srv::IoUringEngine::~IoUringEngine() noexcept = default;
+
+bool rtype::srv::IoUringEngine::available() noexcept
+{
+    return false;
+}
+
+rtype::network::Handle rtype::srv::IoUringEngine::eventHandle() const noexcept
+{
+    return {};
+}
+
+std::size_t rtype::srv::IoUringEngine::drain()
+{
+    return 0;
+}
+
+std::span<const rtype::srv::DatagramRing::View> rtype::srv::IoUringEngine::views() const noexcept
+{
+    return {};
+}
+
+void rtype::srv::IoUringEngine::clear()
+{
+}
+
+void rtype::srv::IoUringEngine::push(const network::Endpoint &, PacketBuffer)
+{
+}
+
+bool rtype::srv::IoUringEngine::flush()
+{
+    return true;
+}
+
+#endif
+
+const rtype::srv::IoUringEngine::Stats &rtype::srv::IoUringEngine::stats() const noexcept
+{
+    return _stats;
+}
+
+void rtype::srv::IoUringEngine::resetStats() noexcept
+{
+    _stats = {};
+}
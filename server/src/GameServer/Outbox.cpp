@@ -0,0 +1,146 @@
+#include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/Outbox.hpp>
+#include <algorithm>
+
+void rtype::srv::Outbox::push(const GSPcol::CMD cmd, const GSPcol::FLAGS flags, const GSPcol::CHANNEL channel,
+    const std::initializer_list<std::span<const uint8_t>> payload, const Tag &tag)
+{
+    std::size_t size = 0;
+    for (const std::span<const uint8_t> piece : payload) {
+        size += piece.size();
+    }
+    PacketWriter out = append(cmd, flags, channel, size, tag);
+    for (const std::span<const uint8_t> piece : payload) {
+        out.bytes(piece);
+    }
+}
+
+rtype::srv::PacketWriter rtype::srv::Outbox::append(const GSPcol::CMD cmd, const GSPcol::FLAGS flags, const GSPcol::CHANNEL channel,
+    const std::size_t size, const Tag &tag)
+{
+    const std::size_t offset = _payloads.size();
+    _payloads.resize(offset + size);
+    _messages.push_back({.cmd = cmd, .flags = flags, .channel = channel, .offset = offset, .size = size, .tag = tag});
+    return PacketWriter(std::span<uint8_t>(_payloads).subspan(offset, size));
+}
+
+void rtype::srv::Outbox::finish(const std::size_t size) noexcept
+{
+    Message &message = _messages.back();
+    message.size = (std::min) (message.size, size);
+    _payloads.resize(message.offset + message.size);
+}
+
+void rtype::srv::Outbox::cancel() noexcept
+{
+    _payloads.resize(_messages.back().offset);
+    _messages.pop_back();
+}
+
+void rtype::srv::Outbox::clear() noexcept
+{
+    _messages.clear();
+    _payloads.clear();
+}
+
+std::optional<std::size_t> rtype::srv::Outbox::flush(PacketPool &pool, const Destination &to, std::vector<PacketBuffer> &out,
+    const Clock::time_point now, ReliableChannel::Stats &reliable, Stats &stats)
+{
+    using Parser = GameServerUDPPacketParser;
+    const uint8_t version = to.channel.header().version;
+    const std::size_t header_size = Parser::headerSize(version);
+    // The tag is taken after clamping, so a sealed datagram never exceeds the MTU, even at MIN_PACKET_SIZE.
+    const std::size_t overhead = to.key != nullptr ? PacketCipher::TAG_SIZE : 0;
+    const std::size_t packet_size = std::clamp(to.mtu, Parser::MIN_PACKET_SIZE, Parser::MAX_PROBED_SIZE) - overhead;
+    const auto entry_size = [](const Message &message) { return GSPcol::BatchEntry::size + message.size; };
+
+    std::optional<std::size_t> stamped;
+    for (std::size_t i = 0; i < _messages.size(); ++i) {
+        const Message &first = _messages[i];
+        if (first.sent) {
+            continue;
+        }
+        // Gather the messages following it on its channel while they fit; the first that does not ends the datagram.
+        _batch.assign(1, i);
+        if (version >= Parser::BATCH_VERSION && header_size + entry_size(first) <= packet_size) {
+            std::size_t size = header_size + entry_size(first);
+            for (std::size_t j = i + 1; j < _messages.size(); ++j) {
+                const Message &next = _messages[j];
+                if (next.sent || !_compatible(first, next)) {
+                    continue;
+                }
+                if (size + entry_size(next) > packet_size) {
+                    break;
+                }
+                size += entry_size(next);
+                _batch.push_back(j);
+            }
+        }
+
+        const Parser::HeaderFields header = to.channel.header(first.channel);
+        const std::size_t begin = out.size();
+        if (_batch.size() == 1) {
+            Parser::appendMessage(pool, out, first.cmd, first.flags, first.channel, header, to.client_id, {_payload(first)}, to.mtu,
+                overhead);
+        } else {
+            std::size_t size = header_size;
+            for (const std::size_t k : _batch) {
+                size += entry_size(_messages[k]);
+            }
+            const bool reliable_batch = (static_cast<uint8_t>(first.flags) & static_cast<uint8_t>(GSPcol::FLAGS::RELIABLE)) != 0;
+            PacketBuffer packet = pool.acquire();
+            PacketWriter writer(packet.storage());
+            Parser::writeHeader(writer, GSPcol::CMD::BATCH, reliable_batch ? GSPcol::FLAGS::RELIABLE : GSPcol::FLAGS{}, header,
+                first.channel, static_cast<uint16_t>(size), to.client_id);
+            for (const std::size_t k : _batch) {
+                const Message &message = _messages[k];
+                GSPcol::BatchEntry::write(writer, message.cmd, message.flags, static_cast<uint16_t>(message.size));
+                writer.bytes(_payload(message));
+            }
+            packet.resize(writer.size());
+            out.push_back(std::move(packet));
+            stats.batched += _batch.size();
+            stats.saved += (_batch.size() - 1) * header_size - _batch.size() * GSPcol::BatchEntry::size;
+        }
+        const std::size_t packets = out.size() - begin;
+        if (to.key != nullptr) {
+            for (std::size_t p = begin; p < out.size(); ++p) {
+                if (!to.cipher->seal(*to.key, PacketCipher::Direction::SERVER, out[p])) {
+                    out[p] = PacketBuffer{};// Its SEQ is spent, as if the datagram were lost; empty ones are not sent
+                }
+            }
+        }
+        to.channel.sent(std::span<const PacketBuffer>(out).subspan(begin), now, reliable);
+        stats.messages += _batch.size();
+        stats.datagrams += packets;
+
+        for (const std::size_t k : _batch) {
+            Message &message = _messages[k];
+            message.sent = true;
+            if (message.tag.snapshot && to.acks != nullptr) {
+                to.acks->sent(header.seq, *message.tag.snapshot, packets);
+            }
+            if (message.tag.stamped) {
+                stamped = begin;
+            }
+        }
+    }
+    clear();
+    return stamped;
+}
+
+bool rtype::srv::Outbox::empty() const noexcept
+{
+    return _messages.empty();
+}
+
+std::span<const uint8_t> rtype::srv::Outbox::_payload(const Message &message) const noexcept
+{
+    return std::span<const uint8_t>(_payloads).subspan(message.offset, message.size);
+}
+
+bool rtype::srv::Outbox::_compatible(const Message &a, const Message &b) noexcept
+{
+    constexpr auto reliable = static_cast<uint8_t>(GSPcol::FLAGS::RELIABLE);
+    return a.channel == b.channel && (static_cast<uint8_t>(a.flags) & reliable) == (static_cast<uint8_t>(b.flags) & reliable);
+}
@@ -0,0 +1,149 @@
+#include <RTypeSrv/GspHeaderView.hpp>
+#include <RTypeSrv/PacketCipher.hpp>
+#include <algorithm>
+#include <limits>
+#include <openssl/evp.h>
+#include <stdexcept>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Nonce = std::array<uint8_t, rtype::srv::PacketCipher::NONCE_SIZE>;
+
+/**
+ * @brief Builds the nonce of a packet: [DIRECTION:1][0:7][SEQ:4], SEQ big-endian.
+ */
+Nonce nonce(const rtype::srv::PacketCipher::Direction from, const uint32_t seq) noexcept
+{
+    Nonce n{};
+    n[0] = static_cast<uint8_t>(from);
+    for (std::size_t i = 0; i < 4; ++i) {
+        n[n.size() - 1 - i] = static_cast<uint8_t>(seq >> (8 * i));
+    }
+    return n;
+}
+
+/**
+ * @brief Rewrites the FLAGS and SIZE of a header in place.
+ */
+void patchHeader(uint8_t *at, const rtype::srv::GSPcol::FLAGS flags, const std::size_t size) noexcept
+{
+    using namespace rtype::srv::GSPcol;
+    field::Flags::codec::store(at + Header::offset<field::Flags>, flags);
+    field::Size::codec::store(at + Header::offset<field::Size>, static_cast<uint16_t>(size));
+}
+
+}// namespace
+
+rtype::srv::PacketCipher::PacketCipher() : _seal(EVP_CIPHER_CTX_new()), _open(EVP_CIPHER_CTX_new())
+{
+    if (_seal == nullptr || _open == nullptr || EVP_EncryptInit_ex(_seal, EVP_chacha20_poly1305(), nullptr, nullptr, nullptr) != 1
+        || EVP_DecryptInit_ex(_open, EVP_chacha20_poly1305(), nullptr, nullptr, nullptr) != 1) {
+        EVP_CIPHER_CTX_free(_seal);
+        EVP_CIPHER_CTX_free(_open);
+        throw std::runtime_error("Failed to create the ChaCha20-Poly1305 contexts");
+    }
+}
+
+rtype::srv::PacketCipher::~PacketCipher() noexcept
+{
+    EVP_CIPHER_CTX_free(_seal);
+    EVP_CIPHER_CTX_free(_open);
+}
+
+bool rtype::srv::PacketCipher::seal(const Key &key, const Direction from, PacketBuffer &packet) noexcept
+{
+    const auto start = Clock::now();
+    const auto header = GspHeaderView::parse(packet.span());
+    const std::size_t size = packet.size() + TAG_SIZE;
+    if (!header || size > PacketBuffer::capacity() || size > (std::numeric_limits<uint16_t>::max)()) {
+        return false;
+    }
+    const std::size_t header_size = header->headerSize();
+    const Nonce n = nonce(from, header->seq());
+    uint8_t *at = packet.data();
+    // The header is authenticated as sent: patched first.
+    patchHeader(at, static_cast<GSPcol::FLAGS>(static_cast<uint8_t>(header->flags()) | static_cast<uint8_t>(GSPcol::FLAGS::ENCRYPTED)),
+        size);
+    uint8_t *payload = at + header_size;
+    const std::size_t payload_size = packet.size() - header_size;
+    int len = 0;
+    const bool sealed = EVP_EncryptInit_ex(_seal, nullptr, nullptr, key.data(), n.data()) == 1
+        && EVP_EncryptUpdate(_seal, nullptr, &len, at, static_cast<int>(header_size)) == 1
+        && EVP_EncryptUpdate(_seal, payload, &len, payload, static_cast<int>(payload_size)) == 1
+        && EVP_EncryptFinal_ex(_seal, payload + payload_size, &len) == 1
+        && EVP_CIPHER_CTX_ctrl(_seal, EVP_CTRL_AEAD_GET_TAG, static_cast<int>(TAG_SIZE), payload + payload_size) == 1;
+    if (!sealed) {
+        return false;
+    }
+    packet.resize(size);
+    ++_stats.sealed;
+    _stats.busy += Clock::now() - start;
+    return true;
+}
+
+bool rtype::srv::PacketCipher::open(const Key &key, const Direction from, const std::span<const uint8_t> datagram,
+    const std::span<uint8_t> out) noexcept
+{
+    const auto start = Clock::now();
+    const auto header = GspHeaderView::parse(datagram);
+    if (!header || datagram.size() < header->headerSize() + TAG_SIZE || out.size() < datagram.size()) {
+        ++_stats.rejected;
+        return false;
+    }
+    const std::size_t header_size = header->headerSize();
+    const std::size_t payload_size = datagram.size() - header_size - TAG_SIZE;
+    const Nonce n = nonce(from, header->seq());
+    std::array<uint8_t, TAG_SIZE> tag{};
+    std::copy_n(datagram.begin() + static_cast<std::ptrdiff_t>(header_size + payload_size), TAG_SIZE, tag.begin());
+    int len = 0;
+    const bool opened = EVP_DecryptInit_ex(_open, nullptr, nullptr, key.data(), n.data()) == 1
+        && EVP_DecryptUpdate(_open, nullptr, &len, datagram.data(), static_cast<int>(header_size)) == 1
+        && EVP_DecryptUpdate(_open, out.data() + header_size, &len, datagram.data() + header_size, static_cast<int>(payload_size)) == 1
+        && EVP_CIPHER_CTX_ctrl(_open, EVP_CTRL_AEAD_SET_TAG, static_cast<int>(TAG_SIZE), tag.data()) == 1
+        && EVP_DecryptFinal_ex(_open, out.data() + header_size + payload_size, &len) == 1;
+    _stats.busy += Clock::now() - start;
+    if (!opened) {
+        ++_stats.rejected;
+        return false;
+    }
+    std::copy_n(datagram.begin(), header_size, out.begin());
+    patchHeader(out.data(),
+        static_cast<GSPcol::FLAGS>(static_cast<uint8_t>(header->flags()) & ~static_cast<uint8_t>(GSPcol::FLAGS::ENCRYPTED)),
+        header_size + payload_size);
+    ++_stats.opened;
+    return true;
+}
+
+const rtype::srv::PacketCipher::Stats &rtype::srv::PacketCipher::stats() const noexcept
+{
+    return _stats;
+}
+
+void rtype::srv::PacketCipher::resetStats() noexcept
+{
+    _stats = {};
+}
+
+bool rtype::srv::ReplayWindow::fresh(const uint32_t seq) const noexcept
+{
+    if (!_started || static_cast<int32_t>(seq - _highest) > 0) {
+        return true;
+    }
+    const uint32_t behind = _highest - seq;
+    return behind < WIDTH && ((_seen >> behind) & 1U) == 0;
+}
+
+void rtype::srv::ReplayWindow::accept(const uint32_t seq) noexcept
+{
+    if (!_started || static_cast<int32_t>(seq - _highest) > 0) {
+        const uint32_t ahead = _started ? seq - _highest : WIDTH;
+        _seen = (ahead < WIDTH ? _seen << ahead : 0) | 1U;
+        _highest = seq;
+        _started = true;
+        return;
+    }
+    if (const uint32_t behind = _highest - seq; behind < WIDTH) {
+        _seen |= uint64_t{1} << behind;
+    }
+}
@@ -0,0 +1,143 @@
+#include <RTypeSrv/PacketPool.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+rtype::srv::PacketPool::PacketPool(const std::size_t initialBuffers)
+{
+    while (_stats.capacity < initialBuffers) {
+        _grow();
+    }
+}
+
+rtype::srv::PacketPool::~PacketPool() noexcept = default;
+
+/**
+ * @brief Allocates one more slab and threads its blocks onto the free list.
+ */
+void rtype::srv::PacketPool::_grow()
+{
+    auto slab = std::make_unique<Block[]>(SLAB_BUFFERS);
+
+    for (std::size_t i = 0; i < SLAB_BUFFERS; ++i) {
+        slab[i].pool = this;
+        slab[i].next = _free;
+        _free = &slab[i];
+    }
+    _slabs.push_back(std::move(slab));
+    _stats.capacity += SLAB_BUFFERS;
+    ++_stats.slabs;
+}
+
+rtype::srv::PacketBuffer rtype::srv::PacketPool::acquire()
+{
+    if (_free == nullptr) {
+        _grow();
+    }
+    Block *block = _free;
+    _free = block->next;
+    block->next = nullptr;
+    block->refs = 1;
+    block->size = 0;
+    ++_stats.in_use;
+    ++_stats.acquired;
+    return PacketBuffer(block);
+}
+
+void rtype::srv::PacketPool::_release(Block *block) noexcept
+{
+    PacketPool *pool = block->pool;
+    block->next = pool->_free;
+    pool->_free = block;
+    --pool->_stats.in_use;
+}
+
+const rtype::srv::PacketPool::Stats &rtype::srv::PacketPool::stats() const noexcept
+{
+    return _stats;
+}
+
+void rtype::srv::PacketPool::resetStats() noexcept
+{
+    _stats.acquired = 0;
+    _stats.slabs = 0;
+}
+
+rtype::srv::PacketBuffer::PacketBuffer(const PacketBuffer &other) noexcept : _block(other._block)
+{
+    if (_block != nullptr) {
+        ++_block->refs;
+    }
+}
+
+rtype::srv::PacketBuffer::PacketBuffer(PacketBuffer &&other) noexcept : _block(std::exchange(other._block, nullptr))
+{
+}
+
+rtype::srv::PacketBuffer &rtype::srv::PacketBuffer::operator=(const PacketBuffer &rhs) noexcept
+{
+    if (this != &rhs) {
+        if (rhs._block != nullptr) {
+            ++rhs._block->refs;
+        }
+        reset();
+        _block = rhs._block;
+    }
+    return *this;
+}
+
+rtype::srv::PacketBuffer &rtype::srv::PacketBuffer::operator=(PacketBuffer &&rhs) noexcept
+{
+    if (this != &rhs) {
+        reset();
+        _block = std::exchange(rhs._block, nullptr);
+    }
+    return *this;
+}
+
+rtype::srv::PacketBuffer::~PacketBuffer() noexcept
+{
+    reset();
+}
+
+void rtype::srv::PacketBuffer::reset() noexcept
+{
+    if (_block != nullptr && --_block->refs == 0) {
+        PacketPool::_release(_block);
+    }
+    _block = nullptr;
+}
+
+void rtype::srv::PacketBuffer::push_back(const uint8_t byte)
+{
+    if (_block == nullptr || _block->size >= PacketPool::BUFFER_SIZE) {
+        throw std::length_error("PacketBuffer overflow");
+    }
+    _block->data[_block->size++] = byte;
+}
+
+void rtype::srv::PacketBuffer::append(const std::span<const uint8_t> bytes)
+{
+    if (_block == nullptr || bytes.size() > PacketPool::BUFFER_SIZE - _block->size) {
+        throw std::length_error("PacketBuffer overflow");
+    }
+    if (!bytes.empty()) {
+        std::memcpy(_block->data + _block->size, bytes.data(), bytes.size());
+    }
+    _block->size += static_cast<uint32_t>(bytes.size());
+}
+
+void rtype::srv::PacketBuffer::resize(const std::size_t size)
+{
+    if (_block == nullptr || size > PacketPool::BUFFER_SIZE) {
+        throw std::length_error("PacketBuffer overflow");
+    }
+    _block->size = static_cast<uint32_t>(size);
+}
+
+void rtype::srv::PacketBuffer::clear() noexcept
+{
+    if (_block != nullptr) {
+        _block->size = 0;
+    }
+}
@@ -4,32 +4,28 @@
 #include <RTypeSrv/GameServerPacketParser.hpp>
 #include <RTypeSrv/GameServerUDPPacketParser.hpp>
 #include <RTypeSrv/Systems.hpp>
+#include <RTypeSrv/Utils/IPToStr.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
-#include <cstring>
 #include <iomanip>
 #include <ranges>
 #include <sstream>
 #include <stdexcept>
-
-#if defined(_WIN32)
-    #include <winsock2.h>
-#else
-    #include <arpa/inet.h>
-#endif
+#include <utility>
 
 void rtype::srv::GameServer::setPolloutForHandle(const network::Handle h) noexcept
 {
-    for (auto &fd : _fds) {
-        if (fd.handle == h) {
-            fd.events |= POLLOUT;
-            break;
-        }
+    if (h == _sock.handle) {
+        _udp_flush_pending = true;
+        return;
+    }
+    if (const uint32_t interest = _reactor.interest(h); interest != 0) {
+        _reactor.modify(h, interest | Reactor::WRITE);
     }
 }
 
 void rtype::srv::GameServer::sendErrorResponse(const network::Handle handle)
 {
-    std::vector<uint8_t> error_packet = GameServerPacketParser::buildCreateKO();
+    PacketBuffer error_packet = GameServerPacketParser::buildCreateKO(_packet_pool);
     _tcp_send_spans[handle].push_back(std::move(error_packet));
     setPolloutForHandle(handle);
 }
@@ -42,13 +38,13 @@ std::vector<uint8_t> rtype::srv::GameServer::buildJoinMsgForClient(const uint8_t
 void rtype::srv::GameServer::handleCreate([[maybe_unused]] network::Handle handle, const uint8_t *data, std::size_t &offset,
     std::size_t bufsize)
 {
-    if (offset + 1 + 1 > bufsize) {
+    if (!GWPcol::Create::fits(offset + 1, bufsize)) {
         utils::cerr("Incomplete CREATE packet from gateway");
         sendErrorResponse(handle);
         return;
     }
-    uint8_t gametype = data[offset + 1];
-    offset += 2;
+    const uint8_t gametype = GWPcol::Create::at(data + offset + 1).get<GWPcol::field::GameType>();
+    offset += 1 + GWPcol::Create::size;
     utils::cout("Received CREATE request from gateway, gametype: ", static_cast<int>(gametype));
 
     uint32_t new_game_id = generate_unique_game_id();
@@ -70,8 +66,8 @@ void rtype::srv::GameServer::handleCreate([[maybe_unused]] network::Handle handl
 
     _game_instances.at(new_game_id)->init();
 
-    std::vector<uint8_t> join_response =
-        GameServerPacketParser::buildJoinResponse(new_game_id, _external_endpoint.ip, _external_endpoint.port);
+    PacketBuffer join_response =
+        GameServerPacketParser::buildJoinResponse(_packet_pool, new_game_id, _external_endpoint.ip, _external_endpoint.port);
     {
         std::ostringstream ss;
         ss << std::hex << std::setfill('0');
@@ -131,163 +127,263 @@ void rtype::srv::GameServer::_cleanupExpiredAuthChallenges() noexcept
         _client_states.erase(h);
     }
 
-    std::vector<decltype(_ep_auth_states.begin())> ep_to_remove;
-    for (auto &kv : _ep_auth_states) {
-        const auto &entry = kv.second;
-        if (entry.attempts >= MAX_AUTH_ATTEMPTS) {
-            ep_to_remove.push_back(_ep_auth_states.find(kv.first));
-            continue;
+    std::vector<IP> ep_to_remove;
+    for (const auto &[endpoint, entry] : _ep_auth_states) {
+        if (entry.attempts >= MAX_AUTH_ATTEMPTS || now - entry.timestamp > AUTH_TIMEOUT) {
+            ep_to_remove.push_back(endpoint);
         }
-        if (now - entry.timestamp > AUTH_TIMEOUT) {
-            ep_to_remove.push_back(_ep_auth_states.find(kv.first));
-            continue;
+    }
+    for (const IP &endpoint : ep_to_remove) {
+        utils::cout("Cleaning up expired auth challenge for endpoint");
+        _forgetEndpoint(endpoint);
+    }
+}
+
+/**
+ * @brief Forgets the clients nothing was received from for CLIENT_TIMEOUT, once per tick.
+ *
+ * An authenticated client answers the PING it is sent every second, so only a
+ * client that left without a word, or a JOIN from a spoofed source, goes silent.
+ */
+void rtype::srv::GameServer::_cleanupIdleClients() noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<IP> idle;
+    for (const auto &[endpoint, channel] : _ep_channels) {
+        if (now - channel.lastReceived() > CLIENT_TIMEOUT) {
+            idle.push_back(endpoint);
+        }
+    }
+    for (const IP &endpoint : idle) {
+        utils::cout("Client at ", utils::ipToStr(endpoint.first), ":", endpoint.second, " timed out");
+        _forgetEndpoint(endpoint);
+    }
+}
+
+/**
+ * @brief Client commands over UDP; min_payload is checked against the bytes following the header.
+ */
+constexpr rtype::srv::GameServer::UdpCommandTable rtype::srv::GameServer::UDP_COMMANDS{
+    {.cmd = GSPcol::CMD::JOIN, .name = "JOIN", .handler = &GameServer::handleUDPJoin, .min_payload = GSPcol::Join::size},
+    {.cmd = GSPcol::CMD::AUTH, .name = "AUTH", .handler = &GameServer::handleUDPAuthResponse, .min_payload = GSPcol::Auth::size},
+    {.cmd = GSPcol::CMD::INPUT,
+        .name = "INPUT",
+        .handler = &GameServer::handleUDPInput,
+        .min_payload = GSPcol::Input::size,
+        .authenticated = true},
+    {.cmd = GSPcol::CMD::PING, .name = "PING", .handler = &GameServer::handleUDPPing},
+    {.cmd = GSPcol::CMD::PONG, .name = "PONG", .handler = &GameServer::handleUDPPong},
+    {.cmd = GSPcol::CMD::ACK, .name = "ACK", .handler = &GameServer::handleUDPAck},
+    {.cmd = GSPcol::CMD::BATCH, .name = "BATCH", .handler = &GameServer::handleUDPBatch, .min_payload = GSPcol::BatchEntry::size},
+    {.cmd = GSPcol::CMD::RESYNC, .name = "RESYNC", .handler = &GameServer::handleUDPResync, .authenticated = true},
+    {.cmd = GSPcol::CMD::FRAGMENT,
+        .name = "FRAGMENT",
+        .handler = &GameServer::handleUDPFragment,
+        .min_payload = GSPcol::Fragment::size + 1,
+        .authenticated = true},
+};
+
+bool rtype::srv::GameServer::_isAuthenticated(const IP &endpoint) const noexcept
+{
+    const auto it = _ep_client_states.find(endpoint);
+    return it != _ep_client_states.end() && it->second.authState == AuthState::AUTHENTICATED;
+}
+
+const rtype::srv::PacketCipher::Key *rtype::srv::GameServer::_sessionKey(const IP &endpoint) const noexcept
+{
+    // AUTH_OK keeps the key by handle for the clients the gateway announced, by endpoint for the others.
+    if (const auto handle = _endpoint_to_handle.find(endpoint); handle != _endpoint_to_handle.end()) {
+        if (const auto state = _client_states.find(handle->second);
+            state != _client_states.end() && state->second.authState == AuthState::AUTHENTICATED) {
+            return &state->second.sessionKey;
         }
     }
-    for (auto &it : ep_to_remove) {
-        if (it != _ep_auth_states.end()) {
-            utils::cout("Cleaning up expired auth challenge for endpoint");
-            _ep_auth_states.erase(it->first);
-            _ep_client_states.erase(it->first);
-            _send_spans.erase(it->first);
-            _endpoint_to_client.erase(it->first);
+    const auto state = _ep_client_states.find(endpoint);
+    return state != _ep_client_states.end() && state->second.authState == AuthState::AUTHENTICATED ? &state->second.sessionKey : nullptr;
+}
+
+/**
+ * @brief Opens a datagram of a client that encrypts, before anything in it is trusted.
+ *
+ * The first F_ENCRYPTED packet that opens under the client's session key starts its
+ * SealedSession: the server then seals what it sends the client, and drops its
+ * plaintext packets but CMD_JOIN, which starts the session over. A SEQ opened
+ * already is dropped unopened; one is recorded only once its tag is checked.
+ *
+ * @return The datagram in clear, valid until the next call; std::nullopt if it must be dropped.
+ */
+std::optional<std::span<const uint8_t>> rtype::srv::GameServer::_openDatagram(const IP &endpoint, const GspHeaderView &header,
+    const std::span<const uint8_t> datagram)
+{
+    auto session = _ep_sessions.find(endpoint);
+    if (!header.hasFlag(GSPcol::FLAGS::ENCRYPTED)) {
+        if (session != _ep_sessions.end() && header.cmd() != GSPcol::CMD::JOIN) {
+            ++_encryption_stats.downgraded;
+            return std::nullopt;
         }
+        return datagram;
+    }
+    const PacketCipher::Key *key = session != _ep_sessions.end() ? &session->second.key : _sessionKey(endpoint);
+    if (key == nullptr) {
+        ++_encryption_stats.keyless;
+        return std::nullopt;
     }
+    if (session != _ep_sessions.end() && !session->second.replay.fresh(header.seq())) {
+        ++_encryption_stats.replayed;
+        return std::nullopt;
+    }
+    _open_scratch.resize(datagram.size());
+    if (!_cipher.open(*key, PacketCipher::Direction::CLIENT, datagram, _open_scratch)) {
+        return std::nullopt;
+    }
+    if (session == _ep_sessions.end()) {
+        session = _ep_sessions.emplace(endpoint, SealedSession{.key = *key, .replay = {}}).first;
+    }
+    session->second.replay.accept(header.seq());
+    return std::span<const uint8_t>(_open_scratch).first(datagram.size() - PacketCipher::TAG_SIZE);
 }
 
-void rtype::srv::GameServer::_parsePackets()
+void rtype::srv::GameServer::_parsePackets(const std::span<const DatagramRing::View> datagrams)
 {
     const auto now = std::chrono::steady_clock::now();
     const auto ping_interval = std::chrono::seconds(1);
-    for (const auto &kv : _client_ids) {
-        uint32_t clientId = kv.first;
-        network::Handle h = kv.second;
-        auto &metrics = _latency_metrics[h];
-        if (auto it = _client_states.find(h); it != _client_states.end() && it->second.authState == AuthState::AUTHENTICATED) {
-            if (metrics.last_ping.time_since_epoch().count() == 0 || (now - metrics.last_ping) > ping_interval) {
-                auto pkt = GameServerUDPPacketParser::buildHeader(GSPcol::CMD::PING, GSPcol::FLAGS::CONN, _client_sequence_nums[h]++,
-                    _last_received_seq[h], _sack_bits[h], GSPcol::CHANNEL::UU, GameServerUDPPacketParser::HEADER_SIZE, clientId);
-                for (const auto &epkv : _endpoint_to_handle) {
-                    if (epkv.second == h) {
-                        _send_spans[epkv.first].push_back(pkt);
-                        setPolloutForHandle(_sock.handle);
-                    }
-                }
-                metrics.last_ping = now;
-            }
+    for (const IP &endpoint : _ep_channels | std::views::keys) {
+        if (_sessionKey(endpoint) == nullptr) {
+            continue;
+        }
+        auto &metrics = _latency_metrics[endpoint];
+        if (metrics.last_ping.time_since_epoch().count() == 0 || (now - metrics.last_ping) > ping_interval) {
+            // Stamped, so the queue reports when the datagram carrying it actually left (see _applySendStamps).
+            _ep_outboxes[endpoint].push(GSPcol::CMD::PING, GSPcol::FLAGS::CONN, GSPcol::CHANNEL::UU, {},
+                {.snapshot = std::nullopt, .stamped = true});
+            metrics.last_ping = now;
+            metrics.ping_sent = now;
         }
     }
 
-    for (auto &[ep_key, packets] : _recv_packets) {
+    for (const auto &datagram : datagrams) {
+        const IP ep_key = {datagram.ip, datagram.port};
+        const std::span<const uint8_t> packet = datagram.data;
+        _server_delay.add(now - datagram.received);
         network::Handle handle = 0;
         if (auto hit = _endpoint_to_handle.find(ep_key); hit != _endpoint_to_handle.end()) {
             handle = hit->second;
         }
-        for (auto &packet : packets) {
-            if (packet.empty())
+        if (packet.empty())
+            continue;
+        try {
+            const auto wire = GspHeaderView::parse(packet);
+            if (!wire) {
+                utils::cerr("Dropped UDP packet (", GspHeaderView::describe(wire.error()), ", ", packet.size(), " bytes)");
                 continue;
-            try {
-                std::size_t offset = 0;
-                if (packet.size() < 21) {
-                    utils::cerr("UDP packet too small (need 21 bytes header, got ", packet.size(), " bytes)");
-                    continue;
-                }
-                uint16_t magic = static_cast<uint16_t>((static_cast<uint16_t>(packet[offset]) << 8) | packet[offset + 1]);
-                if (magic != GSPCOL_MAGIC) {
-                    utils::cerr("Invalid UDP packet magic (got ", std::hex, magic, ", expected ", GSPCOL_MAGIC, ")");
-                    continue;
-                }
-                offset += 2;
-                uint8_t version = packet[offset++];
-                if (version != 1) {
-                    utils::cerr("Invalid UDP protocol version (got ", static_cast<int>(version), ", expected 1)");
-                    continue;
-                }
-                [[maybe_unused]] uint8_t flags = packet[offset++];
-                uint32_t seq = 0;
-                memcpy(&seq, packet.data() + offset, 4);
-                seq = ntohl(seq);
-                offset += 4;
-                uint32_t ackBase = 0;
-                memcpy(&ackBase, packet.data() + offset, 4);
-                ackBase = ntohl(ackBase);
-                offset += 4;
-                [[maybe_unused]] uint8_t ackBits = packet[offset++];
-                [[maybe_unused]] uint8_t channel = packet[offset++];
-                uint16_t size = 0;
-                memcpy(&size, packet.data() + offset, 2);
-                size = ntohs(size);
-                offset += 2;
-                uint32_t clientId = 0;
-                memcpy(&clientId, packet.data() + offset, 4);
-                clientId = ntohl(clientId);
-                offset += 4;
-                uint8_t cmd = packet[offset++];
-
-                switch (static_cast<GSPcol::CMD>(cmd)) {
-                    case GSPcol::CMD::JOIN:
-                        handleUDPJoin(ep_key, packet.data(), offset, packet.size(), clientId);
-                        break;
-                    case GSPcol::CMD::AUTH:
-                        handleUDPAuthResponse(ep_key, packet.data(), offset, packet.size(), clientId);
-                        break;
-                    case GSPcol::CMD::INPUT:
-                        // if (handle != 0) {
-                        //     if (auto it = _client_states.find(handle);
-                        //         it != _client_states.end() && it->second.authState == AuthState::AUTHENTICATED) {
-                        //         handleUDPInput(ep_key, packet.data(), offset, packet.size(), clientId);
-                        //     } else {
-                        //         utils::cerr("Received INPUT from unauthenticated client ", clientId);
-                        //     }
-                        // } else {
-                        //     utils::cerr("Received INPUT from unknown handle for client ", clientId);
-                        // }
-                        // break;
-                        if (auto it = _ep_client_states.find(ep_key);
-                            it != _ep_client_states.end() && it->second.authState == AuthState::AUTHENTICATED) {
-                            handleUDPInput(ep_key, packet.data(), offset, packet.size(), clientId);
-                        } else {
-                            utils::cerr("Received INPUT from unauthenticated endpoint for client ", clientId);
-                        }
-                        break;
-                    case GSPcol::CMD::PING:
-                        handleUDPPing(ep_key, packet.data(), offset, packet.size(), clientId);
-                        break;
-                    case GSPcol::CMD::PONG:
-                        handleUDPPong(ep_key, packet.data(), offset, packet.size(), clientId);
-                        break;
-                    case GSPcol::CMD::RESYNC:
-                        // if (handle != 0) {
-                        //     if (auto it = _client_states.find(handle);
-                        //         it != _client_states.end() && it->second.authState == AuthState::AUTHENTICATED) {
-                        //         handleUDPResync(ep_key, packet.data(), offset, packet.size(), clientId);
-                        //     } else {
-                        //         utils::cerr("Received RESYNC from unauthenticated client ", clientId);
-                        //     }
-                        // } else {
-                        //     utils::cerr("Received RESYNC from unknown handle for client ", clientId);
-                        // }
-                        if (auto it = _ep_client_states.find(ep_key);
-                            it != _ep_client_states.end() && it->second.authState == AuthState::AUTHENTICATED) {
-                            handleUDPResync(ep_key, packet.data(), offset, packet.size(), clientId);
-                        } else {
-                            utils::cerr("Received RESYNC from unauthenticated endpoint for client ", clientId);
-                        }
-                        break;
-                    default:
-                        utils::cerr("Unknown UDP command: ", static_cast<int>(cmd));
-                        break;
+            }
+            const auto opened = _openDatagram(ep_key, *wire, packet);
+            if (!opened) {
+                continue;
+            }
+            const auto header = opened->data() == packet.data() ? wire : GspHeaderView::parse(*opened);
+            if (!header) {
+                continue;
+            }
+            if (const auto acks = _ep_snapshot_acks.find(ep_key); acks != _ep_snapshot_acks.end()) {
+                acks->second.acknowledge(header->ackBase(), header->ackBits(), header->ackWidth());
+            }
+            if (const auto path = _ep_mtu.find(ep_key); path != _ep_mtu.end()) {
+                path->second.acknowledge(header->ackBase(), header->ackBits(), header->ackWidth(), datagram.received, _mtu_stats);
+            }
+            if (const auto channel = _ep_channels.find(ep_key); channel != _ep_channels.end()) {
+                const auto receipt = channel->second.receive(*header, datagram.received, _reliable_stats);
+                if (receipt == ReliableChannel::Receipt::DUPLICATE && header->hasFlag(GSPcol::FLAGS::RELIABLE)) {
+                    continue;// A retransmission of a packet already handled; receive() acknowledges it again
                 }
-            } catch (const std::exception &e) {
-                utils::cerr("Error parsing UDP packet: ", e.what());
-                if (handle != 0) {
-                    parseErrors[handle]++;
-                    if (parseErrors[handle] >= MAX_PARSE_ERRORS) {
-                        throw std::runtime_error("Client sent too many malformed packets.");
-                    }
+            }
+            _deliverUDP(ep_key, *header, datagram.received);
+        } catch (const std::exception &e) {
+            utils::cerr("Error parsing UDP packet: ", e.what());
+            if (handle != 0) {
+                parseErrors[handle]++;
+                if (parseErrors[handle] >= MAX_PARSE_ERRORS) {
+                    throw std::runtime_error("Client sent too many malformed packets.");
                 }
             }
         }
-        packets.clear();
     }
     _cleanupExpiredAuthChallenges();
+    _cleanupExpiredFragments();
+}
+
+/**
+ * @brief Dispatches a packet, received or reassembled from fragments, in the order of its channel.
+ *
+ * An RO message arriving ahead of its turn is held by the client's channel and
+ * dispatched, with the ones it waited for, once they arrive. JOIN restarts the
+ * channel and fragments are ordered once reassembled, so neither waits.
+ */
+void rtype::srv::GameServer::_deliverUDP(const IP &endpoint, const GspHeaderView &packet,
+    const std::chrono::steady_clock::time_point received)
+{
+    const auto channel = _ep_channels.find(endpoint);
+    if (channel == _ep_channels.end() || packet.cmd() == GSPcol::CMD::JOIN || packet.cmd() == GSPcol::CMD::FRAGMENT) {
+        _dispatchUDP(endpoint, packet, received);
+        return;
+    }
+    if (channel->second.order(packet, received, _reliable_stats) != ReliableChannel::Delivery::DELIVER) {
+        return;
+    }
+    _dispatchUDP(endpoint, packet, received);
+    _releaseHeld(endpoint, received);
+}
+
+/**
+ * @brief Dispatches the RO messages of a client whose turn has come, see ReliableChannel::release().
+ */
+void rtype::srv::GameServer::_releaseHeld(const IP &endpoint, const std::chrono::steady_clock::time_point now)
+{
+    // Looked up again every time: a handler may add channels to the map.
+    for (auto channel = _ep_channels.find(endpoint); channel != _ep_channels.end(); channel = _ep_channels.find(endpoint)) {
+        const std::optional<std::vector<uint8_t>> message = channel->second.release(now, _reliable_stats);
+        if (!message) {
+            return;
+        }
+        if (const auto held = GspHeaderView::parse(*message)) {
+            _dispatchUDP(endpoint, *held, now);
+        }
+    }
+}
+
+/**
+ * @brief Routes a validated packet, received or reassembled from fragments, to its handler.
+ */
+void rtype::srv::GameServer::_dispatchUDP(const IP &endpoint, const GspHeaderView &packet,
+    const std::chrono::steady_clock::time_point received)
+{
+    const UdpCommandTable::Route *route = UDP_COMMANDS.find(packet.cmd());
+    if (route == nullptr) {
+        utils::cerr("Unknown UDP command: ", static_cast<int>(packet.cmd()));
+        return;
+    }
+    if (packet.payload().size() < route->min_payload || !route->allows(std::to_underlying(packet.channel()))) {
+        UdpCommandTable::reject(*route, _udp_commands);
+        utils::cerr("Malformed UDP ", route->name, " from client ", packet.clientId());
+        return;
+    }
+    if (route->authenticated && !_isAuthenticated(endpoint)) {
+        UdpCommandTable::reject(*route, _udp_commands);
+        utils::cerr("Received ", route->name, " from unauthenticated endpoint for client ", packet.clientId());
+        return;
+    }
+    UdpCommandTable::call(*route, _udp_commands, *this, endpoint, packet, received);
+}
+
+void rtype::srv::GameServer::_cleanupExpiredFragments() noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::erase_if(_fragment_buffers, [&](const auto &kv) {
+        const bool expired = now - kv.second.first_fragment > FRAGMENT_TIMEOUT || !_isAuthenticated(kv.first.first);
+        if (expired) {
+            _fragment_bytes -= kv.second.message.size();
+            ++_fragment_stats.expired;
+        }
+        return expired;
+    });
 }
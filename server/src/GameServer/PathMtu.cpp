@@ -0,0 +1,86 @@
+#include <RTypeSrv/PathMtu.hpp>
+#include <algorithm>
+
+rtype::srv::PathMtu::PathMtu(const uint16_t base, const uint16_t ceiling) noexcept
+    : _base(base), _ceiling((std::max) (base, ceiling)), _mtu(base), _limit(_ceiling)
+{
+}
+
+std::optional<uint16_t> rtype::srv::PathMtu::due(const Clock::time_point now, const std::chrono::microseconds timeout,
+    Stats &stats) noexcept
+{
+    if (_outstanding) {
+        if (now < _deadline) {
+            return std::nullopt;
+        }
+        _outstanding = false;
+        ++stats.lost;
+        if (++_losses >= MAX_PROBES) {
+            if (_phase == Phase::CONFIRM) {
+                // The MTU stopped passing: back to the base, and search again below it.
+                ++stats.black_holes;
+                _mtu = _base;
+                _phase = Phase::SEARCH;
+            }
+            _limit = static_cast<uint16_t>(_probe - 1);
+            _probe = 0;
+            _losses = 0;
+        }
+    }
+    if (_phase == Phase::DONE) {
+        if (now >= _raise && _mtu < _ceiling) {
+            _phase = Phase::SEARCH;
+            _limit = _ceiling;
+        } else if (now >= _confirm && _mtu > _base) {
+            _phase = Phase::CONFIRM;
+            _probe = _mtu;
+        } else {
+            return std::nullopt;
+        }
+    }
+    if (_phase == Phase::SEARCH && _probe == 0) {
+        if (_limit < _mtu + STEP) {
+            _phase = Phase::DONE;
+            _confirm = now + CONFIRM_INTERVAL;
+            _raise = now + RAISE_INTERVAL;
+            return std::nullopt;
+        }
+        _probe = static_cast<uint16_t>(_mtu + (_limit - _mtu + 1) / 2);
+    }
+    _deadline = now + timeout;
+    ++stats.probes;
+    return _probe;
+}
+
+void rtype::srv::PathMtu::sent(const uint32_t seq) noexcept
+{
+    _probe_seq = seq;
+    _outstanding = true;
+}
+
+void rtype::srv::PathMtu::acknowledge(const uint32_t ackBase, const uint32_t ackBits, const unsigned width, const Clock::time_point now,
+    Stats &stats) noexcept
+{
+    if (!_outstanding) {
+        return;
+    }
+    // Bit i of ackBits acknowledges ackBase - 1 - i.
+    const uint32_t behind = ackBase - _probe_seq;
+    if (behind != 0 && (behind > (std::min) (width, 32U) || (ackBits & (1U << (behind - 1))) == 0)) {
+        return;
+    }
+    _outstanding = false;
+    _losses = 0;
+    ++stats.confirmed;
+    _mtu = _probe;
+    _probe = 0;
+    if (_phase == Phase::CONFIRM) {
+        _phase = Phase::DONE;
+        _confirm = now + CONFIRM_INTERVAL;
+    }
+}
+
+uint16_t rtype::srv::PathMtu::mtu() const noexcept
+{
+    return _mtu;
+}
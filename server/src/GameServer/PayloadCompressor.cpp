@@ -0,0 +1,115 @@
+#include <RTypeSrv/Exception.hpp>
+#include <RTypeSrv/PayloadCompressor.hpp>
+#include <algorithm>
+
+#if defined(RTYPE_SRV_HAS_ZSTD)
+    #include <zstd.h>
+
+/**
+ * @brief The zstd state, kept out of the header so builds without zstd still see the class.
+ */
+struct rtype::srv::PayloadCompressor::Impl {
+        ZSTD_CCtx *cctx = nullptr;
+        ZSTD_DCtx *dctx = nullptr;
+        ZSTD_CDict *cdict = nullptr;
+        ZSTD_DDict *ddict = nullptr;
+
+        ~Impl() noexcept
+        {
+            ZSTD_freeCCtx(cctx);
+            ZSTD_freeDCtx(dctx);
+            ZSTD_freeCDict(cdict);
+            ZSTD_freeDDict(ddict);
+        }
+};
+
+rtype::srv::PayloadCompressor::PayloadCompressor(const std::size_t minSaving, const int level)
+    : _impl(std::make_unique<Impl>()), _min_saving(minSaving)
+{
+    const std::span<const uint8_t> dict = dictionary();
+    if (ZSTD_getDictID_fromDict(dict.data(), dict.size()) != DICTIONARY_ID) {
+        throw Exception("PayloadCompressor", "The shipped dictionary is not version ", DICTIONARY_ID);
+    }
+    _impl->cctx = ZSTD_createCCtx();
+    _impl->dctx = ZSTD_createDCtx();
+    _impl->cdict = ZSTD_createCDict(dict.data(), dict.size(), level);
+    _impl->ddict = ZSTD_createDDict(dict.data(), dict.size());
+    if (_impl->cctx == nullptr || _impl->dctx == nullptr || _impl->cdict == nullptr || _impl->ddict == nullptr) {
+        throw Exception("PayloadCompressor", "Could not create the zstd contexts");
+    }
+    // Every byte counts at these sizes: no checksum (UDP has one), but keep the dictionary id and the content size.
+    ZSTD_CCtx_setParameter(_impl->cctx, ZSTD_c_checksumFlag, 0);
+    ZSTD_CCtx_setParameter(_impl->cctx, ZSTD_c_dictIDFlag, 1);
+    ZSTD_CCtx_setParameter(_impl->cctx, ZSTD_c_contentSizeFlag, 1);
+    ZSTD_CCtx_refCDict(_impl->cctx, _impl->cdict);
+}
+
+rtype::srv::PayloadCompressor::~PayloadCompressor() noexcept = default;
+
+bool rtype::srv::PayloadCompressor::available() noexcept
+{
+    return true;
+}
+
+std::size_t rtype::srv::PayloadCompressor::compress(const std::span<const uint8_t> payload, const std::span<uint8_t> out,
+    Stats &stats) noexcept
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t size = 0;
+    if (payload.size() > _min_saving) {
+        // A frame that does not fit in the budget fails with dstSize_tooSmall, which is the "does not pay" answer.
+        const std::size_t budget = (std::min) (out.size(), payload.size() - _min_saving);
+        const std::size_t ret = ZSTD_compress2(_impl->cctx, out.data(), budget, payload.data(), payload.size());
+        size = ZSTD_isError(ret) ? 0 : ret;
+    }
+    stats.busy += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    ++stats.payloads;
+    stats.bytes_in += payload.size();
+    stats.bytes_out += size != 0 ? size : payload.size();
+    if (size != 0) {
+        ++stats.compressed;
+    }
+    return size;
+}
+
+std::optional<std::size_t> rtype::srv::PayloadCompressor::decompress(const std::span<const uint8_t> frame,
+    const std::span<uint8_t> out) noexcept
+{
+    if (ZSTD_getDictID_fromFrame(frame.data(), frame.size()) != DICTIONARY_ID) {
+        return std::nullopt;
+    }
+    const std::size_t ret = ZSTD_decompress_usingDDict(_impl->dctx, out.data(), out.size(), frame.data(), frame.size(), _impl->ddict);
+    if (ZSTD_isError(ret)) {
+        return std::nullopt;
+    }
+    return ret;
+}
+
+#else
+
+struct rtype::srv::PayloadCompressor::Impl {
+};
+
+rtype::srv::PayloadCompressor::PayloadCompressor(const std::size_t minSaving, const int) : _min_saving(minSaving)
+{
+    throw Exception("PayloadCompressor", "The server was built without zstd support");
+}
+
+rtype::srv::PayloadCompressor::~PayloadCompressor() noexcept = default;
+
+bool rtype::srv::PayloadCompressor::available() noexcept
+{
+    return false;
+}
+
+std::size_t rtype::srv::PayloadCompressor::compress(const std::span<const uint8_t>, const std::span<uint8_t>, Stats &) noexcept
+{
+    return 0;
+}
+
+std::optional<std::size_t> rtype::srv::PayloadCompressor::decompress(const std::span<const uint8_t>, const std::span<uint8_t>) noexcept
+{
+    return std::nullopt;
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include <RTypeSrv/PacketWriter.hpp>
+#include <RTypeSrv/Priority.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Tells whether two states of an entity differ, comparing the fields bitwise as writeDelta() does.
+ */
+bool changed(const SnapshotEntity &a, const SnapshotEntity &b) noexcept
+{
+    return std::bit_cast<uint32_t>(a.x) != std::bit_cast<uint32_t>(b.x) || std::bit_cast<uint32_t>(a.y) != std::bit_cast<uint32_t>(b.y);
+}
+
+/**
+ * @brief Finds an entity by id in a state sorted by id.
+ */
+const SnapshotEntity *find(const std::span<const SnapshotEntity> state, const uint32_t id) noexcept
+{
+    const auto it = std::ranges::lower_bound(state, id, {}, &SnapshotEntity::id);
+    return it != state.end() && it->id == id ? &*it : nullptr;
+}
+
+}// namespace
+
+std::size_t rtype::srv::PriorityAccumulator::schedule(const SnapshotHistory::Entry *baseline, const std::span<const SnapshotEntity> target,
+    const Scene &scene, const Budget &budget, std::vector<SnapshotEntity> &out)
+{
+    const std::span<const SnapshotEntity> base = baseline != nullptr ? std::span<const SnapshotEntity>(baseline->entities)
+                                                                     : std::span<const SnapshotEntity>{};
+    const SnapshotEntity *player = scene.focus ? find(target, *scene.focus) : nullptr;
+
+    // Every difference with the baseline is a change, priced at what it accumulated so far plus this tick's rate.
+    _changes.clear();
+    std::size_t b = 0;
+    std::size_t t = 0;
+    while (b < base.size() || t < target.size()) {
+        if (t == target.size() || (b < base.size() && base[b].id < target[t].id)) {
+            _changes.push_back({.id = base[b].id, .priority = _accumulated(base[b].id) + _rate(base[b], scene, player)});
+            ++b;
+        } else if (b == base.size() || target[t].id < base[b].id) {
+            _changes.push_back({.id = target[t].id, .priority = _accumulated(target[t].id) + _rate(target[t], scene, player)});
+            ++t;
+        } else {
+            if (changed(base[b], target[t])) {
+                _changes.push_back({.id = target[t].id, .priority = _accumulated(target[t].id) + _rate(target[t], scene, player)});
+            }
+            ++b;
+            ++t;
+        }
+    }
+    _order.resize(_changes.size());
+    for (std::size_t i = 0; i < _order.size(); ++i) {
+        _order[i] = i;
+    }
+    std::ranges::sort(_order, [this](const std::size_t l, const std::size_t r) {
+        return _changes[l].priority != _changes[r].priority ? _changes[l].priority > _changes[r].priority : _changes[l].id < _changes[r].id;
+    });
+    for (std::size_t rank = 0; rank < _order.size(); ++rank) {
+        _changes[_order[rank]].rank = rank;
+    }
+
+    // The size grows with the changes taken: search the most that fit, trying them all first as it is the usual case.
+    std::size_t taken = _changes.size();
+    _build(base, target, taken, out);
+    if (taken > 0 && !_fits(baseline, out, budget)) {
+        std::size_t low = 0;
+        std::size_t high = taken - 1;
+        while (low < high) {
+            const std::size_t middle = (low + high + 1) / 2;
+            _build(base, target, middle, out);
+            if (_fits(baseline, out, budget)) {
+                low = middle;
+            } else {
+                high = middle - 1;
+            }
+        }
+        taken = low;
+        _build(base, target, taken, out);
+    }
+
+    _next.clear();
+    for (const Change &change : _changes) {
+        if (change.rank >= taken) {
+            _next.push_back({.id = change.id, .priority = change.priority});
+        }
+    }
+    _accumulators.swap(_next);
+    return _changes.size() - taken;
+}
+
+float rtype::srv::PriorityAccumulator::_rate(const SnapshotEntity &entity, const Scene &scene, const SnapshotEntity *player) const noexcept
+{
+    float rate = 1.0f;
+    if (std::ranges::find(scene.players, entity.id, &PlayerEntity::entity) != scene.players.end()) {
+        rate *= PLAYER_WEIGHT;
+    }
+    if (const SnapshotEntity *before = find(scene.previous, entity.id)) {
+        if (const float speed = std::hypot(entity.x - before->x, entity.y - before->y); std::isfinite(speed)) {
+            rate *= 1.0f + speed / SPEED_SCALE;
+        }
+    }
+    if (player != nullptr) {
+        if (const float distance = std::hypot(entity.x - player->x, entity.y - player->y); std::isfinite(distance)) {
+            rate *= DISTANCE_SCALE / (DISTANCE_SCALE + distance);
+        }
+    }
+    return rate;
+}
+
+float rtype::srv::PriorityAccumulator::_accumulated(const uint32_t id) const noexcept
+{
+    const auto it = std::ranges::lower_bound(_accumulators, id, {}, &Accumulator::id);
+    return it != _accumulators.end() && it->id == id ? it->priority : 0.0f;
+}
+
+void rtype::srv::PriorityAccumulator::_build(const std::span<const SnapshotEntity> baseline, const std::span<const SnapshotEntity> target,
+    const std::size_t taken, std::vector<SnapshotEntity> &out) const
+{
+    // Walks the states as schedule() did, meeting the changes in the same order.
+    out.clear();
+    std::size_t c = 0;
+    std::size_t b = 0;
+    std::size_t t = 0;
+    while (b < baseline.size() || t < target.size()) {
+        if (t == target.size() || (b < baseline.size() && baseline[b].id < target[t].id)) {
+            if (_changes[c++].rank >= taken) {
+                out.push_back(baseline[b]);
+            }
+            ++b;
+        } else if (b == baseline.size() || target[t].id < baseline[b].id) {
+            if (_changes[c++].rank < taken) {
+                out.push_back(target[t]);
+            }
+            ++t;
+        } else {
+            out.push_back(changed(baseline[b], target[t]) && _changes[c++].rank >= taken ? baseline[b] : target[t]);
+            ++b;
+            ++t;
+        }
+    }
+}
+
+bool rtype::srv::PriorityAccumulator::_fits(const SnapshotHistory::Entry *baseline, const std::span<const SnapshotEntity> state,
+    const Budget &budget)
+{
+    if (baseline == nullptr && budget.encoding == snapshot::Encoding::FLOAT) {
+        return snapshot::keyframeSize(state.size()) <= budget.bytes;
+    }
+    if (baseline == nullptr) {
+        _scratch.resize((std::max) (budget.bytes, snapshot::quantizedKeyframeMaxSize(state.size())));
+        PacketWriter out(_scratch);
+        snapshot::writeQuantizedKeyframe(out, state, budget.precision);
+        return out.size() <= budget.bytes;
+    }
+    _scratch.resize(budget.bytes);
+    PacketWriter out(_scratch);
+    if (budget.encoding == snapshot::Encoding::QUANTIZED) {
+        return snapshot::writeQuantizedDelta(out, baseline->entities, state, budget.precision);
+    }
+    return snapshot::writeDelta(out, baseline->entities, state);
+}
@@ -1,52 +1,320 @@
-#include <RTypeNet/Recv.hpp>
 #include <RTypeSrv/GameServer.hpp>
 #include <RTypeSrv/Utils/IPToStr.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
-#include <cerrno>
-#include <cstring>
-#include <filesystem>
 #include <iomanip>
 #include <ranges>
 #include <sstream>
+#include <string>
 
-void rtype::srv::GameServer::_recvPackets(const network::NFDS i)
+/**
+ * @brief Drains every pending datagram from the UDP socket into the receive ring.
+ *
+ * With the io_uring engine the datagrams were already received by the kernel;
+ * this only reaps their completions (and those of finished sends).
+ *
+ * @param handle The UDP socket reported readable by the reactor.
+ */
+void rtype::srv::GameServer::_recvPackets(const network::Handle handle)
 {
-    const auto handle = _fds[i].handle;
-    std::vector<uint8_t> buffer(1024);
-    network::Endpoint endpoint;
-
-    if (const ssize_t ret = recvfrom(handle, buffer.data(), static_cast<network::BufLen>(buffer.size()), 0, endpoint); ret > 0) {
-        if (::memcmp(endpoint.ip.data() + rtype::network::IPv4Offset, "\0\0\0\0", 4) == 0) {
-            const uint8_t loopback[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 0x7F, 0, 0, 1};
-            std::copy(std::begin(loopback), std::end(loopback), endpoint.ip.begin());
+    std::span<const DatagramRing::View> views;
+    if (_uring) {
+        _uring->clear();
+        if (_uring->drain() == 0) {
+            return;
+        }
+        views = _uring->views();
+    } else {
+        _recv_ring.clear();
+        if (_recv_ring.drain(handle) == 0) {
+            return;
         }
-        _client_endpoints[handle] = endpoint;
-        const std::pair<std::array<uint8_t, 16>, uint16_t> ep_key = {endpoint.ip, endpoint.port};
-        _recv_packets[ep_key].push_back(std::vector<uint8_t>(buffer.begin(), buffer.begin() + ret));
+        views = _recv_ring.views();
+    }
+    for (const auto &view : views) {
+        const IP ep_key = {view.ip, view.port};
+        _client_endpoints[handle] = network::Endpoint{view.ip, view.port};
         _endpoint_to_handle[ep_key] = handle;
-        {
-            std::ostringstream ss;
-            ss << std::hex << std::setfill('0');
-            const size_t len = static_cast<size_t>(ret);
-            const size_t show = std::min<size_t>(len, 64);
-            for (size_t j = 0; j < show; ++j) {
-                ss << std::setw(2) << static_cast<int>(buffer[j]);
-                if (j + 1 < show)
-                    ss << ' ';
-            }
-            rtype::srv::utils::clog("IN  UDP handle=", handle, " from=", utils::ipToStr(endpoint.ip), ":", endpoint.port, " len=", len,
-                " hex=", ss.str());
-        }
-
-    } else if (ret < 0) {
-        if (errno != EAGAIN && errno != EWOULDBLOCK) {
-#if defined(_WIN32)
-            char error_buf[256];
-            strerror_s(error_buf, sizeof(error_buf), errno);
-            throw std::runtime_error("recvfrom error: " + std::string(error_buf));
-#else
-            throw std::runtime_error("recvfrom error: " + std::string(strerror(errno)));
+#if defined(DEBUG)
+        std::ostringstream ss;
+        ss << std::hex << std::setfill('0');
+        const size_t show = std::min<size_t>(view.data.size(), 64);
+        for (size_t j = 0; j < show; ++j) {
+            ss << std::setw(2) << static_cast<int>(view.data[j]);
+            if (j + 1 < show)
+                ss << ' ';
+        }
+        utils::clog("IN  UDP handle=", handle, " from=", utils::ipToStr(view.ip), ":", view.port, " len=", view.data.size(),
+            " hex=", ss.str());
 #endif
+    }
+}
+
+/**
+ * @brief Logs the socket counters: UDP receive and send, the gateway link, io_uring and the packet pool.
+ */
+void rtype::srv::GameServer::_reportIo()
+{
+    if (const auto &rs = _recv_ring.stats(); rs.syscalls > 0 || rs.drops > 0) {
+        utils::cout("[", _base_endpoint.port, "] UDP recv: ", rs.datagrams, " datagrams in ", rs.syscalls, " syscalls (",
+            rs.syscalls > 0 ? static_cast<double>(rs.datagrams) / static_cast<double>(rs.syscalls) : 0.0, " per syscall, max batch ",
+            rs.max_batch, ", ", rs.coalesced, " GRO buffers, ", rs.drops, " kernel drops)");
+    }
+    if (const auto &ss = _send_queue.stats(); ss.syscalls > 0 || ss.would_block > 0 || ss.errors > 0) {
+        utils::cout("[", _base_endpoint.port, "] UDP send: ", ss.datagrams, " datagrams in ", ss.syscalls, " syscalls (",
+            ss.syscalls > 0 ? static_cast<double>(ss.datagrams) / static_cast<double>(ss.syscalls) : 0.0, " per syscall, max batch ",
+            ss.max_batch, ", ", ss.segmented, " GSO messages, ", ss.would_block, " EAGAIN, ", ss.partial, " partial, ", ss.errors,
+            " errors, ", _send_queue.size(), " pending)");
+    }
+    if (_tcp_stats.would_block > 0 || _tcp_stats.partial > 0 || _tcp_stats.errors > 0) {
+        utils::cout("[", _base_endpoint.port, "] TCP gateway link: ", _tcp_stats.would_block, " EAGAIN, ", _tcp_stats.partial,
+            " partial writes, ", _tcp_stats.errors, " errors");
+    }
+    _tcp_stats = {};
+    if (_uring) {
+        if (const auto &us = _uring->stats(); us.submits > 0 || us.recv_datagrams > 0 || us.recv_drops > 0) {
+            utils::cout("[", _base_endpoint.port, "] io_uring: ", us.recv_datagrams, " datagrams in, ", us.send_datagrams,
+                " out in ", us.submits, " submits (", us.send_errors, " send errors, ", us.recv_rearms, " receive re-arms, ",
+                us.recv_drops, " kernel drops)");
         }
+        _uring->resetStats();
+    }
+    if (const auto &ps = _packet_pool.stats(); ps.acquired > 0) {
+        utils::cout("[", _base_endpoint.port, "] packet pool: ", ps.acquired, " acquired, ", ps.in_use, "/", ps.capacity, " in use, ",
+            ps.slabs, " slab allocations");
+    }
+    _packet_pool.resetStats();
+}
+
+/**
+ * @brief Logs the PING / PONG RTT of the clients, and how long datagrams and inputs wait in the server.
+ */
+void rtype::srv::GameServer::_reportLatency()
+{
+    if (_server_delay.samples > 0) {
+        const auto avg_us = [](const DelayStats &d) {
+            return d.samples > 0 ? static_cast<double>(d.total.count()) / static_cast<double>(d.samples) / 1000.0 : 0.0;
+        };
+        const auto max_us = [](const DelayStats &d) { return std::chrono::duration_cast<std::chrono::microseconds>(d.max).count(); };
+        std::chrono::microseconds rtt{0};
+        std::size_t clients = 0;
+        for (const auto &metrics : _latency_metrics | std::views::values) {
+            if (metrics.samples > 0) {
+                rtt += metrics.avg_rtt;
+                ++clients;
+            }
+        }
+        const auto rtt_avg = clients > 0 ? rtt.count() / static_cast<long>(clients) : 0;
+        utils::cout("[", _base_endpoint.port, "] latency: RTT ", rtt_avg, " us avg over ", clients, " clients, server queueing ",
+            avg_us(_server_delay), " us avg / ", max_us(_server_delay), " us max, input age ", avg_us(_input_age), " us avg / ",
+            max_us(_input_age), " us max (", _recv_ring.stats().stamped, " kernel rx stamps, ", _send_queue.stats().tx_stamps,
+            " kernel tx stamps)");
+    }
+    _server_delay = {};
+    _input_age = {};
+}
+
+/**
+ * @brief Logs the UDP and gateway commands handled and rejected.
+ */
+void rtype::srv::GameServer::_reportCommands()
+{
+    if (const std::string udp = UDP_COMMANDS.summary(_udp_commands); !udp.empty()) {
+        utils::cout("[", _base_endpoint.port, "] UDP commands: ", udp);
+    }
+    if (const std::string tcp = TCP_COMMANDS.summary(_tcp_commands); !tcp.empty()) {
+        utils::cout("[", _base_endpoint.port, "] gateway commands: ", tcp);
+    }
+    _udp_commands = {};
+    _tcp_commands = {};
+}
+
+/**
+ * @brief Logs the snapshots sent, their area of interest and the keyframe compression of each game.
+ */
+void rtype::srv::GameServer::_reportSnapshots()
+{
+    if (_snapshot_stats.keyframes > 0 || _snapshot_stats.deltas > 0) {
+        const auto avg = [](const uint64_t bytes, const uint64_t n) { return n > 0 ? bytes / n : 0; };
+        const uint64_t bytes = _snapshot_stats.keyframe_bytes + _snapshot_stats.delta_bytes;
+        utils::cout("[", _base_endpoint.port, "] snapshots: ", _snapshot_stats.keyframes, " keyframes (",
+            avg(_snapshot_stats.keyframe_bytes, _snapshot_stats.keyframes), " B avg, ", _snapshot_stats.fragmented, " fragmented), ",
+            _snapshot_stats.deltas, " deltas (",
+            avg(_snapshot_stats.delta_bytes, _snapshot_stats.deltas), " B avg), ", _snapshot_stats.quantized, " quantized, ",
+            _snapshot_stats.entities > 0 ? static_cast<double>(bytes) / static_cast<double>(_snapshot_stats.entities) : 0.0,
+            " B per entity");
+        utils::cout("[", _base_endpoint.port, "] interest: ", _snapshot_stats.entities, " of ", _snapshot_stats.considered,
+            " entities sent, ", _snapshot_stats.entered, " entered a view, ", _snapshot_stats.deferred, " changes deferred by the budget, ",
+            _snapshot_stats.throttled, " snapshots skipped by the rate");
+    }
+    for (const auto &[game_id, cs] : _compression_stats) {
+        if (cs.payloads == 0) {
+            continue;
+        }
+        utils::cout("[", _base_endpoint.port, "] game ", game_id, " compression: ", cs.compressed, "/", cs.payloads,
+            " keyframes compressed, ratio ", static_cast<double>(cs.bytes_out) / static_cast<double>(cs.bytes_in), ", ",
+            static_cast<double>(cs.busy.count()) / static_cast<double>(cs.payloads) / 1000.0, " us per keyframe");
+    }
+    _snapshot_stats = {};
+    _compression_stats.clear();
+}
+
+/**
+ * @brief Logs the fragmented messages received.
+ */
+void rtype::srv::GameServer::_reportFragments()
+{
+    if (const auto &fs = _fragment_stats; fs.reassembled > 0 || fs.expired > 0 || fs.rejected > 0) {
+        utils::cout("[", _base_endpoint.port, "] inbound fragments: ", fs.reassembled, " messages reassembled, ", fs.expired,
+            " expired, ", fs.rejected, " rejected (", _fragment_buffers.size(), " pending, ", _fragment_bytes, " B)");
+    }
+    _fragment_stats = {};
+}
+
+/**
+ * @brief Logs the reliable channels: packets acknowledged, lost and retransmitted, and the average SRTT.
+ */
+void rtype::srv::GameServer::_reportReliability()
+{
+    if (const auto &rs = _reliable_stats; rs.reliable > 0 || rs.retransmits > 0 || rs.duplicates > 0 || rs.reordered > 0) {
+        std::chrono::microseconds srtt{0};
+        std::size_t sampled = 0;
+        std::size_t in_flight = 0;
+        for (const ReliableChannel &channel : _ep_channels | std::views::values) {
+            if (channel.srtt().count() > 0) {
+                srtt += channel.srtt();
+                ++sampled;
+            }
+            in_flight += channel.unacked();
+        }
+        utils::cout("[", _base_endpoint.port, "] reliability: ", rs.reliable, "/", rs.sent, " packets reliable (", rs.acked, " acked, ",
+            in_flight, " in flight), ", rs.lost, " lost, ", rs.retransmits, " retransmits (", rs.fast_retransmits,
+            " fast), ", rs.given_up, " given up, SRTT ", sampled > 0 ? srtt.count() / static_cast<long>(sampled) : 0,
+            " us avg; received ", rs.duplicates, " duplicates, ", rs.reordered, " RO messages early (", rs.skipped, " skipped)");
+    }
+    _reliable_stats = {};
+}
+
+/**
+ * @brief Logs the send rates of the clients, and each client held below udp_max_rate.
+ */
+void rtype::srv::GameServer::_reportCongestion()
+{
+    if (!_ep_congestion.empty()) {
+        const auto &cs = _congestion_stats;
+        std::size_t rate = 0;
+        std::size_t lowest = _udp.max_rate;
+        std::size_t window = 0;
+        for (const CongestionController &controller : _ep_congestion | std::views::values) {
+            rate += controller.rate();
+            lowest = (std::min) (lowest, controller.rate());
+            window += controller.window();
+        }
+        utils::cout("[", _base_endpoint.port, "] congestion: ", _ep_congestion.size(), " clients at ", rate / _ep_congestion.size(),
+            " B/s avg (", lowest, " lowest), window ", window / _ep_congestion.size(), " B avg; cuts on ", cs.losses, " losses, ",
+            cs.delays, " delays, ", cs.timeouts, " timeouts; ", cs.held, " flushes held");
+        for (const auto &[endpoint, controller] : _ep_congestion) {
+            const auto client = _endpoint_to_client.find(endpoint);
+            if (controller.rate() >= _udp.max_rate || client == _endpoint_to_client.end()) {
+                continue;
+            }
+            const auto channel = _ep_channels.find(endpoint);
+            utils::cout("[", _base_endpoint.port, "] client ", client->second, " congestion: ", controller.rate(), " B/s, window ",
+                controller.window(), " B, SRTT ", channel != _ep_channels.end() ? channel->second.srtt().count() : 0, " us");
+        }
+    }
+    _congestion_stats = {};
+}
+
+/**
+ * @brief Logs the path MTUs of the clients and the probes sent.
+ */
+void rtype::srv::GameServer::_reportPathMtu()
+{
+    if (!_ep_mtu.empty()) {
+        const auto &ms = _mtu_stats;
+        std::size_t total = 0;
+        uint16_t lowest = GameServerUDPPacketParser::MAX_PROBED_SIZE;
+        uint16_t highest = 0;
+        for (const PathMtu &path : _ep_mtu | std::views::values) {
+            total += path.mtu();
+            lowest = (std::min) (lowest, path.mtu());
+            highest = (std::max) (highest, path.mtu());
+        }
+        utils::cout("[", _base_endpoint.port, "] path mtu: ", _ep_mtu.size(), " clients at ", total / _ep_mtu.size(), " B avg (", lowest,
+            "-", highest, "); ", ms.probes, " probes, ", ms.confirmed, " confirmed, ", ms.lost, " lost, ", ms.black_holes, " black holes");
+    }
+    _mtu_stats = {};
+}
+
+/**
+ * @brief Logs the packets sealed and opened, their cost, and the packets dropped.
+ */
+void rtype::srv::GameServer::_reportEncryption()
+{
+    const auto &es = _encryption_stats;
+    if (const auto &cs = _cipher.stats();
+        cs.sealed > 0 || cs.opened > 0 || cs.rejected > 0 || es.replayed > 0 || es.downgraded > 0 || es.keyless > 0) {
+        const uint64_t packets = (std::max) (cs.sealed + cs.opened + cs.rejected, uint64_t{1});
+        utils::cout("[", _base_endpoint.port, "] encryption: ", _ep_sessions.size(), " clients, ", cs.sealed, " packets sealed, ",
+            cs.opened, " opened, ", static_cast<double>(cs.busy.count()) / static_cast<double>(packets) / 1000.0,
+            " us per packet; dropped ", cs.rejected, " forged, ", es.replayed, " replayed, ", es.downgraded, " in clear, ", es.keyless,
+            " without a key");
+    }
+    _cipher.resetStats();
+    _encryption_stats = {};
+}
+
+/**
+ * @brief Logs how many messages the outboxes coalesced per datagram.
+ */
+void rtype::srv::GameServer::_reportOutbox()
+{
+    if (const auto &os = _outbox_stats; os.messages > 0) {
+        utils::cout("[", _base_endpoint.port, "] outbound: ", os.messages, " messages in ", os.datagrams, " datagrams (",
+            static_cast<double>(os.messages) / static_cast<double>(os.datagrams), " per datagram), ", os.batched, " batched, ", os.saved,
+            " header bytes saved");
+    }
+    _outbox_stats = {};
+}
+
+/**
+ * @brief Logs how busy the reactor loop was.
+ */
+void rtype::srv::GameServer::_reportLoop()
+{
+    if (const auto &ls = _reactor.stats(); ls.iterations > 0) {
+        const auto total = ls.idle + ls.busy;
+        utils::cout("[", _base_endpoint.port, "] loop: ", ls.iterations, " iterations, busy ",
+            total.count() > 0 ? 100.0 * static_cast<double>(ls.busy.count()) / static_cast<double>(total.count()) : 0.0, "% (",
+            static_cast<double>(ls.busy.count()) / static_cast<double>(ls.iterations) / 1000.0, " us busy / ",
+            static_cast<double>(ls.idle.count()) / static_cast<double>(ls.iterations) / 1000.0, " us idle per iteration)");
+    }
+    _reactor.resetStats();
+}
+
+/**
+ * @brief Periodically logs the per-worker network counters, one line per subsystem, and resets them.
+ */
+void rtype::srv::GameServer::_reportStats()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    if (now - _last_stats < STATS_INTERVAL) {
+        return;
     }
+    _last_stats = now;
+    _reportIo();
+    _reportLatency();
+    _reportCommands();
+    _reportSnapshots();
+    _reportFragments();
+    _reportReliability();
+    _reportCongestion();
+    _reportPathMtu();
+    _reportEncryption();
+    _reportOutbox();
+    _reportLoop();
+    // Read by both _reportIo() and _reportLatency() (the kernel timestamps).
+    _recv_ring.resetStats();
+    _send_queue.resetStats();
 }
@@ -0,0 +1,316 @@
+#include <RTypeSrv/ReliableChannel.hpp>
+#include <algorithm>
+
+void rtype::srv::ReliableChannel::reset() noexcept
+{
+    *this = ReliableChannel{};
+}
+
+rtype::srv::ReliableChannel::Receipt rtype::srv::ReliableChannel::receive(const GspHeaderView &packet, const Clock::time_point now,
+    Stats &stats)
+{
+    _peer_version = packet.version();
+    _last_received = now;
+    _acknowledge(packet.ackBase(), packet.ackBits(), packet.ackWidth(), now, stats);
+    const uint32_t seq = packet.seq();
+    const Receipt receipt = _record(seq);
+    if (receipt == Receipt::DUPLICATE) {
+        ++stats.duplicates;
+    }
+    if (packet.hasFlag(GSPcol::FLAGS::RELIABLE) && _pending_acks.size() < MAX_PENDING_ACKS
+        && std::ranges::find(_pending_acks, seq) == _pending_acks.end()) {
+        _pending_acks.push_back(seq);
+    }
+    return receipt;
+}
+
+void rtype::srv::ReliableChannel::acknowledge(const uint32_t seq, const Clock::time_point now, Stats &stats) noexcept
+{
+    _ack(seq, now, stats);
+}
+
+rtype::srv::GameServerUDPPacketParser::HeaderFields rtype::srv::ReliableChannel::header(const GSPcol::CHANNEL channel) const noexcept
+{
+    return {.seq = _next_seq,
+        .ack_base = _recv_base,
+        .ack_bits = _recv_bits,
+        .order = channel == GSPcol::CHANNEL::RO ? _next_order : uint16_t{0},
+        .version = _peer_version};
+}
+
+void rtype::srv::ReliableChannel::sent(const std::span<const PacketBuffer> message, const Clock::time_point now, Stats &stats)
+{
+    if (message.empty()) {
+        return;
+    }
+    if (const auto first = GspHeaderView::parse(message.front().span()); first && first->channel() == GSPcol::CHANNEL::RO) {
+        ++_next_order;
+    }
+    for (const PacketBuffer &packet : message) {
+        InFlight &slot = _in_flight[_next_seq % WINDOW];
+        if (slot.packet) {
+            ++stats.given_up;
+            _release(slot);
+        }
+        slot = InFlight{};
+        slot.seq = _next_seq++;
+        slot.first_sent = now;
+        slot.transmissions = 1;
+        slot.valid = true;
+        ++stats.sent;
+        if (const auto header = GspHeaderView::parse(packet.span()); header && header->hasFlag(GSPcol::FLAGS::RELIABLE)) {
+            slot.packet = packet;
+            slot.deadline = now + _rto;
+            ++_unacked;
+            ++stats.reliable;
+        }
+    }
+    // The headers just sent acknowledge every packet of the receive window.
+    const unsigned width = _ackWidth();
+    std::erase_if(_pending_acks, [&](const uint32_t seq) { return _received && _recv_base - seq <= width; });
+}
+
+void rtype::srv::ReliableChannel::probed(const PacketBuffer &probe, const Clock::time_point now, Stats &stats)
+{
+    sent(std::span<const PacketBuffer>(&probe, 1), now, stats);
+    _in_flight[(_next_seq - 1) % WINDOW].probe = true;
+}
+
+std::size_t rtype::srv::ReliableChannel::retransmit(const Clock::time_point now, std::vector<PacketBuffer> &out, Stats &stats)
+{
+    if (_unacked == 0) {
+        return 0;
+    }
+    std::size_t n = 0;
+    for (InFlight &slot : _in_flight) {
+        if (!slot.packet || (!slot.fast_pending && now < slot.deadline)) {
+            continue;
+        }
+        if (slot.transmissions > MAX_RETRANSMITS) {
+            ++stats.given_up;
+            _release(slot);
+            continue;
+        }
+        out.push_back(slot.packet);
+        ++n;
+        ++stats.retransmits;
+        if (slot.fast_pending) {
+            ++stats.fast_retransmits;
+            slot.fast_pending = false;
+            slot.fast_done = true;
+        }
+        slot.deadline = now + (std::min) (MAX_RTO, _rto * (1U << slot.transmissions));
+        ++slot.transmissions;
+    }
+    return n;
+}
+
+void rtype::srv::ReliableChannel::takeAcks(std::vector<uint32_t> &out)
+{
+    out.assign(_pending_acks.begin(), _pending_acks.end());
+    _pending_acks.clear();
+}
+
+rtype::srv::ReliableChannel::Delivery rtype::srv::ReliableChannel::order(const GspHeaderView &message, const Clock::time_point now,
+    Stats &stats)
+{
+    if (message.version() < GameServerUDPPacketParser::EXTENDED_HEADER_VERSION || message.channel() != GSPcol::CHANNEL::RO) {
+        return Delivery::DELIVER;
+    }
+    const uint16_t order = message.order();
+    const auto ahead = static_cast<uint16_t>(order - _expected_order);
+    if (ahead >= 0x8000) {
+        return Delivery::STALE;
+    }
+    if (ahead == 0) {
+        ++_expected_order;
+        return Delivery::DELIVER;
+    }
+    ++stats.reordered;
+    if (ahead >= ORDER_WINDOW) {
+        // The gap is wider than what can be held: the client gave up on those messages, and so does the channel.
+        stats.skipped += ahead;
+        _held = {};
+        _held_count = 0;
+        _expected_order = static_cast<uint16_t>(order + 1);
+        return Delivery::DELIVER;
+    }
+    Held &slot = _held[order % ORDER_WINDOW];
+    if (slot.valid) {
+        return Delivery::STALE;
+    }
+    slot.message.assign(message.bytes().begin(), message.bytes().end());
+    slot.since = now;
+    slot.order = order;
+    slot.valid = true;
+    ++_held_count;
+    return Delivery::HELD;
+}
+
+std::optional<std::vector<uint8_t>> rtype::srv::ReliableChannel::release(const Clock::time_point now, Stats &stats)
+{
+    if (_held_count == 0) {
+        return std::nullopt;
+    }
+    Held *next = &_held[_expected_order % ORDER_WINDOW];
+    if (!next->valid) {
+        // Skip the gap to the first message held, once the oldest one waited ORDER_TIMEOUT for it.
+        Held *first = nullptr;
+        Clock::time_point oldest = now;
+        for (std::size_t i = 1; i < ORDER_WINDOW; ++i) {
+            Held &held = _held[(_expected_order + i) % ORDER_WINDOW];
+            if (held.valid) {
+                first = first != nullptr ? first : &held;
+                oldest = (std::min) (oldest, held.since);
+            }
+        }
+        if (first == nullptr || now - oldest < ORDER_TIMEOUT) {
+            return std::nullopt;
+        }
+        stats.skipped += static_cast<uint16_t>(first->order - _expected_order);
+        _expected_order = first->order;
+        next = first;
+    }
+    std::vector<uint8_t> message = std::move(next->message);
+    *next = Held{};
+    --_held_count;
+    ++_expected_order;
+    return message;
+}
+
+std::chrono::microseconds rtype::srv::ReliableChannel::rto() const noexcept
+{
+    return _rto;
+}
+
+std::chrono::microseconds rtype::srv::ReliableChannel::srtt() const noexcept
+{
+    return _srtt;
+}
+
+std::size_t rtype::srv::ReliableChannel::unacked() const noexcept
+{
+    return _unacked;
+}
+
+const rtype::srv::ReliableChannel::Feedback &rtype::srv::ReliableChannel::feedback() const noexcept
+{
+    return _feedback;
+}
+
+bool rtype::srv::ReliableChannel::holding() const noexcept
+{
+    return _held_count > 0;
+}
+
+rtype::srv::ReliableChannel::Clock::time_point rtype::srv::ReliableChannel::lastReceived() const noexcept
+{
+    return _last_received;
+}
+
+void rtype::srv::ReliableChannel::_ack(const uint32_t seq, const Clock::time_point now, Stats &stats) noexcept
+{
+    InFlight &slot = _in_flight[seq % WINDOW];
+    if (!slot.valid || slot.seq != seq || slot.acked) {
+        return;
+    }
+    slot.acked = true;
+    ++_feedback.acked;
+    if (slot.transmissions == 1) {// Karn: the acknowledgement of a retransmitted packet could be for any copy
+        _sampleRtt(std::chrono::duration_cast<std::chrono::microseconds>(now - slot.first_sent));
+    }
+    if (slot.packet) {
+        ++stats.acked;
+        _release(slot);
+    }
+}
+
+void rtype::srv::ReliableChannel::_acknowledge(const uint32_t ackBase, const uint32_t ackBits, const unsigned width,
+    const Clock::time_point now, Stats &stats) noexcept
+{
+    _ack(ackBase, now, stats);
+    unsigned newer = 1;
+    for (unsigned i = 0; i < width; ++i) {
+        const uint32_t seq = ackBase - 1 - i;
+        if ((ackBits & (1U << i)) != 0) {
+            _ack(seq, now, stats);
+            ++newer;
+            continue;
+        }
+        if (newer < FAST_RETRANSMIT_THRESHOLD) {
+            continue;
+        }
+        InFlight &slot = _in_flight[seq % WINDOW];
+        if (!slot.valid || slot.seq != seq || slot.acked || slot.probe) {
+            continue;
+        }
+        if (!slot.lost) {
+            slot.lost = true;
+            ++_feedback.lost;
+            ++stats.lost;
+        }
+        if (slot.packet && !slot.fast_done) {
+            slot.fast_pending = true;
+        }
+    }
+}
+
+rtype::srv::ReliableChannel::Receipt rtype::srv::ReliableChannel::_record(const uint32_t seq) noexcept
+{
+    if (!_received) {
+        _received = true;
+        _recv_base = seq;
+        _recv_bits = 0;
+        return Receipt::NEW;
+    }
+    if (const uint32_t ahead = seq - _recv_base; ahead != 0 && ahead < 0x80000000U) {
+        if (ahead > 32) {
+            _recv_bits = 0;
+        } else if (ahead == 32) {
+            _recv_bits = 1U << 31;
+        } else {
+            _recv_bits = (_recv_bits << ahead) | (1U << (ahead - 1));
+        }
+        _recv_base = seq;
+        return Receipt::NEW;
+    }
+    const uint32_t behind = _recv_base - seq;
+    if (behind == 0) {
+        return Receipt::DUPLICATE;
+    }
+    if (behind > 32) {
+        return Receipt::TOO_OLD;
+    }
+    const uint32_t bit = 1U << (behind - 1);
+    if ((_recv_bits & bit) != 0) {
+        return Receipt::DUPLICATE;
+    }
+    _recv_bits |= bit;
+    return Receipt::NEW;
+}
+
+void rtype::srv::ReliableChannel::_sampleRtt(const std::chrono::microseconds rtt) noexcept
+{
+    if (!_rtt_sampled) {
+        _srtt = rtt;
+        _rttvar = rtt / 2;
+        _rtt_sampled = true;
+    } else {
+        const auto error = _srtt > rtt ? _srtt - rtt : rtt - _srtt;
+        _rttvar = (3 * _rttvar + error) / 4;
+        _srtt = (7 * _srtt + rtt) / 8;
+    }
+    _rto = std::clamp(_srtt + (std::max) (CLOCK_GRANULARITY, 4 * _rttvar), MIN_RTO, MAX_RTO);
+}
+
+void rtype::srv::ReliableChannel::_release(InFlight &slot) noexcept
+{
+    slot.packet = PacketBuffer{};
+    slot.fast_pending = false;
+    --_unacked;
+}
+
+unsigned rtype::srv::ReliableChannel::_ackWidth() const noexcept
+{
+    return _peer_version >= GameServerUDPPacketParser::EXTENDED_HEADER_VERSION ? 32 : 8;
+}
@@ -0,0 +1,125 @@
+#include <RTypeNet/Disconnect.hpp>
+#include <RTypeSrv/Exception.hpp>
+#include <RTypeSrv/ReusePortGroup.hpp>
+#include <RTypeSrv/Utils/IPToStr.hpp>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+    #include <RTypeSrv/Utils/SockAddr.hpp>
+    #include <linux/filter.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+/**
+ * @brief Opens a UDP socket with SO_REUSEPORT and binds it to an endpoint.
+ * @param endpoint The address to bind (IPv4 is stored IPv4-mapped).
+ * @return The bound handle.
+ */
+int openReusePortSocket(const rtype::network::Endpoint &endpoint)
+{
+    const bool v6 = rtype::network::isIPv6(endpoint);
+    const int fd = ::socket(v6 ? AF_INET6 : AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+    if (fd == -1) {
+        throw rtype::srv::Exception("ReusePortGroup", "socket failed: ", std::strerror(errno));
+    }
+    constexpr int one = 1;
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == -1) {
+        const int err = errno;
+        ::close(fd);
+        throw rtype::srv::Exception("ReusePortGroup", "SO_REUSEPORT failed: ", std::strerror(err));
+    }
+    sockaddr_storage addr{};
+    const socklen_t len = rtype::srv::utils::toSockaddr(endpoint, v6 ? AF_INET6 : AF_INET, addr);
+    if (::bind(fd, reinterpret_cast<const sockaddr *>(&addr), len) == -1) {
+        const int err = errno;
+        ::close(fd);
+        throw rtype::srv::Exception("ReusePortGroup", "Could not bind ", rtype::srv::utils::ipToStr(endpoint.ip), ":", endpoint.port, ": ",
+            std::strerror(err));
+    }
+    return fd;
+}
+
+/**
+ * @brief Attaches the client ID steering program to the reuseport group of a socket.
+ *
+ * The program runs with the packet positioned at the UDP payload:
+ *   A = payload[16..19] (big-endian load, so A is the host-order client ID)
+ *   A = A % nsockets
+ *   return A
+ * Datagrams shorter than the header abort the load and go to socket 0.
+ *
+ * @param fd Any socket of the group.
+ * @param nsockets The number of sockets in the group.
+ */
+void attachSteeringProgram(const int fd, const uint32_t nsockets)
+{
+    sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, rtype::srv::ReusePortGroup::CLIENT_ID_OFFSET),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, nsockets),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+    sock_fprog prog{};
+    prog.len = static_cast<unsigned short>(sizeof(code) / sizeof(code[0]));
+    prog.filter = code;
+    if (::setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == -1) {
+        throw rtype::srv::Exception("ReusePortGroup", "SO_ATTACH_REUSEPORT_CBPF failed: ", std::strerror(errno));
+    }
+}
+#endif
+
+}// namespace
+
+rtype::srv::ReusePortGroup::ReusePortGroup(const network::Endpoint &endpoint, const std::size_t nsockets)
+{
+#if defined(__linux__)
+    if (nsockets == 0) {
+        throw Exception("ReusePortGroup", "A reuseport group needs at least one socket");
+    }
+    _sockets.reserve(nsockets);
+    try {
+        for (std::size_t i = 0; i < nsockets; ++i) {
+            _sockets.push_back(network::Socket{endpoint, openReusePortSocket(endpoint), network::Protocol::UDP});
+        }
+        attachSteeringProgram(_sockets.front().handle, static_cast<uint32_t>(nsockets));
+    } catch (...) {
+        for (auto &sock : _sockets) {
+            disconnect(sock);
+        }
+        throw;
+    }
+    _released.assign(nsockets, false);
+#else
+    (void) endpoint;
+    (void) nsockets;
+    throw Exception("ReusePortGroup", "SO_REUSEPORT sharding is only supported on Linux");
+#endif
+}
+
+rtype::srv::ReusePortGroup::~ReusePortGroup() noexcept
+{
+    for (std::size_t i = 0; i < _sockets.size(); ++i) {
+        if (!_released[i]) {
+            disconnect(_sockets[i]);
+        }
+    }
+}
+
+rtype::network::Socket rtype::srv::ReusePortGroup::release(const std::size_t index)
+{
+    if (index >= _sockets.size() || _released[index]) {
+        throw Exception("ReusePortGroup::release", "Socket ", index, " is not available");
+    }
+    _released[index] = true;
+    return _sockets[index];
+}
+
+std::size_t rtype::srv::ReusePortGroup::size() const noexcept
+{
+    return _sockets.size();
+}
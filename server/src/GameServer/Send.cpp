@@ -2,9 +2,7 @@
 #include <RTypeSrv/GameServer.hpp>
 #include <RTypeSrv/Utils/IPToStr.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
-#include <cerrno>
-#include <cstring>
-#include <deque>
+#include <algorithm>
 #include <iomanip>
 #include <ranges>
 #include <sstream>
@@ -20,81 +18,257 @@ rtype::network::Endpoint rtype::srv::GameServer::GetEndpointFromHandle(const net
     throw std::runtime_error("Handle not found in sockets map.");
 }
 
-void rtype::srv::GameServer::_sendPackets(const network::NFDS i)
+/**
+ * @brief Resumes the datagram flush when the UDP socket becomes writable again.
+ *
+ * @param handle The handle reported writable by the reactor.
+ */
+void rtype::srv::GameServer::_sendPackets(const network::Handle handle)
 {
-    const auto fd_handle = _fds[i].handle;
-
-    if (!(_fds[i].revents & POLLOUT)) {
+    if (handle != _sock.handle) {
         return;
     }
+    _flushDatagrams();
+}
 
-    if (fd_handle == _sock.handle) {
-        for (auto it = _send_spans.begin(); it != _send_spans.end();) {
-            const auto &ep_key = it->first;
-            auto &bufs = it->second;
-            if (bufs.empty()) {
-                it = _send_spans.erase(it);
+/**
+ * @brief Gathers every datagram queued in `_send_spans` and sends them in batches.
+ *
+ * A client's datagrams leave while its token bucket allows (see CongestionController);
+ * the others stay in `_send_spans`, in order, for the flush of a later tick.
+ * The datagram marked in `_stamped_spans` is sent stamped when it leaves, so the
+ * RTT of its PING excludes the time the token bucket held it.
+ * Datagrams the kernel could not take yet stay queued in order; write interest is
+ * armed only while they are pending so the next writable event resumes from where
+ * this flush stopped, and disarmed once the queue is empty. With the io_uring
+ * engine the whole batch is submitted as one linked chain instead.
+ *
+ * @return true if everything was sent, false if datagrams are still pending.
+ */
+bool rtype::srv::GameServer::_flushDatagrams()
+{
+    _udp_flush_pending = false;
+    const auto now = std::chrono::steady_clock::now();
+    for (auto &[ep_key, bufs] : _send_spans) {
+        if (bufs.empty()) {
+            continue;
+        }
+        const network::Endpoint client_endpoint{ep_key.first, ep_key.second};
+        if (client_endpoint.port == 0 || std::ranges::all_of(client_endpoint.ip, [](const uint8_t v) { return v == 0; })) {
+            utils::cerr("Skipping send: invalid client endpoint (port=", client_endpoint.port, ") or IP all-zero");
+            bufs.clear();
+            _stamped_spans.erase(ep_key);
+            continue;
+        }
+        const auto congestion = _ep_congestion.find(ep_key);
+        const auto stamp = _stamped_spans.find(ep_key);
+        std::size_t released = 0;
+        for (; released < bufs.size(); ++released) {
+            auto &buf = bufs[released];
+            if (buf.empty())
                 continue;
+            if (congestion != _ep_congestion.end() && !congestion->second.consume(buf.size(), now)) {
+                _congestion_stats.held += bufs.size() - released;
+                break;
+            }
+#if defined(DEBUG)
+            std::ostringstream ss;
+            ss << std::hex << std::setfill('0');
+            const size_t show = std::min<size_t>(buf.size(), 64);
+            for (size_t j = 0; j < show; ++j) {
+                ss << std::setw(2) << static_cast<int>(buf[j]);
+                if (j + 1 < show)
+                    ss << ' ';
             }
-            network::Endpoint client_endpoint{ep_key.first, ep_key.second};
-            for (auto &buf : bufs) {
-                if (buf.empty())
-                    continue;
-                std::ostringstream ss;
-                ss << std::hex << std::setfill('0');
-                const size_t len = buf.size();
-                const size_t show = std::min<size_t>(len, 64);
-                for (size_t j = 0; j < show; ++j) {
-                    ss << std::setw(2) << static_cast<int>(buf[j]);
-                    if (j + 1 < show)
-                        ss << ' ';
+            utils::clog("OUT UDP to=", utils::ipToStr(client_endpoint.ip), ":", client_endpoint.port,
+                " ipv6=", rtype::network::isIPv6(client_endpoint), " len=", buf.size(), " hex=", ss.str());
+#endif
+            const bool stamped = stamp != _stamped_spans.end() && stamp->second == released;
+            if (_uring) {
+                if (const auto metrics = stamped ? _latency_metrics.find(ep_key) : _latency_metrics.end();
+                    metrics != _latency_metrics.end()) {
+                    metrics->second.ping_sent = now;
                 }
-                rtype::srv::utils::clog("OUT UDP to=", utils::ipToStr(client_endpoint.ip), ":", client_endpoint.port, " len=", len,
-                    " hex=", ss.str());
+                _uring->push(client_endpoint, std::move(buf));
+            } else if (stamped) {
+                _send_queue.pushStamped(client_endpoint, std::move(buf));
+            } else {
+                _send_queue.push(client_endpoint, std::move(buf));
+            }
+        }
+        bufs.erase(bufs.begin(), bufs.begin() + static_cast<std::ptrdiff_t>(released));
+        if (stamp != _stamped_spans.end() && stamp->second < released) {
+            _stamped_spans.erase(stamp);
+        } else if (stamp != _stamped_spans.end()) {
+            stamp->second -= released;
+        }
+    }
+    if (_uring) {
+        // Sends that did not fit in the ring are retried once completions free their slots.
+        _udp_flush_pending = !_uring->flush();
+        return !_udp_flush_pending;
+    }
+    if (!_send_queue.empty() && !_send_queue.flush(_sock.handle)) {
+        _applySendStamps();
+        _reactor.modify(_sock.handle, Reactor::READ | Reactor::WRITE);
+        return false;
+    }
+    _applySendStamps();
+    _reactor.modify(_sock.handle, Reactor::READ);
+    return true;
+}
 
-                std::ostringstream ephex;
-                ephex << std::hex << std::setfill('0');
-                for (size_t b = 0; b < client_endpoint.ip.size(); ++b) {
-                    ephex << std::setw(2) << static_cast<int>(client_endpoint.ip[b]);
-                    if (b + 1 < client_endpoint.ip.size())
-                        ephex << ' ';
-                }
-                const bool endpoint_is_ipv6 = rtype::network::isIPv6(client_endpoint);
-                utils::clog("OUT UDP to=", utils::ipToStr(client_endpoint.ip), ":", client_endpoint.port, " (raw=", ephex.str(),
-                    ") ipv6=", endpoint_is_ipv6, " len=", buf.size());
+/**
+ * @brief Reads the PING transmit timestamps the kernel posted on the UDP socket error queue.
+ *
+ * The reactor reports a pending error queue as CLOSED; the UDP socket itself never closes.
+ */
+void rtype::srv::GameServer::_reapSendStamps()
+{
+    if (_send_queue.reapTimestamps(_sock.handle) > 0) {
+        _applySendStamps();
+    }
+}
 
-                bool ip_all_zero = true;
-                for (auto v : client_endpoint.ip) {
-                    if (v != 0) {
-                        ip_all_zero = false;
-                        break;
-                    }
-                }
-                if (client_endpoint.port == 0 || ip_all_zero) {
-                    utils::cerr("Skipping send: invalid client endpoint (port=", client_endpoint.port, ") or IP all-zero");
-                    continue;
-                }
-                const ssize_t sent =
-                    rtype::network::sendto(_sock.handle, buf.data(), static_cast<rtype::network::BufLen>(buf.size()), 0, client_endpoint);
-                if (sent < 0) {
-                    const int err = errno;
-                    if (err == EAGAIN || err == EWOULDBLOCK) {
-                        utils::cerr("Socket buffer full, will retry later");
-                        continue;
-                    }
-#if defined(_WIN32)
-                    char error_buf[256];
-                    strerror_s(error_buf, sizeof(error_buf), errno);
-                    utils::cerr("Could not send packet: ", error_buf, " (errno=", err, ")");
-#else
-                    utils::cerr("Could not send packet: ", std::strerror(err), " (errno=", err, ")");
-#endif
-                    continue;
-                }
+/**
+ * @brief Records when the queued PINGs left, so PONG RTTs exclude the time they waited in the server.
+ *
+ * Stamps are reported in order, so a kernel timestamp read later overrides the sendmmsg() return time.
+ */
+void rtype::srv::GameServer::_applySendStamps()
+{
+    for (const auto &stamp : _send_queue.sendStamps()) {
+        if (const auto it = _latency_metrics.find(IP{stamp.endpoint.ip, stamp.endpoint.port}); it != _latency_metrics.end()) {
+            it->second.ping_sent = stamp.sent;
+        }
+    }
+    _send_queue.clearSendStamps();
+}
+
+/**
+ * @brief Sends the messages of the tick and runs the timers of every client channel, once per tick after the snapshots.
+ *
+ * Each client's outbox goes out first, coalesced if the client takes CMD_BATCH.
+ * Its send rate is then adapted to the acknowledgements received since the last
+ * tick, if UdpOptions::max_rate is set, and an authenticated client is sent the
+ * path MTU probe due, if UdpOptions::max_mtu is over UdpOptions::mtu. Reliable
+ * packets due are retransmitted; reliable packets received that no header sent
+ * since acknowledged (the snapshots usually did) get a CMD_ACK; RO messages held
+ * past their gap timeout are dispatched.
+ */
+void rtype::srv::GameServer::_serviceChannels()
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (auto &[endpoint, outbox] : _ep_outboxes) {
+        // Outboxes only exist for joined clients, which have a channel; nothing is created for other sources.
+        if (const auto channel = _ep_channels.find(endpoint); !outbox.empty() && channel != _ep_channels.end()) {
+            _flushOutbox(endpoint, outbox, channel->second, now);
+        }
+    }
+    _held_scratch.clear();
+    for (auto &[endpoint, channel] : _ep_channels) {
+        if (const auto congestion = _ep_congestion.find(endpoint); congestion != _ep_congestion.end()) {
+            congestion->second.update(channel, _pingRtt(endpoint), now, _udp.max_rate, _congestion_stats);
+        }
+        if (auto path = _ep_mtu.find(endpoint); path != _ep_mtu.end()) {
+            if (const auto probe = path->second.due(now, channel.rto(), _mtu_stats)) {
+                _sendProbe(endpoint, channel, path->second, *probe, now);
+            }
+        } else if (_udp.max_mtu > _udp.mtu && _sessionKey(endpoint) != nullptr) {
+            // Probed only once authenticated: the padding would otherwise amplify spoofed datagrams.
+            const uint16_t ceiling = network::isIPv6(network::Endpoint{endpoint.first, endpoint.second})
+                ? GameServerUDPPacketParser::MAX_PROBED_SIZE_V6
+                : GameServerUDPPacketParser::MAX_PROBED_SIZE;
+            _ep_mtu.try_emplace(endpoint, _udp.mtu, (std::min) (_udp.max_mtu, ceiling));
+        }
+        if (channel.unacked() > 0 && channel.retransmit(now, _send_spans[endpoint], _reliable_stats) > 0) {
+            setPolloutForHandle(_sock.handle);
+        }
+        channel.takeAcks(_ack_scratch);
+        if (!_ack_scratch.empty()) {
+            Outbox &outbox = _ep_outboxes[endpoint];
+            const std::size_t size = _ack_scratch.size() * GSPcol::AckEntry::size;
+            PacketWriter acks = outbox.append(GSPcol::CMD::ACK, GSPcol::FLAGS{}, GSPcol::CHANNEL::UU, size);
+            for (const uint32_t seq : _ack_scratch) {
+                GSPcol::AckEntry::write(acks, seq);
             }
-            it = _send_spans.erase(it);
+            _flushOutbox(endpoint, outbox, channel, now);
+        }
+        if (channel.holding()) {
+            _held_scratch.push_back(endpoint);
         }
-        _fds[i].events &= ~POLLOUT;
+    }
+    for (const IP &endpoint : _held_scratch) {
+        _releaseHeld(endpoint, now);
+    }
+}
+
+/**
+ * @brief Turns the messages queued for a client into datagrams, in `_send_spans`, sealed if the client encrypts.
+ *
+ * The datagram carrying a PING is marked in `_stamped_spans`: it waits for its token
+ * bucket like the others, and _flushDatagrams() sends it stamped, so its RTT starts
+ * when it actually left (see _applySendStamps()).
+ */
+void rtype::srv::GameServer::_flushOutbox(const IP &endpoint, Outbox &outbox, ReliableChannel &channel,
+    const std::chrono::steady_clock::time_point now)
+{
+    const auto client = _endpoint_to_client.find(endpoint);
+    const uint32_t client_id = client != _endpoint_to_client.end() ? client->second : 0;
+    const auto acks = _ep_snapshot_acks.find(endpoint);
+    const auto session = _ep_sessions.find(endpoint);
+    const Outbox::Destination to{.channel = channel,
+        .acks = acks != _ep_snapshot_acks.end() ? &acks->second : nullptr,
+        .client_id = client_id,
+        .mtu = _clientMtu(endpoint),
+        .cipher = &_cipher,
+        .key = session != _ep_sessions.end() ? &session->second.key : nullptr};
+    std::vector<PacketBuffer> &queue = _send_spans[endpoint];
+    const std::optional<std::size_t> stamped = outbox.flush(_packet_pool, to, queue, now, _reliable_stats, _outbox_stats);
+    if (stamped) {
+        _stamped_spans[endpoint] = *stamped;
+    }
+    setPolloutForHandle(_sock.handle);
+}
+
+/**
+ * @brief Sends a path MTU probe: a PING on UU padded to size bytes on the wire, sealed if the client encrypts.
+ *
+ * It goes straight to `_send_spans`, so no batching changes its size. Its SEQ,
+ * acknowledged in the client's headers, confirms the size (see PathMtu); the PONG
+ * the client answers with is not needed.
+ */
+void rtype::srv::GameServer::_sendProbe(const IP &endpoint, ReliableChannel &channel, PathMtu &path, const uint16_t size,
+    const std::chrono::steady_clock::time_point now)
+{
+    const auto session = _ep_sessions.find(endpoint);
+    const std::size_t tag = session != _ep_sessions.end() ? PacketCipher::TAG_SIZE : 0;
+    const GameServerUDPPacketParser::HeaderFields header = channel.header(GSPcol::CHANNEL::UU);
+    const auto client = _endpoint_to_client.find(endpoint);
+    const std::size_t packet_size = size - tag;
+    PacketBuffer packet = _packet_pool.acquire();
+    std::ranges::fill(packet.storage().first(packet_size), uint8_t{0});// Pool buffers keep their previous bytes
+    PacketWriter writer(packet.storage());
+    GameServerUDPPacketParser::writeHeader(writer, GSPcol::CMD::PING, GSPcol::FLAGS::PING, header, GSPcol::CHANNEL::UU,
+        static_cast<uint16_t>(packet_size), client != _endpoint_to_client.end() ? client->second : 0);
+    packet.resize(packet_size);
+    if (session != _ep_sessions.end() && !_cipher.seal(session->second.key, PacketCipher::Direction::SERVER, packet)) {
         return;
     }
+    channel.probed(packet, now, _reliable_stats);
+    path.sent(header.seq);
+    _send_spans[endpoint].push_back(std::move(packet));
+    setPolloutForHandle(_sock.handle);
+}
+
+/**
+ * @brief Gets the smoothed PING / PONG RTT of a client, or 0 before the first PONG.
+ *
+ * The fallback of its congestion controller until the channel samples an RTT: it
+ * follows the path like the channel's SRTT would, where the average never forgets.
+ */
+std::chrono::microseconds rtype::srv::GameServer::_pingRtt(const IP &endpoint) const noexcept
+{
+    const auto metrics = _latency_metrics.find(endpoint);
+    return metrics != _latency_metrics.end() && metrics->second.samples > 0 ? metrics->second.srtt : std::chrono::microseconds{0};
 }
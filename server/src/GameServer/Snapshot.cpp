@@ -0,0 +1,340 @@
+#include <RTypeSrv/Schema.hpp>
+#include <RTypeSrv/Snapshot.hpp>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Tells whether snapshot a is newer than b, allowing the sequence number to wrap.
+ */
+bool isNewer(const uint32_t a, const uint32_t b) noexcept
+{
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+constexpr std::size_t DELTA_COUNT_SIZE = rtype::srv::schema::Codec<uint16_t>::size;
+constexpr std::size_t DELTA_ENTRY_MAX = 4 + 1 + 4 + 4;
+
+/**
+ * @brief Walks two states sorted by id in step, reporting removed, added and common entities.
+ * @return false as soon as a callback does.
+ */
+template<typename Removed, typename Added, typename Common>
+bool merge(const std::span<const SnapshotEntity> baseline, const std::span<const SnapshotEntity> current, Removed &&removed,
+    Added &&added, Common &&common)
+{
+    std::size_t b = 0;
+    std::size_t c = 0;
+    while (b < baseline.size() || c < current.size()) {
+        bool ok = true;
+        if (c == current.size() || (b < baseline.size() && baseline[b].id < current[c].id)) {
+            ok = removed(baseline[b++]);
+        } else if (b == baseline.size() || current[c].id < baseline[b].id) {
+            ok = added(current[c++]);
+        } else {
+            ok = common(baseline[b++], current[c++]);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief The fields of an entity as they go on the wire in quantized snapshots.
+ */
+struct QuantizedEntity {
+        bool raw;///< A field is out of bounds: both are sent as 32-bit floats
+        uint32_t x;
+        uint32_t y;
+};
+
+QuantizedEntity quantize(const SnapshotEntity &entity, const rtype::srv::SnapshotPrecision &precision) noexcept
+{
+    if (precision.x.contains(entity.x) && precision.y.contains(entity.y)) {
+        return {false, precision.x.quantize(entity.x), precision.y.quantize(entity.y)};
+    }
+    return {true, std::bit_cast<uint32_t>(entity.x), std::bit_cast<uint32_t>(entity.y)};
+}
+
+void writeFields(rtype::srv::BitWriter &bits, const QuantizedEntity &entity, const uint8_t mask,
+    const rtype::srv::SnapshotPrecision &precision)
+{
+    if ((mask & rtype::srv::snapshot::FIELD_X) != 0) {
+        bits.bits(entity.x, entity.raw ? 32 : precision.x.bits);
+    }
+    if ((mask & rtype::srv::snapshot::FIELD_Y) != 0) {
+        bits.bits(entity.y, entity.raw ? 32 : precision.y.bits);
+    }
+}
+
+float readField(rtype::srv::BitReader &bits, const bool raw, const rtype::srv::Quantization &quantization) noexcept
+{
+    return raw ? std::bit_cast<float>(bits.bits(32)) : quantization.dequantize(bits.bits(quantization.bits));
+}
+
+}// namespace
+
+void rtype::srv::SnapshotHistory::push(const uint32_t seq, const std::span<const SnapshotEntity> entities)
+{
+    Entry &entry = _entries[seq % CAPACITY];
+    entry.seq = seq;
+    entry.valid = true;
+    entry.entities.assign(entities.begin(), entities.end());
+    _latest = &entry;
+}
+
+const rtype::srv::SnapshotHistory::Entry *rtype::srv::SnapshotHistory::find(const uint32_t seq) const noexcept
+{
+    const Entry &entry = _entries[seq % CAPACITY];
+    return entry.valid && entry.seq == seq ? &entry : nullptr;
+}
+
+const rtype::srv::SnapshotHistory::Entry *rtype::srv::SnapshotHistory::latest() const noexcept
+{
+    return _latest;
+}
+
+void rtype::srv::SnapshotAcks::sent(const uint32_t packetSeq, const uint32_t snapshotSeq, const std::size_t parts) noexcept
+{
+    if (parts == 0 || parts > WINDOW) {
+        return;
+    }
+    for (uint32_t i = 0; i < parts; ++i) {
+        _slots[(packetSeq + i) % WINDOW] = {packetSeq + i, snapshotSeq, packetSeq, static_cast<uint8_t>(parts), true, false};
+    }
+}
+
+void rtype::srv::SnapshotAcks::acknowledge(const uint32_t ackBase, const uint32_t ackBits, const unsigned width) noexcept
+{
+    _ack(ackBase);
+    for (uint32_t i = 0; i < (std::min) (width, 32U); ++i) {
+        if ((ackBits & (1U << i)) != 0) {
+            _ack(ackBase - 1 - i);
+        }
+    }
+}
+
+std::optional<uint32_t> rtype::srv::SnapshotAcks::baseline() const noexcept
+{
+    return _baseline;
+}
+
+void rtype::srv::SnapshotAcks::reset() noexcept
+{
+    _slots = {};
+    _baseline.reset();
+}
+
+void rtype::srv::SnapshotAcks::_ack(const uint32_t packetSeq) noexcept
+{
+    Slot &slot = _slots[packetSeq % WINDOW];
+    if (!slot.valid || slot.packet_seq != packetSeq) {
+        return;
+    }
+    slot.acked = true;
+    for (uint32_t i = 0; i < slot.parts; ++i) {
+        const Slot &part = _slots[(slot.first_seq + i) % WINDOW];
+        if (!part.valid || part.packet_seq != slot.first_seq + i || !part.acked) {
+            return;
+        }
+    }
+    if (!_baseline || isNewer(slot.snapshot_seq, *_baseline)) {
+        _baseline = slot.snapshot_seq;
+    }
+}
+
+void rtype::srv::snapshot::writeKeyframe(PacketWriter &out, const std::span<const SnapshotEntity> entities)
+{
+    out.u32(static_cast<uint32_t>(entities.size()));
+    for (const SnapshotEntity &entity : entities) {
+        out.u32(entity.id).u32(std::bit_cast<uint32_t>(entity.x)).u32(std::bit_cast<uint32_t>(entity.y));
+    }
+}
+
+bool rtype::srv::snapshot::writeDelta(PacketWriter &out, const std::span<const SnapshotEntity> baseline,
+    const std::span<const SnapshotEntity> current)
+{
+    if (out.remaining() < DELTA_COUNT_SIZE) {
+        return false;
+    }
+    uint8_t *const count_at = out.claim(DELTA_COUNT_SIZE).data();
+    uint16_t count = 0;
+    auto emit = [&](const uint32_t id, const uint8_t mask, const SnapshotEntity *state) {
+        if (out.remaining() < DELTA_ENTRY_MAX || count == UINT16_MAX) {
+            return false;
+        }
+        out.u32(id).u8(mask);
+        if ((mask & FIELD_X) != 0) {
+            out.u32(std::bit_cast<uint32_t>(state->x));
+        }
+        if ((mask & FIELD_Y) != 0) {
+            out.u32(std::bit_cast<uint32_t>(state->y));
+        }
+        ++count;
+        return true;
+    };
+
+    const bool complete = merge(
+        baseline, current,
+        [&](const SnapshotEntity &gone) {
+            return emit(gone.id, REMOVED, nullptr);
+        },
+        [&](const SnapshotEntity &added) {
+            return emit(added.id, FIELD_X | FIELD_Y, &added);
+        },
+        [&](const SnapshotEntity &from, const SnapshotEntity &to) {
+            const uint8_t mask = static_cast<uint8_t>(
+                (std::bit_cast<uint32_t>(from.x) != std::bit_cast<uint32_t>(to.x) ? FIELD_X : 0)
+                | (std::bit_cast<uint32_t>(from.y) != std::bit_cast<uint32_t>(to.y) ? FIELD_Y : 0));
+            return mask == 0 || emit(to.id, mask, &to);
+        });
+    if (!complete) {
+        return false;
+    }
+    schema::Codec<uint16_t>::store(count_at, count);
+    return true;
+}
+
+void rtype::srv::snapshot::writeQuantizedKeyframe(PacketWriter &out, const std::span<const SnapshotEntity> entities,
+    const SnapshotPrecision &precision)
+{
+    if (entities.size() > UINT16_MAX) {
+        throw std::length_error("Too many entities for a quantized snapshot");
+    }
+    out.u16(static_cast<uint16_t>(entities.size()));
+    BitWriter bits(out.unwritten());
+    uint32_t previous = 0;
+    for (const SnapshotEntity &entity : entities) {
+        const QuantizedEntity fields = quantize(entity, precision);
+        bits.varint(entity.id - previous, ID_GROUP_BITS).flag(fields.raw);
+        writeFields(bits, fields, FIELD_X | FIELD_Y, precision);
+        previous = entity.id;
+    }
+    (void) out.claim(bits.finish());
+}
+
+bool rtype::srv::snapshot::writeQuantizedDelta(PacketWriter &out, const std::span<const SnapshotEntity> baseline,
+    const std::span<const SnapshotEntity> current, const SnapshotPrecision &precision)
+{
+    if (out.remaining() < DELTA_COUNT_SIZE) {
+        return false;
+    }
+    uint8_t *const count_at = out.claim(DELTA_COUNT_SIZE).data();
+    BitWriter bits(out.unwritten());
+    uint16_t count = 0;
+    uint32_t previous = 0;
+    auto emit = [&](const uint32_t id, const QuantizedEntity *fields, const uint8_t mask) {
+        const std::size_t needed = BitWriter::varintSize(id - previous, ID_GROUP_BITS) + 1 + (fields != nullptr ? 3 + 64 : 0);
+        if (needed > bits.remainingBits() || count == UINT16_MAX) {
+            return false;
+        }
+        bits.varint(id - previous, ID_GROUP_BITS).flag(fields == nullptr);
+        if (fields != nullptr) {
+            bits.flag((mask & FIELD_X) != 0).flag((mask & FIELD_Y) != 0).flag(fields->raw);
+            writeFields(bits, *fields, mask, precision);
+        }
+        previous = id;
+        ++count;
+        return true;
+    };
+
+    const bool complete = merge(
+        baseline, current,
+        [&](const SnapshotEntity &gone) {
+            return emit(gone.id, nullptr, 0);
+        },
+        [&](const SnapshotEntity &added) {
+            const QuantizedEntity fields = quantize(added, precision);
+            return emit(added.id, &fields, FIELD_X | FIELD_Y);
+        },
+        [&](const SnapshotEntity &from, const SnapshotEntity &to) {
+            const QuantizedEntity before = quantize(from, precision);
+            const QuantizedEntity after = quantize(to, precision);
+            const bool reencoded = before.raw != after.raw;
+            const uint8_t mask = static_cast<uint8_t>((reencoded || before.x != after.x ? FIELD_X : 0)
+                | (reencoded || before.y != after.y ? FIELD_Y : 0));
+            return mask == 0 || emit(to.id, &after, mask);
+        });
+    if (!complete) {
+        return false;
+    }
+    schema::Codec<uint16_t>::store(count_at, count);
+    (void) out.claim(bits.finish());
+    return true;
+}
+
+bool rtype::srv::snapshot::readQuantizedKeyframe(const std::span<const uint8_t> in, const SnapshotPrecision &precision,
+    std::vector<SnapshotEntity> &out)
+{
+    if (in.size() < DELTA_COUNT_SIZE) {
+        return false;
+    }
+    const uint16_t count = schema::Codec<uint16_t>::load(in.data());
+    BitReader bits(in.subspan(DELTA_COUNT_SIZE));
+    out.clear();
+    out.reserve(std::min<std::size_t>(count, in.size()));
+    uint32_t previous = 0;
+    for (uint16_t i = 0; i < count && bits.ok(); ++i) {
+        const uint32_t step = bits.varint(ID_GROUP_BITS);
+        if (i > 0 && step == 0) {
+            return false;
+        }
+        const bool raw = bits.flag();
+        const float x = readField(bits, raw, precision.x);
+        const float y = readField(bits, raw, precision.y);
+        previous += step;
+        out.push_back({previous, x, y});
+    }
+    return bits.ok();
+}
+
+bool rtype::srv::snapshot::readQuantizedDelta(const std::span<const uint8_t> in, const SnapshotPrecision &precision,
+    const std::span<const SnapshotEntity> baseline, std::vector<SnapshotEntity> &out)
+{
+    if (in.size() < DELTA_COUNT_SIZE) {
+        return false;
+    }
+    const uint16_t count = schema::Codec<uint16_t>::load(in.data());
+    BitReader bits(in.subspan(DELTA_COUNT_SIZE));
+    out.clear();
+    out.reserve(baseline.size() + std::min<std::size_t>(count, in.size()));
+    std::size_t b = 0;
+    uint32_t previous = 0;
+    for (uint16_t i = 0; i < count && bits.ok(); ++i) {
+        const uint32_t step = bits.varint(ID_GROUP_BITS);
+        if (i > 0 && step == 0) {
+            return false;
+        }
+        const uint32_t id = previous += step;
+        while (b < baseline.size() && baseline[b].id < id) {
+            out.push_back(baseline[b++]);
+        }
+        const SnapshotEntity *base = b < baseline.size() && baseline[b].id == id ? &baseline[b++] : nullptr;
+        if (bits.flag()) {
+            if (base == nullptr) {
+                return false;
+            }
+            continue;
+        }
+        const bool has_x = bits.flag();
+        const bool has_y = bits.flag();
+        const bool raw = bits.flag();
+        if (base == nullptr && !(has_x && has_y)) {
+            return false;
+        }
+        SnapshotEntity entity = base != nullptr ? *base : SnapshotEntity{id, 0.0f, 0.0f};
+        if (has_x) {
+            entity.x = readField(bits, raw, precision.x);
+        }
+        if (has_y) {
+            entity.y = readField(bits, raw, precision.y);
+        }
+        out.push_back(entity);
+    }
+    out.insert(out.end(), baseline.begin() + static_cast<std::ptrdiff_t>(b), baseline.end());
+    return bits.ok();
+}
@@ -0,0 +1,126 @@
+#include <RTypeSrv/PayloadCompressor.hpp>
+#include <array>
+
+namespace {
+
+/**
+ * @brief zstd dictionary, version 1 (PayloadCompressor::DICTIONARY_ID).
+ *
+ * Trained with `zstd --train --maxdict=2048 --dictID=1` on 3480 float keyframe payloads
+ * ([SEQ:4][COUNT:4]([ENTITY:4][X:4][Y:4])...) of 1 to 10 players spawned by
+ * spawn_player_system and moved by movement_system at 60 ticks per second. On keyframes
+ * of other games it brings the payloads down by about 28%, where zstd without a dictionary
+ * makes them larger. Clients must ship the same bytes; a retrained dictionary gets a new id.
+ */
+constexpr std::array<uint8_t, 2048> DICTIONARY{
+    0x37, 0xa4, 0x30, 0xec, 0x01, 0x00, 0x00, 0x00, 0x4e, 0x10, 0x78, 0x75, 0x94, 0x74, 0xd0, 0x5e, 0x6c, 0x41, 0x7d, 0x4e,
+    0xb3, 0x5e, 0xb2, 0x2e, 0x55, 0xb5, 0x9d, 0xe1, 0x3c, 0x1c, 0xc9, 0x96, 0xe6, 0xdf, 0x0e, 0xf5, 0x1f, 0x3f, 0xc9, 0x42,
+    0x14, 0x32, 0x2a, 0x99, 0x02, 0xa1, 0x8a, 0x06, 0x16, 0x32, 0xc5, 0xee, 0xf2, 0x7d, 0xde, 0x75, 0x6b, 0xb8, 0x13, 0x50,
+    0x53, 0x3d, 0x48, 0xb9, 0x3c, 0xa1, 0xa9, 0xdf, 0xba, 0x78, 0x5c, 0xc3, 0x63, 0x19, 0x0d, 0x29, 0x0d, 0xe8, 0xc1, 0xff,
+    0x09, 0x21, 0x84, 0x10, 0x12, 0xf1, 0x29, 0x63, 0x02, 0x00, 0x24, 0x0e, 0x0a, 0xca, 0xa3, 0x23, 0xbb, 0x0f, 0x00, 0x00,
+    0x04, 0xc0, 0x10, 0x5d, 0xcb, 0xc8, 0x4c, 0xf7, 0x38, 0xa5, 0x0c, 0x01, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x48, 0x0e, 0x68, 0x64, 0xb4, 0x64, 0x1c, 0x02,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x08,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0xc2, 0x20, 0x00, 0x00, 0x43, 0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+    0x43, 0xdd, 0xaa, 0xab, 0x44, 0x30, 0xaa, 0xab, 0x00, 0x00, 0x09, 0x05, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03,
+    0x43, 0x02, 0x00, 0x00, 0x43, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x43, 0xaf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x42,
+    0xd5, 0x55, 0x55, 0x43, 0xfb, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x09, 0x42, 0xc8, 0x00, 0x00, 0x44, 0x01, 0x2a, 0xab, 0x00,
+    0x00, 0x14, 0x7c, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x43, 0x16, 0x00, 0x00, 0x43, 0x87, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x43, 0x26, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x04, 0x43, 0x19, 0x55, 0x55, 0x43, 0xc6, 0x55, 0x55, 0x00, 0x00,
+    0x00, 0x05, 0x43, 0x19, 0x55, 0x55, 0x43, 0xf6, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x06, 0x42, 0xc8, 0x00, 0x00, 0x43, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x42, 0x85, 0x55, 0x55, 0x43, 0x00, 0x00, 0x41, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x42, 0xe2, 0xaa, 0xab, 0x43, 0x2d, 0x55, 0x55, 0x00, 0x00, 0x00, 0x03, 0xc2, 0xf0, 0x00, 0x00, 0x43, 0xa5, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x43, 0xfb, 0xaa, 0xab, 0x43, 0xce, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x05, 0x43, 0x9c, 0xaa,
+    0xab, 0x43, 0xbf, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x05, 0x43, 0x76, 0xaa, 0xab, 0x42, 0xe9, 0x55, 0x55, 0x00, 0x00, 0x00,
+    0x06, 0x43, 0x85, 0x55, 0x55, 0x43, 0xad, 0x55, 0x55, 0x00, 0x00, 0x00, 0x07, 0x41, 0xa0, 0x00, 0x00, 0x43, 0xd5, 0x55,
+    0x55, 0x00, 0x00, 0x00, 0x08, 0xc2, 0xd5, 0x55, 0x55, 0x44, 0x27, 0x55, 0x55, 0x43, 0xa5, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x07, 0xc2, 0x12, 0xaa, 0xab, 0x43, 0x99, 0x55, 0x55, 0x00, 0x00, 0x00, 0x08, 0x42, 0x12, 0xaa, 0xab, 0x44, 0x19, 0x55,
+    0x55, 0x00, 0x00, 0x00, 0x09, 0x42, 0x3a, 0xaa, 0xab, 0x43, 0xd3, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x0a, 0x42, 0xa0, 0x00,
+    0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0xc2, 0xc1, 0x55, 0x55, 0x43, 0x2a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+    0x43, 0x0c, 0x00, 0x00, 0x43, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x43, 0x3a, 0xaa, 0xab, 0x43, 0x9c, 0xaa, 0xab,
+    0x00, 0x00, 0x00, 0x04, 0x43, 0x44, 0xaa, 0xab, 0x43, 0xc4, 0xaa, 0x00, 0x00, 0x0b, 0x82, 0x00, 0x00, 0x00, 0x09, 0x00,
+    0x00, 0x00, 0x01, 0xc3, 0x0c, 0x00, 0x00, 0xc3, 0x05, 0x55, 0x55, 0x00, 0x00, 0x00, 0x02, 0x43, 0x5f, 0x55, 0x55, 0xc3,
+    0xc6, 0x55, 0x55, 0x00, 0x00, 0x00, 0x03, 0x42, 0xc1, 0x55, 0x55, 0x42, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xc3,
+    0x26, 0x60, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x02, 0x42, 0xfd, 0x55, 0x55, 0x43, 0x16, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x06, 0x42, 0x85, 0x55, 0x55, 0x43, 0xaf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xc1, 0x20, 0x00, 0x00, 0x43, 0x52,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0xc1, 0xba, 0xaa, 0xab, 0x43, 0x41, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x03,
+    0x42, 0xc1, 0x55, 0x55, 0x43, 0x23, 0x55, 0x55, 0x00, 0x00, 0x00, 0x06, 0x42, 0xa6, 0xaa, 0xab, 0x43, 0xbc, 0x55, 0x55,
+    0x00, 0x00, 0x00, 0x07, 0x43, 0x3a, 0xaa, 0xab, 0x43, 0xc8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x42, 0x62, 0xaa, 0xab,
+    0x43, 0x43, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xc1, 0x85, 0x55, 0x55, 0x42, 0xba, 0xaa, 0xab, 0x00, 0x00, 0x00,
+    0x08, 0x43, 0x97, 0xaa, 0xab, 0x44, 0x2e, 0x2a, 0xab, 0x00, 0x00, 0x00, 0x09, 0x43, 0xba, 0xaa, 0xab, 0x43, 0x9b, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0a, 0xc1, 0xba, 0xaa, 0xab, 0x44, 0x81, 0x03, 0x00, 0x00, 0x00, 0x01, 0x42, 0x55, 0x55, 0x55,
+    0x42, 0xc8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xc1, 0xa0, 0x00, 0x00, 0x43, 0xab, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x08,
+    0x43, 0x23, 0x55, 0x55, 0x43, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x0a, 0xac, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x07,
+    0x43, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x43, 0x26, 0xaa, 0xab, 0x43, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x43,
+    0x99, 0x55, 0x55, 0x42, 0x99, 0x55, 0x55, 0x00, 0x00, 0x00, 0x05, 0x42, 0x48, 0x00, 0x00, 0x43, 0x8d, 0xaa, 0xab, 0x00,
+    0x00, 0x00, 0x06, 0x42, 0xf6, 0xaa, 0xab, 0x44, 0x45, 0x80, 0x00, 0xaa, 0xab, 0x42, 0xe2, 0xaa, 0xab, 0x00, 0x00, 0x00,
+    0x03, 0x42, 0x20, 0x00, 0x00, 0x43, 0x30, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x04, 0x42, 0xf6, 0xaa, 0xab, 0x43, 0x5c, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0x43, 0x20, 0x00, 0x00, 0x43, 0xcb, 0x55, 0x55, 0x00, 0x00, 0x00, 0x06, 0x43, 0x97, 0xaa,
+    0xab, 0xab, 0x42, 0x85, 0x55, 0x55, 0x00, 0x00, 0x00, 0x03, 0xc2, 0x70, 0x00, 0x00, 0x43, 0x6c, 0xaa, 0xab, 0x00, 0x00,
+    0x00, 0x04, 0x43, 0xa6, 0xaa, 0xab, 0x43, 0x19, 0x55, 0x55, 0x00, 0x00, 0x00, 0x06, 0x41, 0xd5, 0x55, 0x55, 0x43, 0x1c,
+    0xaa, 0xab, 0x00, 0x00, 0x00, 0x07, 0x42, 0xe2, 0xaa, 0xab, 0x43, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x05, 0x43,
+    0xba, 0xaa, 0xab, 0x43, 0x8a, 0x55, 0x55, 0x00, 0x00, 0x00, 0x09, 0x43, 0x5f, 0x55, 0x55, 0x43, 0xda, 0x55, 0x55, 0x00,
+    0x00, 0x12, 0xb4, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x42, 0xb4, 0x00, 0x00, 0x43, 0x6c, 0xaa, 0xab, 0x00,
+    0x00, 0x43, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x43, 0x12, 0xaa, 0xab, 0x43, 0xc6, 0x55, 0x55, 0x00, 0x00, 0x00,
+    0x08, 0x43, 0x7d, 0x55, 0x55, 0x43, 0xbf, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x09, 0x42, 0x99, 0x55, 0x55, 0x44, 0x07, 0xd5,
+    0x55, 0x00, 0x00, 0x00, 0x0a, 0x42, 0x62, 0xaa, 0xab, 0x44, 0x1f, 0x43, 0x2d, 0x55, 0x55, 0x42, 0x2d, 0x55, 0x55, 0x00,
+    0x00, 0x00, 0x02, 0x42, 0xce, 0xaa, 0xab, 0x43, 0x0f, 0x55, 0x55, 0x00, 0x00, 0x00, 0x06, 0x42, 0xe2, 0xaa, 0xab, 0x43,
+    0xd8, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x07, 0x43, 0x1c, 0xaa, 0xab, 0x43, 0xcb, 0x55, 0x55, 0x00, 0x00, 0x00, 0x08, 0x42,
+    0xc8, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x02, 0x42, 0xc1, 0x55, 0x55, 0xc2, 0x05, 0x55, 0x55, 0x00, 0x00, 0x00,
+    0x04, 0xc1, 0xba, 0xaa, 0xab, 0x43, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x42, 0xa0, 0x00, 0x00, 0x43, 0x92, 0xaa,
+    0xab, 0x00, 0x00, 0x00, 0x06, 0x43, 0x34, 0x00, 0x00, 0x43, 0xaf, 0x42, 0x3a, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x04, 0x43,
+    0x85, 0x55, 0x55, 0x43, 0x5c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x43, 0x05, 0x55, 0x55, 0x43, 0xa8, 0x55, 0x55, 0x00,
+    0x00, 0x00, 0x06, 0x43, 0x5f, 0x55, 0x55, 0x43, 0xce, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x07, 0x43, 0x2d, 0x55, 0x55, 0x43,
+    0x16, 0x05, 0x43, 0x85, 0x55, 0x55, 0x43, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x42, 0x55, 0x55, 0x55, 0x43, 0x6c,
+    0xaa, 0xab, 0x00, 0x00, 0x00, 0x07, 0x42, 0x20, 0x00, 0x00, 0x44, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x43, 0xa0,
+    0x00, 0x00, 0x43, 0x9c, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x09, 0x43, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x42, 0x20, 0x00,
+    0x00, 0x42, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x42, 0x62, 0xaa, 0xab, 0x43, 0x83, 0xaa, 0xab, 0x00, 0x00, 0x00,
+    0x03, 0x43, 0x0f, 0x55, 0x55, 0x42, 0xe2, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x04, 0xc2, 0x85, 0x55, 0x55, 0x43, 0x7a, 0x00,
+    0x00, 0x0e, 0xb7, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x06, 0x43, 0x69, 0x55, 0x55, 0x43, 0xc8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x07, 0x42, 0x7d, 0x55, 0x55, 0x43, 0x8f, 0x55, 0x55, 0x00, 0x00, 0x00, 0x09, 0xc1, 0x20, 0x00, 0x00, 0x43,
+    0xcd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x43, 0x9b, 0x00, 0x00, 0x23, 0x55, 0x55, 0x43, 0x87, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0x43, 0x80, 0x55, 0x55, 0x43, 0x58, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x05, 0x43, 0x08, 0xaa, 0xab, 0x43, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x42, 0xf6, 0xaa, 0xab, 0x43, 0xda, 0x55, 0x55, 0x00, 0x00, 0x00, 0x07, 0x42, 0xc8,
+    0x00, 0x55, 0x55, 0x43, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x42, 0x05, 0x55, 0x55, 0x43, 0x20, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x05, 0x41, 0x20, 0x00, 0x00, 0x43, 0x5c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x42, 0xdc, 0x00, 0x00, 0x43,
+    0xbc, 0x55, 0x55, 0x00, 0x00, 0x00, 0x07, 0x43, 0x73, 0x55, 0x55, 0x00, 0x00, 0x43, 0x8d, 0xaa, 0xab, 0x00, 0x00, 0x00,
+    0x05, 0xc2, 0x62, 0xaa, 0xab, 0x43, 0x85, 0x55, 0x55, 0x00, 0x00, 0x00, 0x06, 0x42, 0x2d, 0x55, 0x55, 0x43, 0x83, 0xaa,
+    0xab, 0x00, 0x00, 0x00, 0x08, 0x42, 0xe9, 0x55, 0x55, 0x43, 0xe1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x42, 0xba, 0xaa,
+    0xab, 0x70, 0x00, 0x00, 0x42, 0x3a, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x03, 0x42, 0xc8, 0x00, 0x00, 0x43, 0x3e, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x04, 0x42, 0x12, 0xaa, 0xab, 0x43, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x42, 0xfd, 0x55, 0x55,
+    0x43, 0xcb, 0x55, 0x55, 0x00, 0x00, 0x00, 0x06, 0x42, 0xc8, 0x00, 0x66, 0x00, 0x00, 0x43, 0x48, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x05, 0x40, 0xd5, 0x55, 0x55, 0x43, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x43, 0x55, 0x55, 0x55, 0x43, 0xa6,
+    0xaa, 0xab, 0x00, 0x00, 0x00, 0x07, 0x42, 0xc8, 0x00, 0x00, 0x44, 0x07, 0xd5, 0x55, 0x00, 0x00, 0x00, 0x08, 0x42, 0xc8,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0x54, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01, 0x43, 0x91, 0x00, 0x00, 0x43, 0x58,
+    0xaa, 0xab, 0x00, 0x00, 0x00, 0x02, 0x43, 0x7a, 0x00, 0x00, 0x43, 0xc8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x43, 0x91,
+    0x00, 0x00, 0x43, 0xe9, 0x55, 0x55, 0x00, 0x00, 0x00, 0x05, 0x42, 0x23, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x03,
+    0x43, 0x2d, 0x55, 0x55, 0x43, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x43, 0x23, 0x55, 0x55, 0x43, 0x9b, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x07, 0x43, 0x08, 0xaa, 0xab, 0x43, 0xe1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x42, 0x2d, 0x55, 0x55,
+    0x44, 0x00, 0x00, 0x43, 0x44, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x02, 0x43, 0x0c, 0x00, 0x00, 0x43, 0x20, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x03, 0x43, 0x70, 0x00, 0x00, 0x43, 0x8c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x42, 0xe9, 0x55, 0x55, 0x43,
+    0x7a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x41, 0xf0, 0x00, 0x00, 0x55, 0x55, 0x43, 0x94, 0x55, 0x55, 0x00, 0x00, 0x00,
+    0x06, 0x42, 0xf6, 0xaa, 0xab, 0x43, 0xfa, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x28, 0xf8, 0x00, 0x00, 0x43, 0xc8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x42, 0xc8, 0x00, 0x00, 0x44, 0x03, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x09, 0x40, 0x55, 0x55,
+    0x55, 0xfa, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x03, 0x43, 0x30, 0xaa, 0xab, 0x43, 0xb2, 0x55, 0x55, 0x00, 0x00,
+    0x00, 0x04, 0x43, 0x0c, 0x00, 0x00, 0x43, 0xa6, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x05, 0x43, 0x5c, 0x00, 0x00, 0x43, 0x66,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x40, 0x55, 0x55, 0x55, 0x43, 0x77, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01,
+    0x41, 0xf0, 0x00, 0x00, 0x42, 0xba, 0xaa, 0xab, 0x00, 0x00, 0x00, 0x04, 0x43, 0x3a, 0xaa, 0xab, 0x43, 0x7a, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x06, 0xc2, 0x99, 0x55, 0x55, 0x43, 0xaf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x43, 0x34, 0x00, 0x00,
+    0x43, 0x00, 0x0a, 0xc6, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x01, 0x42, 0xc8, 0x00, 0x00, 0x42, 0xc8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x02, 0x43, 0x1c, 0xaa, 0xab, 0x43, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x43, 0x05, 0x55, 0x55,
+    0x43, 0x2d, 0x55, 0x55, 0x00, 0x00, 0x00, 0x05, 0x42, 0xc8, 0x00, 0x52, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x01,
+    0x42, 0xc8, 0x00, 0x00, 0x43, 0x2d, 0x55, 0x55, 0x00, 0x00, 0x00, 0x02, 0x43, 0x4b, 0x55, 0x55, 0x43, 0x16, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x05, 0x43, 0x34, 0x00, 0x00, 0x43, 0x9b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x42, 0xd5, 0x55, 0x55,
+    0x43, 0xde, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x42, 0xc8, 0x00, 0x00, 0x42, 0xce, 0xaa, 0xab, 0x00, 0x00,
+    0x00, 0x02, 0x42, 0xc8, 0x00, 0x00, 0x43, 0x19, 0x55, 0x55, 0x00, 0x00, 0x00, 0x03, 0x42, 0xc8, 0x00, 0x00, 0x43, 0x9e,
+    0x55, 0x55, 0x00, 0x00, 0x00, 0x04, 0x43, 0x4e, 0xaa, 0xab, 0x43, 0x03, 0x42, 0xc8, 0x00, 0x00, 0x43, 0x48, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x04, 0x42, 0xc8, 0x00, 0x00, 0x43, 0x7a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x42, 0xce, 0xaa, 0xab,
+    0x43, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06,
+};
+
+}// namespace
+
+std::span<const uint8_t> rtype::srv::PayloadCompressor::dictionary() noexcept
+{
+    return DICTIONARY;
+}
@@ -5,7 +5,6 @@
 #include <RTypeSrv/Utils/Logger.hpp>
 #include <cerrno>
 #include <cstring>
-#include <deque>
 #include <iomanip>
 #include <sstream>
 
@@ -13,57 +12,10 @@
     #include <netinet/in.h>
 #endif
 
-namespace {
-
-struct SendBuf {
-        std::vector<uint8_t> data;
-        size_t offset = 0;
-};
-
-std::deque<SendBuf> prepareTcpSendQueue(std::vector<std::vector<uint8_t>> &bufs)
-{
-    std::deque<SendBuf> sendQueue;
-    for (auto &buf : bufs) {
-        if (!buf.empty())
-            sendQueue.push_back(SendBuf{std::move(buf), 0});
-    }
-    bufs.clear();
-    return sendQueue;
-}
-
-void processTcpSendQueue(const rtype::network::Handle handle, std::deque<SendBuf> &sendQueue)
-{
-    while (!sendQueue.empty()) {
-        auto &[data, offset] = sendQueue.front();
-        const size_t to_send = data.size() - offset;
-        const ssize_t sent = rtype::network::send(handle, data.data() + offset, static_cast<rtype::network::BufLen>(to_send), 0);
-        if (sent < 0) {
-            break;
-        }
-        offset += static_cast<size_t>(sent);
-        if (offset == data.size()) {
-            sendQueue.pop_front();
-        } else {
-            break;
-        }
-    }
-}
-
-void updateTcpSendBuffers(std::deque<SendBuf> &sendQueue, std::vector<std::vector<uint8_t>> &bufs)
-{
-    for (auto &[data, offset] : sendQueue) {
-        if (offset < data.size()) {
-            std::vector remaining(data.begin() + static_cast<long long>(offset), data.end());
-            bufs.push_back(std::move(remaining));
-        }
-    }
-}
-
-}// namespace
-
 void rtype::srv::GameServer::_recvTcpPackets()
 {
-    std::vector<uint8_t> buffer(1024);
+    PacketBuffer buffer = _packet_pool.acquire();
+    buffer.resize(PacketBuffer::capacity());
 
     const ssize_t ret = network::recv(_tcp_handle, buffer.data(), static_cast<network::BufLen>(buffer.size()), 0);
 
@@ -97,20 +49,55 @@ void rtype::srv::GameServer::_sendTcpPackets()
 
     auto &bufs = it->second;
     if (bufs.empty()) {
-        for (auto &fd : _fds) {
-            if (fd.handle == _tcp_handle) {
-                fd.events &= ~POLLOUT;
+        _reactor.modify(_tcp_handle, Reactor::READ);
+        return;
+    }
+
+    // Packets leave the queue only once fully written; a partial write is resumed from _tcp_send_offset.
+    std::size_t done = 0;
+    while (done < bufs.size()) {
+        const auto &data = bufs[done];
+        if (_tcp_send_offset < data.size()) {
+            const std::size_t to_send = data.size() - _tcp_send_offset;
+            const ssize_t sent =
+                network::send(_tcp_handle, data.data() + _tcp_send_offset, static_cast<network::BufLen>(to_send), 0);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    ++_tcp_stats.would_block;
+                } else {
+                    ++_tcp_stats.errors;
+                }
+                break;
+            }
+            if (static_cast<std::size_t>(sent) < to_send) {
+                ++_tcp_stats.partial;
+            }
+            _tcp_send_offset += static_cast<std::size_t>(sent);
+            if (_tcp_send_offset < data.size()) {
                 break;
             }
         }
-        return;
+        _tcp_send_offset = 0;
+        ++done;
     }
-
-    auto sendQueue = prepareTcpSendQueue(bufs);
-    processTcpSendQueue(_tcp_handle, sendQueue);
-    updateTcpSendBuffers(sendQueue, bufs);
+    bufs.erase(bufs.begin(), bufs.begin() + static_cast<std::ptrdiff_t>(done));
 }
 
+/**
+ * @brief Gateway commands; min_payload is checked against the bytes following the command byte.
+ */
+constexpr rtype::srv::GameServer::TcpCommandTable rtype::srv::GameServer::TCP_COMMANDS{
+    {.cmd = GWPcol::CMD::CREATE, .name = "CREATE", .handler = &GameServer::handleCreate, .min_payload = GWPcol::Create::size},
+    {.cmd = GWPcol::CMD::GS_OK, .name = "GS_OK", .handler = &GameServer::_handleGatewayOKKO},
+    {.cmd = GWPcol::CMD::GS_KO, .name = "GS_KO", .handler = &GameServer::_handleGatewayOKKO},
+    {.cmd = GWPcol::CMD::OCCUPANCY, .name = "OCCUPANCY", .handler = &GameServer::_handleOccupancyRequest},
+};
+
+/**
+ * @brief Dispatches the complete gateway messages buffered so far.
+ *
+ * A message whose payload has not fully arrived is left in the buffer for the next read.
+ */
 void rtype::srv::GameServer::_parseTcpPackets()
 {
     const auto it = _tcp_recv_spans.find(_tcp_handle);
@@ -121,24 +108,20 @@ void rtype::srv::GameServer::_parseTcpPackets()
     auto &buf = it->second;
     std::size_t offset = 0;
     while (offset < buf.size()) {
+        const std::size_t start = offset;
         try {
-            uint8_t cmd = GameServerPacketParser::parseHeader(buf.data(), offset, buf.size());
-
-            switch (cmd) {
-                case 21:
-                case 22:
-                    _handleGatewayOKKO(cmd, buf.data(), offset, buf.size());
-                    break;
-                case 23:
-                    _handleOccupancyRequest(buf.data(), offset, buf.size());
-                    break;
-                case 3:
-                    handleCreate(_tcp_handle, buf.data(), offset, buf.size());
-                    break;
-                default:
-                    utils::cerr("Unknown packet type from TCP gateway: ", static_cast<int>(cmd));
-                    break;
+            const auto cmd = static_cast<GWPcol::CMD>(GameServerPacketParser::parseHeader(buf.data(), offset, buf.size()));
+            const TcpCommandTable::Route *route = TCP_COMMANDS.find(cmd);
+            if (route == nullptr) {
+                utils::cerr("Unknown packet type from TCP gateway: ", static_cast<int>(cmd));
+                offset += 1;
+                continue;
             }
+            if (buf.size() - offset - 1 < route->min_payload) {
+                offset = start;
+                break;
+            }
+            TcpCommandTable::call(*route, _tcp_commands, *this, _tcp_handle, buf.data(), offset, buf.size());
         } catch (const std::exception &e) {
             utils::cerr("Error parsing TCP packet: ", e.what());
             break;
@@ -151,29 +134,26 @@ void rtype::srv::GameServer::_parseTcpPackets()
 
 void rtype::srv::GameServer::_sendGSRegistration()
 {
-    std::vector<uint8_t> packet = GameServerPacketParser::buildGSRegistration(_base_endpoint.ip, _base_endpoint.port);
+    PacketBuffer packet = GameServerPacketParser::buildGSRegistration(_packet_pool, _base_endpoint.ip, _base_endpoint.port);
     _tcp_send_spans[_tcp_handle].push_back(std::move(packet));
-    for (auto &fd : _fds) {
-        if (fd.handle == _tcp_handle) {
-            fd.events |= POLLOUT;
-            break;
-        }
-    }
+    setPolloutForHandle(_tcp_handle);
     utils::cout("Sent GS registration to gateway");
 }
 
-void rtype::srv::GameServer::_handleGatewayOKKO(uint8_t cmd, [[maybe_unused]] const uint8_t *data, std::size_t &offset,
+void rtype::srv::GameServer::_handleGatewayOKKO([[maybe_unused]] network::Handle handle, const uint8_t *data, std::size_t &offset,
     [[maybe_unused]] std::size_t bufsize)
 {
+    const auto cmd = static_cast<GWPcol::CMD>(data[offset]);
     offset += 1;
-    if (cmd == 21) {
+    if (cmd == GWPcol::CMD::GS_OK) {
         utils::cout("Successfully registered with TCP gateway");
     } else {
         utils::cerr("Failed to register with TCP gateway");
     }
 }
 
-void rtype::srv::GameServer::_handleOccupancyRequest([[maybe_unused]] const uint8_t *data, std::size_t &offset, std::size_t bufsize)
+void rtype::srv::GameServer::_handleOccupancyRequest([[maybe_unused]] network::Handle handle, [[maybe_unused]] const uint8_t *data,
+    std::size_t &offset, std::size_t bufsize)
 {
     if (offset + 1 > bufsize) {
         throw std::runtime_error("Incomplete occupancy request from gateway");
@@ -181,7 +161,7 @@ void rtype::srv::GameServer::_handleOccupancyRequest([[maybe_unused]] const uint
     offset += 1;
 
     constexpr uint8_t occupancy = 0;
-    std::vector<uint8_t> response = GameServerPacketParser::buildOccupancy(occupancy);
+    PacketBuffer response = GameServerPacketParser::buildOccupancy(_packet_pool, occupancy);
     {
         std::ostringstream ss;
         ss << std::hex << std::setfill('0');
@@ -193,11 +173,6 @@ void rtype::srv::GameServer::_handleOccupancyRequest([[maybe_unused]] const uint
         utils::cout("Outgoing OCCUPANCY (hex): ", ss.str());
     }
     _tcp_send_spans[_tcp_handle].push_back(std::move(response));
-    for (auto &fd : _fds) {
-        if (fd.handle == _tcp_handle) {
-            fd.events |= POLLOUT;
-            break;
-        }
-    }
+    setPolloutForHandle(_tcp_handle);
     utils::cout("Sent occupancy response to gateway: ", static_cast<int>(occupancy));
 }
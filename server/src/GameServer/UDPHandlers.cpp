@@ -2,12 +2,14 @@
 #include <RTypeSrv/Components.hpp>
 #include <RTypeSrv/GameServer.hpp>
 #include <RTypeSrv/GameServerUDPPacketParser.hpp>
+#include <RTypeSrv/ReusePortGroup.hpp>
 #include <RTypeSrv/Utils/Crypto.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
 #include <algorithm>
 #include <cstdlib>
 #include <openssl/crypto.h>
 #include <random>
+#include <span>
 #include <string>
 
 static std::string safeGetEnv(const char *name)
@@ -29,24 +31,32 @@ static std::string safeGetEnv(const char *name)
 
 namespace rtype::srv {
 
-void GameServer::handleUDPJoin(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId)
+void GameServer::handleUDPJoin(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received)
 {
-    if (offset + 6 > bufsize) {
+    const uint32_t clientId = packet.clientId();
+    std::size_t offset = 0;
+    const auto join = GSPcol::Join::read(packet.payload(), offset);
+    if (!join) {
         utils::cerr("Incomplete UDP JOIN packet");
         return;
     }
-    uint32_t payload_client_id =
-        static_cast<uint32_t>((data[offset] << 24) | (data[offset + 1] << 16) | (data[offset + 2] << 8) | data[offset + 3]);
-    offset += 4;
-
-    if (payload_client_id != clientId) {
+    if (join->get<GSPcol::field::ClientId>() != clientId) {
         utils::cerr("Client ID mismatch in JOIN packet");
         return;
     }
-    uint8_t nonce = data[offset++];
-    uint8_t version = data[offset++];
+    // This worker's games have IDs of its shard: a client of another residue would be steered elsewhere afterwards.
+    if (_shard && ReusePortGroup::shardOf(clientId, _shard->count) != _shard->index) {
+        utils::cerr("Rejected UDP JOIN from client ", clientId, ": its ID belongs to worker ",
+            ReusePortGroup::shardOf(clientId, _shard->count), ", not ", _shard->index,
+            " (an ID must have the residue of its game ID modulo ", _shard->count, ")");
+        return;
+    }
+    const uint8_t nonce = join->get<GSPcol::field::Nonce>();
+    const uint8_t version = join->get<GSPcol::field::ClientVersion>();
     utils::cout("UDP JOIN from client ", clientId, " (nonce=", static_cast<int>(nonce), ", version=", static_cast<int>(version), ")");
     _endpoint_to_client[endpoint] = clientId;
+    _ep_snapshot_encoding[endpoint] = version >= GameServerUDPPacketParser::QUANTIZED_SNAPSHOT_VERSION ? snapshot::Encoding::QUANTIZED
+                                                                                                      : snapshot::Encoding::FLOAT;
 
     network::Handle client_handle = 0;
     if (auto itc = _client_ids.find(clientId); itc != _client_ids.end()) {
@@ -54,15 +64,17 @@ void GameServer::handleUDPJoin(const IP &endpoint, const uint8_t *data, std::siz
         _endpoint_to_handle[endpoint] = client_handle;
     }
 
-    if (client_handle != 0) {
-        _client_sequence_nums[client_handle] = 0;
-        _last_received_seq[client_handle] = 0;
-        _sack_bits[client_handle] = 0;
-    } else {
-        _ep_sequence_nums[endpoint] = 0;
-        _ep_last_received_seq[endpoint] = 0;
-        _ep_sack_bits[endpoint] = 0;
+    // A JOIN starts the session over: sequence numbers, acknowledgements and RO order count from it.
+    ReliableChannel &channel = _ep_channels[endpoint];
+    channel.reset();
+    _ep_outboxes[endpoint].clear();
+    _ep_sessions.erase(endpoint);// Its key goes with the authentication the JOIN restarts
+    _ep_mtu.erase(endpoint);     // Its probe SEQ too; probing resumes once authenticated
+    if (_udp.max_rate > 0) {
+        _ep_congestion[endpoint] = CongestionController{};
     }
+    (void) channel.receive(packet, received, _reliable_stats);
+    (void) channel.order(packet, received, _reliable_stats);
 
     ClientState state;
     state.authState = AuthState::CHALLENGED;
@@ -99,10 +111,6 @@ void GameServer::handleUDPJoin(const IP &endpoint, const uint8_t *data, std::siz
         aentry.timestamp = std::chrono::steady_clock::now();
         aentry.attempts = 0;
         _auth_states[client_handle] = aentry;
-
-        auto response = GameServerUDPPacketParser::buildChallengeWithCookie(_client_sequence_nums[client_handle]++,
-            _last_received_seq[client_handle], _sack_bits[client_handle], clientId, timestamp, cookie);
-        _send_spans[endpoint].push_back(std::move(response));
     } else {
         _ep_client_states[endpoint] = state;
         AuthChallenge aentry;
@@ -110,12 +118,10 @@ void GameServer::handleUDPJoin(const IP &endpoint, const uint8_t *data, std::siz
         aentry.timestamp = std::chrono::steady_clock::now();
         aentry.attempts = 0;
         _ep_auth_states[endpoint] = aentry;
-
-        auto response = GameServerUDPPacketParser::buildChallengeWithCookie(_ep_sequence_nums[endpoint]++, _ep_last_received_seq[endpoint],
-            _ep_sack_bits[endpoint], clientId, timestamp, cookie);
-        _send_spans[endpoint].push_back(std::move(response));
     }
-    setPolloutForHandle(_sock.handle);
+    PacketWriter challenge =
+        _ep_outboxes[endpoint].append(GSPcol::CMD::CHALLENGE, GSPcol::FLAGS::RELIABLE, GSPcol::CHANNEL::RO, GSPcol::Challenge::size);
+    GSPcol::Challenge::write(challenge, timestamp, cookie);
 
     if (!_game_instances.empty()) {
         uint32_t game_id = _game_instances.begin()->first;
@@ -133,8 +139,9 @@ void GameServer::handleUDPJoin(const IP &endpoint, const uint8_t *data, std::siz
     }
 }
 
-void GameServer::handleUDPInput(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId)
+void GameServer::handleUDPInput(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received)
 {
+    const uint32_t clientId = packet.clientId();
     if (_client_to_game.count(clientId) == 0) {
         utils::cerr("Received input from client ", clientId, " who is not in a game.");
         return;
@@ -144,9 +151,12 @@ void GameServer::handleUDPInput(const IP &endpoint, const uint8_t *data, std::si
 
     // Parse input
     // Format : [TYPE:1] where TYPE is 1=UP, 2=DOWN, etc.
-    if (offset + 1 > bufsize)
+    const std::span<const uint8_t> data = packet.payload();
+    std::size_t offset = 0;
+    const auto input = GSPcol::Input::read(data, offset);
+    if (!input)
         return;
-    uint8_t input_type = data[offset++];
+    const uint8_t input_type = input->get<GSPcol::field::InputType>();
 
     PlayerAction action;
     switch (input_type) {
@@ -166,10 +176,11 @@ void GameServer::handleUDPInput(const IP &endpoint, const uint8_t *data, std::si
     if (events_ptr) {
         r::ecs::EventWriter<PlayerInputEvent> writer(events_ptr);
         writer.send({clientId, action});
+        _pending_inputs.push_back(received);
         utils::cout("Input from client ", clientId, " sent to ECS.");
     }
 
-    while (offset + 2 <= bufsize) {
+    while (offset + 2 <= data.size()) {
         uint8_t type = data[offset++];
         uint8_t value = data[offset++];
         switch (static_cast<GSPcol::INPUT>(type)) {
@@ -182,94 +193,208 @@ void GameServer::handleUDPInput(const IP &endpoint, const uint8_t *data, std::si
                 break;
         }
     }
-    network::Handle client_handle = 0;
     if (auto itc = _client_ids.find(clientId); itc != _client_ids.end()) {
-        client_handle = itc->second;
-        _endpoint_to_handle[endpoint] = client_handle;
-    }
-    uint32_t new_last = (static_cast<uint32_t>(data[5]) << 24) | (static_cast<uint32_t>(data[6]) << 16)
-        | (static_cast<uint32_t>(data[7]) << 8) | static_cast<uint32_t>(data[8]);
-    if (client_handle != 0) {
-        _last_received_seq[client_handle] = new_last;
-        _sack_bits[client_handle] = static_cast<uint8_t>((_sack_bits[client_handle] << 1) | 1);
-    } else {
-        _ep_last_received_seq[endpoint] = new_last;
-        _ep_sack_bits[endpoint] = static_cast<uint8_t>((_ep_sack_bits[endpoint] << 1) | 1);
+        _endpoint_to_handle[endpoint] = itc->second;
     }
 }
 
-void GameServer::handleUDPPing(const IP &endpoint, [[maybe_unused]] const uint8_t *data, [[maybe_unused]] std::size_t &offset,
-    [[maybe_unused]] std::size_t bufsize, uint32_t clientId)
+void GameServer::handleUDPPing(const IP &endpoint, const GspHeaderView &packet,
+    [[maybe_unused]] std::chrono::steady_clock::time_point received)
 {
-    network::Handle client_handle = 0;
-    if (auto itc = _client_ids.find(clientId); itc != _client_ids.end()) {
-        client_handle = itc->second;
-        _endpoint_to_handle[endpoint] = client_handle;
+    const uint32_t clientId = packet.clientId();
+    if (!_ep_channels.contains(endpoint)) {
+        // Not joined: answered at once and forgotten, since the source may be spoofed.
+        const GameServerUDPPacketParser::HeaderFields header{.version = packet.version()};
+        PacketBuffer pong = _packet_pool.acquire();
+        PacketWriter out(pong.storage());
+        GameServerUDPPacketParser::writeHeader(out, GSPcol::CMD::PONG, GSPcol::FLAGS::CONN, header, GSPcol::CHANNEL::UU,
+            static_cast<uint16_t>(GameServerUDPPacketParser::headerSize(header.version)), clientId);
+        pong.resize(out.size());
+        const network::Endpoint to{endpoint.first, endpoint.second};
+        if (_uring) {
+            _uring->push(to, std::move(pong));
+        } else {
+            _send_queue.push(to, std::move(pong));
+        }
+        setPolloutForHandle(_sock.handle);
+        return;
     }
-    if (client_handle != 0) {
-        _latency_metrics[client_handle].last_ping = std::chrono::steady_clock::now();
-        auto response = GameServerUDPPacketParser::buildPongResponse(_client_sequence_nums[client_handle]++,
-            _last_received_seq[client_handle], _sack_bits[client_handle], clientId);
-        _send_spans[endpoint].push_back(std::move(response));
-    } else {
-        _latency_metrics[0].last_ping = std::chrono::steady_clock::now();
-        auto response = GameServerUDPPacketParser::buildPongResponse(_ep_sequence_nums[endpoint]++, _ep_last_received_seq[endpoint],
-            _ep_sack_bits[endpoint], clientId);
-        _send_spans[endpoint].push_back(std::move(response));
+    if (auto itc = _client_ids.find(clientId); itc != _client_ids.end()) {
+        _endpoint_to_handle[endpoint] = itc->second;
     }
-    setPolloutForHandle(_sock.handle);
+    _ep_outboxes[endpoint].push(GSPcol::CMD::PONG, GSPcol::FLAGS::CONN, GSPcol::CHANNEL::UU, {});
 }
 
-void GameServer::handleUDPPong([[maybe_unused]] const IP &endpoint, [[maybe_unused]] const uint8_t *data,
-    [[maybe_unused]] std::size_t &offset, [[maybe_unused]] std::size_t bufsize, uint32_t clientId)
+/**
+ * @brief Measures the RTT of the last PING sent to a client, from the first PONG that follows it.
+ *
+ * Both ends use kernel timestamps when available (the PING transmit time and this
+ * PONG's receive time), so the time the PONG waited in the socket buffer and the
+ * server loop is not counted as network latency.
+ */
+void GameServer::handleUDPPong(const IP &endpoint, const GspHeaderView &packet, std::chrono::steady_clock::time_point received)
 {
-    auto now = std::chrono::steady_clock::now();
-    network::Handle client_handle = 0;
+    const uint32_t clientId = packet.clientId();
     if (auto itc = _client_ids.find(clientId); itc != _client_ids.end()) {
-        client_handle = itc->second;
-        _endpoint_to_handle[endpoint] = client_handle;
+        _endpoint_to_handle[endpoint] = itc->second;
     }
-    auto &metrics = (client_handle != 0) ? _latency_metrics[client_handle] : _latency_metrics[0];
-    if (metrics.last_ping.time_since_epoch().count() != 0) {
-        auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(now - metrics.last_ping);
+    const auto it = _latency_metrics.find(endpoint);
+    if (it != _latency_metrics.end() && it->second.ping_sent.time_since_epoch().count() != 0 && received >= it->second.ping_sent) {
+        LatencyMetrics &metrics = it->second;
+        auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(received - metrics.ping_sent);
         metrics.min_rtt = (std::min) (metrics.min_rtt, rtt);
         metrics.max_rtt = (std::max) (metrics.max_rtt, rtt);
         metrics.avg_rtt = (metrics.avg_rtt * metrics.samples + rtt) / (metrics.samples + 1);
+        metrics.srtt = metrics.samples == 0 ? rtt : (metrics.srtt * 7 + rtt) / 8;
         metrics.samples++;
+        metrics.ping_sent = {};// One sample per PING: the PONGs answering MTU probes match none
         utils::cout("PONG from client ", clientId, " RTT(us)=", rtt.count(), " avg(us)=", metrics.avg_rtt.count());
     } else {
         utils::cout("PONG from client ", clientId, " (no matching ping timestamp)");
     }
 }
 
-void GameServer::handleUDPResync(const IP &endpoint, [[maybe_unused]] const uint8_t *data, [[maybe_unused]] std::size_t &offset,
-    [[maybe_unused]] std::size_t bufsize, uint32_t clientId)
+void GameServer::handleUDPResync(const IP &endpoint, const GspHeaderView &packet,
+    [[maybe_unused]] std::chrono::steady_clock::time_point received)
 {
+    const uint32_t clientId = packet.clientId();
     utils::cout("Resync requested from client ", clientId);
 
-    // TODO: Get current game state
-    std::vector<uint8_t> state_data = {1, 2, 3, 4};
-    uint32_t snapshot_seq = 1;
-    network::Handle client_handle = 0;
     if (auto itc = _client_ids.find(clientId); itc != _client_ids.end()) {
-        client_handle = itc->second;
-        _endpoint_to_handle[endpoint] = client_handle;
+        _endpoint_to_handle[endpoint] = itc->second;
     }
-    if (client_handle != 0) {
-        auto response = GameServerUDPPacketParser::buildSnapshot(_client_sequence_nums[client_handle]++, _last_received_seq[client_handle],
-            _sack_bits[client_handle], clientId, snapshot_seq, state_data);
-        _send_spans[endpoint].push_back(std::move(response));
-    } else {
-        auto response = GameServerUDPPacketParser::buildSnapshot(_ep_sequence_nums[endpoint]++, _ep_last_received_seq[endpoint],
-            _ep_sack_bits[endpoint], clientId, snapshot_seq, state_data);
-        _send_spans[endpoint].push_back(std::move(response));
+    _ep_snapshot_acks[endpoint].reset();
+    const auto game = _client_to_game.find(clientId);
+    if (game == _client_to_game.end()) {
+        return;
+    }
+    // The keyframe must be of the client's view, as its next deltas will be; without one yet, the next tick sends it.
+    const auto view = _ep_views.find(endpoint);
+    if (view == _ep_views.end() || view->second.history.latest() == nullptr) {
+        return;
+    }
+    _queueClientSnapshot(endpoint, game->second, view->second.history);
+}
+
+void GameServer::handleUDPFragment(const IP &endpoint, const GspHeaderView &packet, const std::chrono::steady_clock::time_point received)
+{
+    const auto fragment = GSPcol::Fragment::at(packet.payload().data());
+    const uint32_t base_seq = fragment.get<GSPcol::field::BaseSeq>();
+    const uint32_t total_size = fragment.get<GSPcol::field::TotalSize>();
+    const uint32_t offset = fragment.get<GSPcol::field::FragmentOffset>();
+    const std::span<const uint8_t> data = packet.payload().subspan(GSPcol::Fragment::size);
+    if (total_size <= GameServerUDPPacketParser::HEADER_SIZE || total_size > GameServerUDPPacketParser::MAX_MESSAGE_SIZE
+        || offset >= total_size || data.size() > total_size - offset) {
+        ++_fragment_stats.rejected;
+        utils::cerr("Dropped malformed fragment from client ", packet.clientId());
+        return;
+    }
+
+    auto it = _fragment_buffers.find({endpoint, base_seq});
+    if (it == _fragment_buffers.end()) {
+        const auto pending = std::ranges::count_if(_fragment_buffers, [&](const auto &kv) { return kv.first.first == endpoint; });
+        if (static_cast<std::size_t>(pending) >= MAX_FRAGMENTED_MESSAGES || _fragment_bytes + total_size > MAX_FRAGMENT_BYTES) {
+            ++_fragment_stats.rejected;
+            return;
+        }
+        it = _fragment_buffers.emplace(FragmentKey{endpoint, base_seq}, FragmentBuffer{}).first;
+        it->second.message.resize(total_size);
+        it->second.first_fragment = received;
+        _fragment_bytes += total_size;
+    }
+    FragmentBuffer &buffer = it->second;
+    const auto end = static_cast<uint32_t>(offset + data.size());
+    const bool overlaps = std::ranges::any_of(buffer.fragments, [&](const auto &f) { return offset < f.second && f.first < end; });
+    if (buffer.message.size() != total_size || buffer.fragments.size() >= MAX_FRAGMENTS || overlaps) {
+        // A retransmitted fragment is a harmless duplicate; anything else poisons the message.
+        const bool duplicate = std::ranges::find(buffer.fragments, std::pair{offset, end}) != buffer.fragments.end();
+        if (!duplicate) {
+            ++_fragment_stats.rejected;
+            _fragment_bytes -= buffer.message.size();
+            _fragment_buffers.erase(it);
+        }
+        return;
+    }
+    std::ranges::copy(data, buffer.message.begin() + static_cast<std::ptrdiff_t>(offset));
+    buffer.fragments.emplace_back(offset, end);
+    buffer.received += data.size();
+    if (buffer.received < buffer.message.size()) {
+        return;
+    }
+
+    const std::vector<uint8_t> message = std::move(buffer.message);
+    _fragment_bytes -= message.size();
+    _fragment_buffers.erase(it);
+    const auto inner = GspHeaderView::parse(message);
+    if (!inner || inner->cmd() == GSPcol::CMD::FRAGMENT || inner->hasFlag(GSPcol::FLAGS::FRAGMENT)
+        || inner->clientId() != packet.clientId()) {
+        ++_fragment_stats.rejected;
+        utils::cerr("Dropped invalid reassembled message from client ", packet.clientId());
+        return;
+    }
+    ++_fragment_stats.reassembled;
+    _deliverUDP(endpoint, *inner, received);
+}
+
+/**
+ * @brief Applies an explicit acknowledgement: [SEQ:4]... of reliable server packets.
+ */
+void GameServer::handleUDPAck(const IP &endpoint, const GspHeaderView &packet, const std::chrono::steady_clock::time_point received)
+{
+    const auto channel = _ep_channels.find(endpoint);
+    if (channel == _ep_channels.end()) {
+        return;
+    }
+    const std::span<const uint8_t> data = packet.payload();
+    for (std::size_t offset = 0; const auto entry = GSPcol::AckEntry::read(data, offset);) {
+        channel->second.acknowledge(entry->get<GSPcol::field::Seq>(), received, _reliable_stats);
+    }
+}
+
+/**
+ * @brief Dispatches the messages of a CMD_BATCH: ([CMD:1][FLAGS:1][LEN:2][PAYLOAD:LEN])...
+ *
+ * Each message reaches its handler as the packet it would have been alone: the batch
+ * header with its CMD, FLAGS and SIZE. The batch was received and ordered as a whole,
+ * so its messages are dispatched in sequence. Batches and fragments cannot be nested
+ * in a batch; a truncated entry drops the rest of it.
+ */
+void GameServer::handleUDPBatch(const IP &endpoint, const GspHeaderView &packet, const std::chrono::steady_clock::time_point received)
+{
+    const std::span<const uint8_t> header = packet.bytes().first(packet.headerSize());
+    const std::span<const uint8_t> data = packet.payload();
+    for (std::size_t offset = 0; offset < data.size();) {
+        const auto entry = GSPcol::BatchEntry::read(data, offset);
+        if (!entry || data.size() - offset < entry->get<GSPcol::field::Length>()) {
+            utils::cerr("Dropped truncated BATCH from client ", packet.clientId());
+            return;
+        }
+        const std::span<const uint8_t> payload = data.subspan(offset, entry->get<GSPcol::field::Length>());
+        offset += payload.size();
+        const GSPcol::CMD cmd = entry->get<GSPcol::field::Cmd>();
+        if (cmd == GSPcol::CMD::BATCH || cmd == GSPcol::CMD::FRAGMENT) {
+            utils::cerr("Dropped nested ", cmd == GSPcol::CMD::BATCH ? "BATCH" : "FRAGMENT", " from client ", packet.clientId());
+            continue;
+        }
+        _batch_scratch.assign(header.begin(), header.end());
+        _batch_scratch.insert(_batch_scratch.end(), payload.begin(), payload.end());
+        uint8_t *at = _batch_scratch.data();
+        GSPcol::field::Cmd::codec::store(at + GSPcol::Header::offset<GSPcol::field::Cmd>, cmd);
+        GSPcol::field::Flags::codec::store(at + GSPcol::Header::offset<GSPcol::field::Flags>, entry->get<GSPcol::field::Flags>());
+        GSPcol::field::Size::codec::store(at + GSPcol::Header::offset<GSPcol::field::Size>, static_cast<uint16_t>(_batch_scratch.size()));
+        if (const auto message = GspHeaderView::parse(_batch_scratch)) {
+            _dispatchUDP(endpoint, *message, received);
+        }
     }
-    setPolloutForHandle(_sock.handle);
 }
 
-void GameServer::handleUDPAuthResponse(const IP &endpoint, const uint8_t *data, std::size_t &offset, std::size_t bufsize, uint32_t clientId)
+void GameServer::handleUDPAuthResponse(const IP &endpoint, const GspHeaderView &packet,
+    [[maybe_unused]] std::chrono::steady_clock::time_point received)
 {
-    if (offset + 1 + 32 > bufsize) {
+    const uint32_t clientId = packet.clientId();
+    const std::span<const uint8_t> data = packet.payload();
+    std::size_t offset = 0;
+    if (!GSPcol::Auth::fits(offset, data.size())) {
         utils::cerr("Incomplete AUTH_RESPONSE packet");
         return;
     }
@@ -290,10 +415,9 @@ void GameServer::handleUDPAuthResponse(const IP &endpoint, const uint8_t *data,
         utils::cerr("Received AUTH_RESPONSE in invalid state from client ", clientId);
         return;
     }
-    uint8_t client_nonce = data[offset++];
-    std::array<uint8_t, 32> received_cookie{};
-    std::copy_n(data + offset, 32, received_cookie.begin());
-    offset += 32;
+    const auto auth = *GSPcol::Auth::read(data, offset);
+    const uint8_t client_nonce = auth.get<GSPcol::field::Nonce>();
+    const auto received_cookie = auth.get<GSPcol::field::Cookie>();
     const std::string env_secret = safeGetEnv("R_TYPE_SHARED_SECRET");
     const bool usedEnvSecret = !env_secret.empty();
     const std::string secret_str = env_secret.empty() ? std::string("r-type-shared-secret") : env_secret;
@@ -331,24 +455,28 @@ void GameServer::handleUDPAuthResponse(const IP &endpoint, const uint8_t *data,
     std::vector<uint8_t> salt(8);
     for (size_t i = 0; i < 8; ++i)
         salt[i] = static_cast<uint8_t>((found_ts >> (56 - i * 8)) & 0xFF);
+    // Clients authenticating within the same second would share a key otherwise, and the SEQ nonces of F_ENCRYPTED with it.
+    const std::vector<uint8_t> session_salt = utils::Crypto::generateSecureRandom(16);
+    salt.insert(salt.end(), session_salt.begin(), session_salt.end());
     utils::clog("deriveKey: ikm size=", secret.size(), " source=", (usedEnvSecret ? "env" : "fallback"));
     auto derived = utils::Crypto::deriveKey(std::vector<uint8_t>(secret.begin(), secret.end()), salt);
     if (client_handle != 0) {
         auto it = _client_states.find(client_handle);
         std::copy(derived.begin(), derived.begin() + 32, it->second.sessionKey.begin());
         it->second.authState = AuthState::AUTHENTICATED;
-        auto auth_ok = GameServerUDPPacketParser::buildAuthOkPacket(_client_sequence_nums[client_handle]++,
-            _last_received_seq[client_handle], _sack_bits[client_handle], clientId, it->second.sessionKey);
-        _send_spans[endpoint].push_back(std::move(auth_ok));
+        _auth_states.erase(client_handle);// The pending challenge would otherwise expire and drop the session
+        PacketWriter auth_ok =
+            _ep_outboxes[endpoint].append(GSPcol::CMD::AUTH_OK, GSPcol::FLAGS::RELIABLE, GSPcol::CHANNEL::RO, GSPcol::AuthOk::size);
+        GSPcol::AuthOk::write(auth_ok, clientId, it->second.sessionKey);
     } else {
         auto it = _ep_client_states.find(endpoint);
         std::copy(derived.begin(), derived.begin() + 32, it->second.sessionKey.begin());
         it->second.authState = AuthState::AUTHENTICATED;
-        auto auth_ok = GameServerUDPPacketParser::buildAuthOkPacket(_ep_sequence_nums[endpoint]++, _ep_last_received_seq[endpoint],
-            _ep_sack_bits[endpoint], clientId, it->second.sessionKey);
-        _send_spans[endpoint].push_back(std::move(auth_ok));
+        _ep_auth_states.erase(endpoint);
+        PacketWriter auth_ok =
+            _ep_outboxes[endpoint].append(GSPcol::CMD::AUTH_OK, GSPcol::FLAGS::RELIABLE, GSPcol::CHANNEL::RO, GSPcol::AuthOk::size);
+        GSPcol::AuthOk::write(auth_ok, clientId, it->second.sessionKey);
     }
-    setPolloutForHandle(_sock.handle);
     utils::cout("Client ", clientId, " successfully authenticated");
 }
 
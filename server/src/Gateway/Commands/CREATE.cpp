@@ -20,39 +20,28 @@ namespace rtype::srv {
  */
 void Gateway::handleCreate(network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize)
 {
-    if (offset + 2 > bufsize) {
+    std::size_t pos = offset + 1;
+    const auto create = GWPcol::Create::read(data, pos, bufsize);
+    if (!create) {
         throw std::runtime_error("Incomplete CREATE packet");
     }
-    uint8_t gametype = data[offset + 1];
+    offset = pos;
+    const uint8_t gametype = create->get<GWPcol::field::GameType>();
     if (_gs_registry.empty()) {
-        std::vector<uint8_t> error_msg = PacketParser::buildSimpleResponse(4);
-        _send_spans[handle].push_back(std::move(error_msg));
-        setPolloutForHandle(handle);
-        offset += 2;
+        PacketBuffer error_msg = PacketParser::buildSimpleResponse(_packet_pool, 4);
+        _queueSend(handle, std::move(error_msg));
         return;
     }
     auto min_gs = findLeastOccupiedGS();
     if (!min_gs) {
-        std::vector<uint8_t> error_msg = PacketParser::buildSimpleResponse(4);
-        _send_spans[handle].push_back(std::move(error_msg));
-        setPolloutForHandle(handle);
-        offset += 2;
+        PacketBuffer error_msg = PacketParser::buildSimpleResponse(_packet_pool, 4);
+        _queueSend(handle, std::move(error_msg));
         return;
     }
-    auto &[gs_key, _] = **min_gs;
-    const network::Handle gs_handle = getGSHandle(gs_key);
-    if (gs_handle == 0) {
-        std::vector<uint8_t> error_msg = PacketParser::buildSimpleResponse(4);
-        _send_spans[handle].push_back(std::move(error_msg));
-        setPolloutForHandle(handle);
-        offset += 2;
-        return;
-    }
-    std::vector<uint8_t> create_msg = PacketParser::buildCreateMsg(gametype);
-    _send_spans[gs_handle].push_back(std::move(create_msg));
-    setPolloutForHandle(gs_handle);
+    const network::Handle gs_handle = (*min_gs)->first;
+    PacketBuffer create_msg = PacketParser::buildCreateMsg(_packet_pool, gametype);
+    _queueSend(gs_handle, std::move(create_msg));
     _pending_creates[gs_handle] = {handle, gametype};
-    offset += 2;
 }
 
 }// namespace rtype::srv
@@ -20,10 +20,10 @@ namespace rtype::srv {
  */
     void Gateway::handleGameEnd(const network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize)
     {
-        if (offset + 1 + 4 > bufsize) {
+        if (!GWPcol::GameEnd::fits(offset + 1, bufsize)) {
             throw std::runtime_error("Incomplete GAME_END packet");
         }
-        const uint32_t game_id = PacketParser::extractGameId(data + offset + 1);
+        const uint32_t game_id = GWPcol::GameEnd::at(data + offset + 1).get<GWPcol::field::GameId>();
         const std::optional<IP> gs_key = findGSKeyByHandle(handle);
         if (!gs_key) {
             throw std::runtime_error("GAME_END from unregistered game server");
@@ -35,7 +35,7 @@ namespace rtype::srv {
                 throw std::runtime_error("GAME_END for game not owned by this server");
             }
         }
-        offset += 1 + 4;
+        offset += 1 + GWPcol::GameEnd::size;
     }
 
 }// namespace rtype::srv
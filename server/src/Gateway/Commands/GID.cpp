@@ -20,11 +20,12 @@ namespace rtype::srv {
  */
 void Gateway::handleGID(const network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize)
 {
-    if (offset + 1 + 1 + 4 > bufsize) {
+    const std::size_t gid_start = offset + 1 + GWPcol::GidList::size;
+    if (!GWPcol::GidList::fits(offset + 1, bufsize)) {
         throw std::runtime_error("Incomplete GID packet");
     }
-    const uint8_t len = data[offset + 1];
-    const std::size_t expected_size = offset + 1 + 1 + (len * 4);
+    const uint8_t len = GWPcol::GidList::at(data + offset + 1).get<GWPcol::field::Count>();
+    const std::size_t expected_size = gid_start + len * GWPcol::GidEntry::size;
     if (expected_size > bufsize) {
         throw std::runtime_error("Incomplete GID packet - insufficient game IDs");
     }
@@ -32,8 +33,7 @@ void Gateway::handleGID(const network::Handle handle, const uint8_t *data, std::
     if (!gs_key) {
         throw std::runtime_error("GS handle not registered");
     }
-    const std::size_t gid_start = offset + 2;
-    const auto gids = PacketParser::parseGIDs(data, gid_start, gid_start + (len * 4));
+    const auto gids = PacketParser::parseGIDs(data, gid_start, expected_size);
     for (uint32_t gid : gids) {
         _game_to_gs[gid] = *gs_key;
     }
@@ -10,6 +10,10 @@ namespace rtype::srv {
  * Request format: [HEADER:5][CMD:20][IP:16][PORT:2]
  * Response: [HEADER:5][CMD:21] (GS_OK) or [HEADER:5][CMD:22] (GS_KO)
  *
+ * Game servers are registered per connection: the workers of a SO_REUSEPORT group
+ * advertise the same address and each of them registers. GS_KO is only returned
+ * when a connection registers twice.
+ *
  * @param handle The handle of the sender.
  * @param data A pointer to the data received.
  * @param offset A reference to the current offset in the data (points to CMD byte).
@@ -17,21 +21,19 @@ namespace rtype::srv {
  */
 void Gateway::handleGSRegistration(const network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize)
 {
-    if (offset + 1 + 16 + 2 > bufsize) {
+    if (!GWPcol::GsRegistration::fits(offset + 1, bufsize)) {
         throw std::runtime_error("Incomplete GS Registration packet");
     }
     auto [ip, port] = PacketParser::parseGSKey(data, offset + 1);
     const std::pair key = {ip, port};
-    const bool already_registered = _gs_registry.contains(key);
-    _gs_registry[key] = 1;
+    const bool already_registered = _gs_registry.contains(handle);
     if (!already_registered) {
-        _gs_addr_to_handle[key] = handle;
+        _gs_registry[handle] = key;
     }
     uint8_t response_cmd = already_registered ? 22 : 21;
-    std::vector<uint8_t> response = PacketParser::buildSimpleResponse(response_cmd);
-    _send_spans[handle].push_back(std::move(response));
-    setPolloutForHandle(handle);
-    offset += 1 + 16 + 2;
+    PacketBuffer response = PacketParser::buildSimpleResponse(_packet_pool, response_cmd);
+    _queueSend(handle, std::move(response));
+    offset += 1 + GWPcol::GsRegistration::size;
 }
 
 }// namespace rtype::srv
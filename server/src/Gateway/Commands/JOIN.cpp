@@ -24,36 +24,37 @@ namespace rtype::srv {
  */
 void Gateway::handleJoin(const network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize)
 {
-    if (offset + 1 + 4 > bufsize) {
+    const std::size_t payload = offset + 1;
+    if (!GWPcol::JoinRequest::fits(payload, bufsize)) {
         throw std::runtime_error("Incomplete JOIN packet");
     }
 
-    const uint32_t id = PacketParser::extractGameId(data + offset + 1);
+    const uint32_t id = PacketParser::extractGameId(data + payload);
+    std::size_t consumed = GWPcol::JoinRequest::size;
     if (_gs_registry.empty()) {
-        std::vector<uint8_t> error_msg = PacketParser::buildSimpleResponse(2);
-        _send_spans[handle].push_back(std::move(error_msg));
-        setPolloutForHandle(handle);
+        PacketBuffer error_msg = PacketParser::buildSimpleResponse(_packet_pool, 2);
+        _queueSend(handle, std::move(error_msg));
     } else if (const auto it = _pending_creates.find(handle); it != _pending_creates.end()) {
+        if (!GWPcol::JoinResponse::fits(payload, bufsize)) {
+            throw std::runtime_error("Incomplete JOIN response");
+        }
         const network::Handle client_handle = it->second.first;
-        std::vector<uint8_t> join_msg = PacketParser::buildJoinMsgForClient(data, offset + 1);
-        const uint32_t game_id = PacketParser::extractGameId(join_msg.data() + 5);
+        PacketBuffer join_msg = PacketParser::buildJoinMsgForClient(_packet_pool, data, payload);
         if (const std::optional<IP> gs_key = findGSKeyByHandle(handle)) {
-            _game_to_gs[game_id] = *gs_key;
+            _game_to_gs[id] = *gs_key;
         }
-        _send_spans[client_handle].push_back(std::move(join_msg));
-        setPolloutForHandle(client_handle);
+        consumed = GWPcol::JoinResponse::size;
+        _queueSend(client_handle, std::move(join_msg));
         _pending_creates.erase(it);
     } else if (_game_to_gs.contains(id)) {
         auto &[fst, snd] = _game_to_gs[id];
-        std::vector<uint8_t> join_msg = PacketParser::buildJoinMsgForGS(fst, snd, id);
-        _send_spans[handle].push_back(std::move(join_msg));
-        setPolloutForHandle(handle);
+        PacketBuffer join_msg = PacketParser::buildJoinMsgForGS(_packet_pool, fst, snd, id);
+        _queueSend(handle, std::move(join_msg));
     } else {
-        std::vector<uint8_t> error_msg = PacketParser::buildSimpleResponse(2);
-        _send_spans[handle].push_back(std::move(error_msg));
-        setPolloutForHandle(handle);
+        PacketBuffer error_msg = PacketParser::buildSimpleResponse(_packet_pool, 2);
+        _queueSend(handle, std::move(error_msg));
     }
-    offset += 1 + 4;
+    offset = payload + consumed;
 }
 
 }// namespace rtype::srv
@@ -20,16 +20,15 @@ namespace rtype::srv {
  */
 void Gateway::handleOccupancy(network::Handle handle, const uint8_t *data, std::size_t &offset, std::size_t bufsize)
 {
-    if (offset + 1 + 1 > bufsize) {
+    if (!GWPcol::OccupancyUpdate::fits(offset + 1, bufsize)) {
         throw std::runtime_error("Incomplete OCCUPANCY packet");
     }
     uint8_t occ = PacketParser::parseOccupancy(data, offset + 1);
-    const std::optional<IP> gs_key = findGSKeyByHandle(handle);
-    if (!gs_key) {
+    if (!_gs_registry.contains(handle)) {
         throw std::runtime_error("Occupancy from unregistered game server");
     }
-    _occupancy_cache[*gs_key] = occ;
-    offset += 1 + 1;
+    _occupancy_cache[handle] = occ;
+    offset += 1 + GWPcol::OccupancyUpdate::size;
 }
 
 }// namespace rtype::srv
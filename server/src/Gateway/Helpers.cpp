@@ -1,9 +1,24 @@
 #include <RTypeNet/Accept.hpp>
 #include <RTypeNet/Disconnect.hpp>
+#include <RTypeNet/Poll.hpp>
 #include <RTypeSrv/Gateway.hpp>
 #include <RTypeSrv/Utils/IPToStr.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
-#include <ranges>
+
+/**
+ * @brief Gets the state of an open connection.
+ *
+ * @param handle The handle of the connection.
+ * @return The connection, or nullptr if the handle is not an open connection.
+ */
+rtype::srv::Gateway::Connection *rtype::srv::Gateway::_connection(const network::Handle handle) noexcept
+{
+    const auto idx = static_cast<std::size_t>(handle);
+    if (idx >= _connections.size() || !_connections[idx].open) {
+        return nullptr;
+    }
+    return &_connections[idx];
+}
 
 /**
  * @brief Disconnects a client by its handle.
@@ -12,42 +27,49 @@
  */
 void rtype::srv::Gateway::_disconnectByHandle(const network::Handle &handle) noexcept
 {
-    if (const auto it = std::ranges::find_if(_sockets, [handle](const auto &pair) { return pair.second.handle == handle; });
-        it != _sockets.end()) {
-        utils::cout("Disconnecting client at ", utils::ipToStr(it->second.endpoint.ip), ":", it->second.endpoint.port);
-        disconnect(it->second);
-        _sockets.erase(it);
-    }
-    _recv_spans.erase(handle);
-    _send_spans.erase(handle);
-    for (auto it = _gs_addr_to_handle.begin(); it != _gs_addr_to_handle.end();) {
-        if (it->second == handle) {
-            _gs_registry.erase(it->first);
-            it = _gs_addr_to_handle.erase(it);
-        } else {
-            ++it;
-        }
-    }
-    if (const auto it = std::ranges::find_if(_fds.begin(), _fds.end(), [handle](const auto &elem) { return elem.handle == handle; });
-        it != _fds.end()) {
-        _fds.erase(it);
-        --_nfds;
+    _reactor.remove(handle);
+    if (Connection *conn = _connection(handle)) {
+        utils::cout("Disconnecting client at ", utils::ipToStr(conn->socket.endpoint.ip), ":", conn->socket.endpoint.port);
+        disconnect(conn->socket);
+        *conn = Connection{};
     }
+    _gs_registry.erase(handle);
+    _occupancy_cache.erase(handle);
 }
 
 /**
- * @brief Accepts new clients.
+ * @brief Accepts every pending client.
+ *
+ * The listening socket is edge-triggered, so the backlog is drained until it is empty.
+ * It is polled before each accept() rather than told empty by an EAGAIN: accept()
+ * throws, and errno does not survive building the exception.
  */
 void rtype::srv::Gateway::_acceptClients() noexcept
 {
-    try {
-        const network::Socket client_sock = network::accept(_sock.handle);
-        _fds.push_back({client_sock.handle, POLLIN | POLLOUT, 0});
-        _sockets[_next_id] = client_sock;
-        ++_nfds;
-        ++_next_id;
+    while (true) {
+        network::PollFD pending{_sock.handle, POLLIN, 0};
+        if (network::poll(&pending, 1, 0) <= 0 || (pending.revents & POLLIN) == 0) {
+            return;
+        }
+        network::Socket client_sock{};
+        try {
+            client_sock = network::accept(_sock.handle);
+        } catch (const std::exception &e) {
+            utils::cerr("Error accepting new connection: ", e.what());
+            return;
+        }
+        try {
+            _reactor.add(client_sock.handle, Reactor::READ | Reactor::EDGE);
+        } catch (const std::exception &e) {
+            utils::cerr("Error registering new connection: ", e.what());
+            disconnect(client_sock);
+            continue;
+        }
+        const auto idx = static_cast<std::size_t>(client_sock.handle);
+        if (idx >= _connections.size()) {
+            _connections.resize(idx + 1);
+        }
+        _connections[idx] = Connection{client_sock, {}, {}, 0, 0, true};
         utils::cout("New client connected: ", utils::ipToStr(client_sock.endpoint.ip), ":", client_sock.endpoint.port);
-    } catch (const std::exception &e) {
-        utils::cerr("Error accepting new connection: ", e.what());
     }
 }
@@ -2,13 +2,11 @@
 #include <RTypeNet/Cleanup.hpp>
 #include <RTypeNet/Disconnect.hpp>
 #include <RTypeNet/Listen.hpp>
-#include <RTypeNet/Poll.hpp>
 #include <RTypeNet/Startup.hpp>
 #include <RTypeSrv/Exception.hpp>
 #include <RTypeSrv/Gateway.hpp>
 #include <RTypeSrv/Utils/IPToStr.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
-#include <ranges>
 
 /**
  * @brief Starts the server.
@@ -34,63 +32,83 @@ void rtype::srv::Gateway::_startServer()
         throw Exception("startServer", "Could not start listening on ", utils::ipToStr(_tcp_endpoint.ip), ":", _tcp_endpoint.port, ": ",
             e.what());
     }
-    _fds.push_back({_sock.handle, POLLIN, 0});
+    _reactor.add(_sock.handle, Reactor::READ | Reactor::EDGE);
     utils::cout("TCP server listening on ", utils::ipToStr(_tcp_endpoint.ip), ":", _tcp_endpoint.port, "...");
+    // Set on the listener so accepted connections inherit the sizes before their window is negotiated.
+    const SocketBuffers buffers = applySocketBuffers(_sock.handle, _buffers);
+    utils::cout("TCP socket buffers: ", buffers.rcv, " bytes receive, ", buffers.snd, " bytes send");
+    if (buffers.rcv < _buffers.rcv || buffers.snd < _buffers.snd) {
+        utils::cerr("TCP socket buffers capped by the kernel (raise net.core.rmem_max / wmem_max or grant CAP_NET_ADMIN)");
+    }
 }
 
 /**
  * @brief Handles a client's request.
  *
- * @param i The index of the client in the `_fds` array.
+ * A client that closed its side still gets its last requests handled and the
+ * answers the socket takes now, then is disconnected.
+ *
+ * @param handle The handle reported readable, or closed, by the reactor.
  */
-void rtype::srv::Gateway::_handleClients(network::NFDS &i) noexcept
+void rtype::srv::Gateway::_handleClients(const network::Handle handle) noexcept
 {
     try {
-        _recvPackets(i);
-        _parsePackets();
+        const bool open = _recvPackets(handle);
+        _parsePackets(handle);
+        if (!open) {
+            _sendPackets(handle);
+            utils::cout("Client closed connection.");
+            _disconnectByHandle(handle);
+        }
     } catch (const std::exception &e) {
         utils::cerr("Error handling client socket: ", e.what());
-        _disconnectByHandle(_fds[i].handle);
-        --i;
+        _disconnectByHandle(handle);
     }
 }
 
 /**
  * @brief Handles a client's send request.
  *
- * @param i The index of the client in the `_fds` array.
+ * @param handle The handle reported writable by the reactor.
  */
-void rtype::srv::Gateway::_handleClientsSend(network::NFDS &i) noexcept
+void rtype::srv::Gateway::_handleClientsSend(const network::Handle handle) noexcept
 {
     try {
-        _sendPackets(i);
+        _sendPackets(handle);
     } catch (const std::exception &e) {
         utils::cerr("Error handling client socket: ", e.what());
-        _disconnectByHandle(_fds[i].handle);
-        --i;
+        _disconnectByHandle(handle);
     }
 }
 
 /**
- * @brief Handles a single iteration of the main server loop.
+ * @brief Dispatches a single readiness event.
  *
- * @param i The index of the current file descriptor in the `_fds` array.
+ * @param event The event reported by the reactor.
  */
-void rtype::srv::Gateway::_handleLoop(network::NFDS &i) noexcept
+void rtype::srv::Gateway::_handleEvent(const Reactor::Event &event) noexcept
 {
-    if (_fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
-        _disconnectByHandle(_fds[i].handle);
-        --i;
+    if (event.handle == _reactor.timerHandle()) {
+        if (_reactor.consumeTimer() > 0) {
+            sendOccupancyRequests();
+        }
         return;
     }
-    if (_fds[i].revents & POLLIN) {
-        if (_fds[i].handle == _sock.handle) {
-            _acceptClients();
-        } else {
-            _handleClients(i);
-        }
-    } else if (_fds[i].revents & POLLOUT && _fds[i].handle != _sock.handle) {
-        _handleClientsSend(i);
+    if (event.handle == _sock.handle) {
+        _acceptClients();
+        return;
+    }
+    if (event.ready & Reactor::CLOSED) {
+        // Drains what the client sent before closing; a socket in error throws and disconnects.
+        _handleClients(event.handle);
+        _disconnectByHandle(event.handle);
+        return;
+    }
+    if (event.ready & Reactor::READABLE) {
+        _handleClients(event.handle);
+    }
+    if (event.ready & Reactor::WRITABLE && _connection(event.handle) != nullptr) {
+        _handleClientsSend(event.handle);
     }
 }
 
@@ -98,27 +116,43 @@ void rtype::srv::Gateway::_handleLoop(network::NFDS &i) noexcept
  * @brief The main server loop.
  *
  * This function is responsible for handling all incoming and outgoing network
- * traffic. It will run until the `_quit_server` atomic boolean is set to true.
+ * traffic. The thread sleeps in the reactor until a connection is ready or the
+ * occupancy timer fires, and runs until the `_quit_server` atomic boolean is set
+ * to true.
  */
 void rtype::srv::Gateway::_serverLoop()
 {
-    auto last_occupancy = clock::now();
-
+    _reactor.armTimer(OCCUPANCY_INTERVAL);
     while (!(*_quit_server)) {
-        if (network::poll(_fds.data(), _nfds, 0) == -1) {
-            utils::cerr("Poll error, stopping server...");
-            break;
-        }
-        for (network::NFDS i = 0; i < _nfds; ++i) {
-            _handleLoop(i);
-        }
-        if (auto now = clock::now(); now - last_occupancy >= OCCUPANCY_INTERVAL) {
-            sendOccupancyRequests();
-            last_occupancy = now;
+        for (const auto &event : _reactor.wait(WAIT_TIMEOUT)) {
+            _handleEvent(event);
         }
+        _reportStats();
     }
 }
 
+/**
+ * @brief Periodically logs how often client sockets pushed back on sends.
+ */
+void rtype::srv::Gateway::_reportStats()
+{
+    const auto now = clock::now();
+
+    if (now - _last_stats < STATS_INTERVAL) {
+        return;
+    }
+    _last_stats = now;
+    if (_send_stats.would_block > 0 || _send_stats.partial > 0 || _send_stats.errors > 0) {
+        utils::cout("[gateway] TCP send: ", _send_stats.would_block, " EAGAIN, ", _send_stats.partial, " partial writes, ",
+            _send_stats.errors, " errors");
+    }
+    _send_stats = {};
+    if (const std::string commands = COMMANDS.summary(_commands); !commands.empty()) {
+        utils::cout("[gateway] commands: ", commands);
+    }
+    _commands = {};
+}
+
 /**
  * @brief Cleans up the server's resources.
  *
@@ -128,15 +162,14 @@ void rtype::srv::Gateway::_serverLoop()
  */
 void rtype::srv::Gateway::_cleanupServer()
 {
-    for (auto &sock : _sockets | std::views::values) {
-        disconnect(sock);
-    }
-    _send_spans.clear();
-    _recv_spans.clear();
-    _sockets.clear();
-    _fds.clear();
-    _nfds = 0;
-    _next_id = 0;
+    for (auto &conn : _connections) {
+        if (conn.open) {
+            _reactor.remove(conn.socket.handle);
+            disconnect(conn.socket);
+        }
+    }
+    _connections.clear();
+    _reactor.remove(_sock.handle);
     disconnect(_sock);
     _is_running = false;
     utils::cout("TCP server stopped.");
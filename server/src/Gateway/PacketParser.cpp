@@ -1,6 +1,6 @@
 #include <RTypeSrv/GatewayPacketParser.hpp>
+#include <algorithm>
 #include <array>
-#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
@@ -28,29 +28,26 @@ std::uint8_t Gateway::PacketParser::getHeader(const uint8_t *data, std::size_t &
         return ss.str();
     };
 
-    if (offset + 5 > bufsize) {
+    if (!GWPcol::Header::fits(offset, bufsize)) {
         std::ostringstream msg;
         msg << "Incomplete Header (need 5 bytes, have " << (bufsize - offset) << ") - bytes: " << make_hex(offset, 32);
         throw std::runtime_error(msg.str());
     }
-    if (getNextVal<std::uint16_t>(data, offset, bufsize) != Gateway::HEADER_MAGIC) {
+    const auto header = GWPcol::Header::at(data + offset);
+    if (header.get<GWPcol::field::Magic>() != Gateway::HEADER_MAGIC) {
         std::ostringstream msg;
         msg << "Invalid magic number - starting bytes: " << make_hex(start, 32);
         throw std::runtime_error(msg.str());
     }
-    std::uint8_t ver = getNextVal<std::uint8_t>(data, offset, bufsize);
+    const std::uint8_t ver = header.get<GWPcol::field::Version>();
     if (ver < Gateway::MINIMUM_VERSION || ver > Gateway::MAXIMUM_VERSION) {
         std::ostringstream msg;
         msg << "Invalid version (got " << static_cast<int>(ver) << ") - bytes: " << make_hex(start, 32);
         throw std::runtime_error(msg.str());
     }
-    std::uint8_t flags [[maybe_unused]] = getNextVal<std::uint8_t>(data, offset, bufsize);
-    if (offset >= bufsize) {
-        std::ostringstream msg;
-        msg << "Incomplete Header (no packet id) - bytes: " << make_hex(start, 32);
-        throw std::runtime_error(msg.str());
-    }
-    return data[offset];
+    // The offset is left on the CMD byte: the command handlers skip it themselves.
+    offset += GWPcol::Header::offset<GWPcol::field::Cmd>;
+    return header.get<GWPcol::field::Cmd>();
 }
 
 /**
@@ -58,8 +55,7 @@ std::uint8_t Gateway::PacketParser::getHeader(const uint8_t *data, std::size_t &
  */
 uint32_t Gateway::PacketParser::extractGameId(const uint8_t *data) noexcept
 {
-    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8)
-        | (static_cast<uint32_t>(data[3]));
+    return GWPcol::field::GameId::codec::load(data);
 }
 
 /**
@@ -67,10 +63,10 @@ uint32_t Gateway::PacketParser::extractGameId(const uint8_t *data) noexcept
  */
 std::pair<std::array<uint8_t, 16>, uint16_t> Gateway::PacketParser::parseGSKey(const uint8_t *data, const std::size_t offset)
 {
+    const auto key = GWPcol::GsRegistration::at(data + offset);
     std::array<uint8_t, 16> ip{};
-    std::memcpy(ip.data(), data + offset, 16);
-    uint16_t port = static_cast<uint16_t>((data[offset + 16]) << 8 | data[offset + 17]);
-    return {ip, port};
+    std::ranges::copy(key.get<GWPcol::field::Ip>(), ip.begin());
+    return {ip, key.get<GWPcol::field::Port>()};
 }
 
 /**
@@ -81,7 +77,7 @@ std::pair<std::array<uint8_t, 16>, uint16_t> Gateway::PacketParser::parseGSKey(c
  */
 uint8_t Gateway::PacketParser::parseOccupancy(const uint8_t *data, const std::size_t offset)
 {
-    return data[offset];
+    return GWPcol::OccupancyUpdate::at(data + offset).get<GWPcol::field::Occupancy>();
 }
 
 /**
@@ -90,28 +86,35 @@ uint8_t Gateway::PacketParser::parseOccupancy(const uint8_t *data, const std::si
 std::vector<uint32_t> Gateway::PacketParser::parseGIDs(const uint8_t *data, const std::size_t start, std::size_t bufsize)
 {
     std::vector<uint32_t> gids;
-    for (size_t pos = start; pos + 4 <= bufsize; pos += 4) {
-        uint32_t gid = extractGameId(data + pos);
-        gids.push_back(gid);
+    for (std::size_t pos = start; GWPcol::GidEntry::fits(pos, bufsize); pos += GWPcol::GidEntry::size) {
+        gids.push_back(extractGameId(data + pos));
     }
     return gids;
 }
 
+/**
+ * @brief Serializes a gateway protocol packet header.
+ *
+ * Header format: [MAGIC:2][VERSION:1][FLAGS:1][CMD:1]
+ * Total size: 5 bytes
+ */
+void Gateway::PacketParser::writeHeader(PacketWriter &out, uint8_t cmd, uint8_t flags)
+{
+    GWPcol::Header::write(out, Gateway::HEADER_MAGIC, Gateway::MAXIMUM_VERSION, flags, cmd);
+}
+
 /**
  * @brief Builds a complete gateway protocol packet header.
  *
  * Header format: [MAGIC:2][VERSION:1][FLAGS:1][CMD:1]
  * Total size: 5 bytes
  */
-std::vector<uint8_t> Gateway::PacketParser::buildHeader(uint8_t cmd, uint8_t flags)
+PacketBuffer Gateway::PacketParser::buildHeader(PacketPool &pool, uint8_t cmd, uint8_t flags)
 {
-    std::vector<uint8_t> header;
-    header.reserve(5);
-    header.push_back(0x42);
-    header.push_back(0x57);
-    header.push_back(0x01);
-    header.push_back(flags);
-    header.push_back(cmd);
+    PacketBuffer header = pool.acquire();
+    PacketWriter out(header.storage());
+    writeHeader(out, cmd, flags);
+    header.resize(out.size());
     return header;
 }
 
@@ -121,10 +124,13 @@ std::vector<uint8_t> Gateway::PacketParser::buildHeader(uint8_t cmd, uint8_t fla
  * Format: [HEADER:5][GAMETYPE:1]
  * Total size: 6 bytes
  */
-std::vector<uint8_t> Gateway::PacketParser::buildCreateMsg(uint8_t gametype)
+PacketBuffer Gateway::PacketParser::buildCreateMsg(PacketPool &pool, uint8_t gametype)
 {
-    std::vector<uint8_t> msg = buildHeader(3);
-    msg.push_back(gametype);
+    PacketBuffer msg = pool.acquire();
+    PacketWriter out(msg.storage());
+    writeHeader(out, 3);
+    GWPcol::Create::write(out, gametype);
+    msg.resize(out.size());
     return msg;
 }
 
@@ -134,10 +140,13 @@ std::vector<uint8_t> Gateway::PacketParser::buildCreateMsg(uint8_t gametype)
  * Format: [HEADER:5][GAME_ID:4][IP:16][PORT:2]
  * Total size: 27 bytes
  */
-std::vector<uint8_t> Gateway::PacketParser::buildJoinMsgForClient(const uint8_t *data, std::size_t offset)
+PacketBuffer Gateway::PacketParser::buildJoinMsgForClient(PacketPool &pool, const uint8_t *data, std::size_t offset)
 {
-    std::vector<uint8_t> msg = buildHeader(1);
-    msg.insert(msg.end(), data + offset, data + offset + 4 + 16 + 2);
+    PacketBuffer msg = pool.acquire();
+    PacketWriter out(msg.storage());
+    writeHeader(out, 1);
+    out.bytes(GWPcol::JoinResponse::at(data + offset).bytes());
+    msg.resize(out.size());
     return msg;
 }
 
@@ -150,18 +159,14 @@ std::vector<uint8_t> Gateway::PacketParser::buildJoinMsgForClient(const uint8_t
  * Format: [HEADER:5][CMD:1][GAME_ID:4][IP:16][PORT:2]
  * Total size: 28 bytes
  */
-std::vector<uint8_t> Gateway::PacketParser::buildJoinMsgForGS(const std::array<uint8_t, 16> &ip, const uint16_t port, const uint32_t id)
+PacketBuffer Gateway::PacketParser::buildJoinMsgForGS(PacketPool &pool, const std::array<uint8_t, 16> &ip, const uint16_t port,
+    const uint32_t id)
 {
-    std::vector<uint8_t> msg = buildHeader(1);
-    msg.reserve(28);
-    msg.push_back(1);
-    msg.push_back(static_cast<uint8_t>((id >> 24) & 0xFF));
-    msg.push_back(static_cast<uint8_t>((id >> 16) & 0xFF));
-    msg.push_back(static_cast<uint8_t>((id >> 8) & 0xFF));
-    msg.push_back(static_cast<uint8_t>(id & 0xFF));
-    msg.insert(msg.end(), ip.begin(), ip.end());
-    msg.push_back(static_cast<uint8_t>(port >> 8));
-    msg.push_back(static_cast<uint8_t>(port & 0xFF));
+    PacketBuffer msg = pool.acquire();
+    PacketWriter out(msg.storage());
+    writeHeader(out, 1);
+    GWPcol::PlayerJoin::write(out, 1, id, ip, port);
+    msg.resize(out.size());
     return msg;
 }
 
@@ -173,9 +178,9 @@ std::vector<uint8_t> Gateway::PacketParser::buildJoinMsgForGS(const std::array<u
  *
  * Used for: GS_OK (21), GS_KO (22), CREATE_KO (4), JOIN_KO (2)
  */
-std::vector<uint8_t> Gateway::PacketParser::buildSimpleResponse(uint8_t cmd)
+PacketBuffer Gateway::PacketParser::buildSimpleResponse(PacketPool &pool, uint8_t cmd)
 {
-    return buildHeader(cmd);
+    return buildHeader(pool, cmd);
 }
 
 }// namespace rtype::srv
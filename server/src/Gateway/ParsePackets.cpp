@@ -6,20 +6,6 @@
 #include <ranges>
 #include <stdexcept>
 
-/**
- * @brief Sets the POLLOUT flag for a given handle.
- * @param h The handle to set the POLLOUT flag for.
- */
-void rtype::srv::Gateway::setPolloutForHandle(const network::Handle h) noexcept
-{
-    for (auto &fd : _fds) {
-        if (fd.handle == h) {
-            fd.events |= POLLOUT;
-            break;
-        }
-    }
-}
-
 /**
  * @brief Finds the least occupied game server.
  * @return An iterator to the least occupied game server, or std::nullopt if no game servers are available.
@@ -43,19 +29,6 @@ std::optional<rtype::srv::Gateway::GsRegistryType::iterator> rtype::srv::Gateway
     return min_gs;
 }
 
-/**
- * @brief Gets the handle for a game server.
- * @param gs_key The key of the game server.
- * @return The handle of the game server, or 0 if the game server is not found.
- */
-rtype::network::Handle rtype::srv::Gateway::getGSHandle(const IP &gs_key) const
-{
-    if (const auto it_handle = _gs_addr_to_handle.find(gs_key); it_handle != _gs_addr_to_handle.end()) {
-        return it_handle->second;
-    }
-    return 0;
-}
-
 /**
  * @brief Sends an error response to a client or game server.
  *
@@ -70,9 +43,8 @@ rtype::network::Handle rtype::srv::Gateway::getGSHandle(const IP &gs_key) const
  */
 void rtype::srv::Gateway::sendErrorResponse(const network::Handle handle, uint8_t error_cmd)
 {
-    std::vector<uint8_t> error_msg = PacketParser::buildSimpleResponse(error_cmd);
-    _send_spans[handle].push_back(std::move(error_msg));
-    setPolloutForHandle(handle);
+    PacketBuffer error_msg = PacketParser::buildSimpleResponse(_packet_pool, error_cmd);
+    _queueSend(handle, std::move(error_msg));
 }
 
 /**
@@ -82,69 +54,74 @@ void rtype::srv::Gateway::sendErrorResponse(const network::Handle handle, uint8_
  */
 std::optional<rtype::srv::Gateway::IP> rtype::srv::Gateway::findGSKeyByHandle(const network::Handle handle) const noexcept
 {
-    for (const auto &[key, h] : _gs_addr_to_handle) {
-        if (h == handle) {
-            return key;
-        }
+    if (const auto it = _gs_registry.find(handle); it != _gs_registry.end()) {
+        return it->second;
     }
     return std::nullopt;
 }
 
 /**
- * @brief Parses packets received from clients.
+ * @brief Every command the gateway accepts; min_payload is checked against the bytes following the command byte.
+ *
+ * JOIN is registered with the client request size: the longer game server reply is checked by the handler.
+ */
+constexpr rtype::srv::Gateway::GatewayCommandTable rtype::srv::Gateway::COMMANDS{
+    {.cmd = GWPcol::CMD::JOIN, .name = "JOIN", .handler = &Gateway::handleJoin, .min_payload = GWPcol::JoinRequest::size},
+    {.cmd = GWPcol::CMD::JOIN_KO, .name = "JOIN_KO", .handler = &Gateway::handleKO},
+    {.cmd = GWPcol::CMD::CREATE, .name = "CREATE", .handler = &Gateway::handleCreate, .min_payload = GWPcol::Create::size},
+    {.cmd = GWPcol::CMD::CREATE_KO, .name = "CREATE_KO", .handler = &Gateway::handleKO},
+    {.cmd = GWPcol::CMD::GAME_END, .name = "GAME_END", .handler = &Gateway::handleGameEnd, .min_payload = GWPcol::GameEnd::size},
+    {.cmd = GWPcol::CMD::GS,
+        .name = "GS",
+        .handler = &Gateway::handleGSRegistration,
+        .min_payload = GWPcol::GsRegistration::size},
+    {.cmd = GWPcol::CMD::GS_OK, .name = "GS_OK", .handler = &Gateway::handleOK},
+    {.cmd = GWPcol::CMD::GS_KO, .name = "GS_KO", .handler = &Gateway::handleKO},
+    {.cmd = GWPcol::CMD::OCCUPANCY,
+        .name = "OCCUPANCY",
+        .handler = &Gateway::handleOccupancy,
+        .min_payload = GWPcol::OccupancyUpdate::size},
+    {.cmd = GWPcol::CMD::GID, .name = "GID", .handler = &Gateway::handleGID, .min_payload = GWPcol::GidList::size},
+};
+
+/**
+ * @brief Parses the packets received from a client.
+ *
+ * A message whose payload has not fully arrived is left in the buffer for the next read.
+ *
+ * @param handle The handle of the client.
  */
-void rtype::srv::Gateway::_parsePackets()
+void rtype::srv::Gateway::_parsePackets(const network::Handle handle)
 {
-    for (auto &[handle, buf] : _recv_spans) {
-        std::size_t offset = 0;
-        while (offset < buf.size()) {
-            try {
-                const uint8_t pkt = PacketParser::getHeader(buf.data(), offset, buf.size());
-                switch (pkt) {
-                    case 1:
-                        handleJoin(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 2:
-                        handleKO(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 3:
-                        handleCreate(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 4:
-                        handleKO(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 5:
-                        handleGameEnd(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 20:
-                        handleGSRegistration(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 21:
-                        handleOK(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 22:
-                        handleKO(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 23:
-                        handleOccupancy(handle, buf.data(), offset, buf.size());
-                        break;
-                    case 24:
-                        handleGID(handle, buf.data(), offset, buf.size());
-                        break;
-                    default:
-                        throw std::runtime_error("Invalid packet sent by client.");
-                }
-            } catch (const std::exception &e) {
-                utils::cerr("Error parsing packet from handle ", handle, ": ", e.what());
-                _parseErrors[handle]++;
-                if (_parseErrors[handle] >= MAX_PARSE_ERRORS) {
-                    throw std::runtime_error("Client sent too many malformed packets.");
-                }
+    Connection *conn = _connection(handle);
+    if (conn == nullptr) {
+        return;
+    }
+    auto &buf = conn->recv;
+    std::size_t offset = 0;
+    while (offset < buf.size()) {
+        const std::size_t start = offset;
+        try {
+            const auto cmd = static_cast<GWPcol::CMD>(PacketParser::getHeader(buf.data(), offset, buf.size()));
+            const GatewayCommandTable::Route *route = COMMANDS.find(cmd);
+            if (route == nullptr) {
+                throw std::runtime_error("Invalid packet sent by client.");
+            }
+            if (buf.size() - offset - 1 < route->min_payload) {
+                offset = start;
                 break;
             }
+            GatewayCommandTable::call(*route, _commands, *this, handle, buf.data(), offset, buf.size());
+        } catch (const std::exception &e) {
+            utils::cerr("Error parsing packet from handle ", handle, ": ", e.what());
+            conn->parse_errors++;
+            if (conn->parse_errors >= MAX_PARSE_ERRORS) {
+                throw std::runtime_error("Client sent too many malformed packets.");
+            }
+            break;
         }
-        if (offset > 0 && offset <= buf.size()) {
-            buf.erase(buf.begin(), buf.begin() + static_cast<long long>(offset));
-        }
+    }
+    if (offset > 0 && offset <= buf.size()) {
+        buf.erase(buf.begin(), buf.begin() + static_cast<long long>(offset));
     }
 }
@@ -1,38 +1,59 @@
 #include <RTypeNet/Recv.hpp>
 #include <RTypeSrv/Gateway.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
+#include <array>
+#include <cerrno>
 #include <iomanip>
 #include <sstream>
 
 /**
  * @brief Receives packets from a client.
  *
- * @param i The index of the client in the `_fds` array.
+ * Client sockets are edge-triggered, so this reads until the socket would block, or
+ * to the end of the stream once the client closed its side.
+ *
+ * @param handle The handle of the client.
+ * @return false if the client closed its side: what it sent before is buffered, to handle before disconnecting.
+ * @throws std::runtime_error On a receive error, or if the client overflows its buffer.
  */
-void rtype::srv::Gateway::_recvPackets(const network::NFDS i)
+bool rtype::srv::Gateway::_recvPackets(const network::Handle handle)
 {
-    const auto handle = _fds[i].handle;
-    std::vector<uint8_t> buffer(1024);
+    Connection *conn = _connection(handle);
+    if (conn == nullptr) {
+        return true;
+    }
+    std::array<uint8_t, RECV_CHUNK_SIZE> buffer{};
 
-    if (const ssize_t ret = network::recv(handle, buffer.data(), static_cast<network::BufLen>(buffer.size()), 0); ret > 0) {
-        auto &accum = _recv_spans[handle];
-        accum.insert(accum.end(), buffer.begin(), buffer.begin() + ret);
-        {
-            std::ostringstream ss;
-            ss << std::hex << std::setfill('0');
-            const size_t len = static_cast<size_t>(ret);
-            const size_t show = std::min<size_t>(len, 64);
-            for (size_t j = 0; j < show; ++j) {
-                ss << std::setw(2) << static_cast<int>(buffer[j]);
-                if (j + 1 < show)
-                    ss << ' ';
+    while (true) {
+        const ssize_t ret = network::recv(handle, buffer.data(), static_cast<network::BufLen>(buffer.size()), 0);
+        if (ret == 0) {
+            return false;
+        }
+        if (ret < 0) {
+            const int err = errno;
+            if (err == EINTR) {
+                continue;
             }
-            rtype::srv::utils::clog("IN  TCP handle=", handle, " len=", len, " hex=", ss.str());
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                return true;
+            }
+            throw std::runtime_error("Client closed connection.");
+        }
+        conn->recv.insert(conn->recv.end(), buffer.begin(), buffer.begin() + ret);
+#if defined(DEBUG)
+        std::ostringstream ss;
+        ss << std::hex << std::setfill('0');
+        const size_t len = static_cast<size_t>(ret);
+        const size_t show = std::min<size_t>(len, 64);
+        for (size_t j = 0; j < show; ++j) {
+            ss << std::setw(2) << static_cast<int>(buffer[j]);
+            if (j + 1 < show)
+                ss << ' ';
         }
-        if (accum.size() > MAX_BUFFER_SIZE) {
+        rtype::srv::utils::clog("IN  TCP handle=", handle, " len=", len, " hex=", ss.str());
+#endif
+        if (conn->recv.size() > MAX_BUFFER_SIZE) {
             throw std::runtime_error("Client exceded max buffer size.");
         }
-    } else {
-        throw std::runtime_error("Client closed connection.");
     }
 }
@@ -1,111 +1,82 @@
 #include <RTypeNet/Send.hpp>
 #include <RTypeSrv/Gateway.hpp>
 #include <RTypeSrv/Utils/Logger.hpp>
-#include <deque>
+#include <cerrno>
 #include <iomanip>
 #include <ranges>
 #include <sstream>
 #include <utility>
 
-namespace {
-
 /**
- * @brief A buffer for sending data.
- */
-struct SendBuf {
-        std::vector<uint8_t> data;
-        size_t offset = 0;
-};
-
-/**
- * @brief Prepares a queue of buffers to be sent.
- * @param bufs The buffers to prepare.
- * @return A queue of buffers to be sent.
+ * @brief Queues a message for a connection.
+ *
+ * Write interest is only armed while a connection has queued output, so idle
+ * connections never wake the gateway with writable events.
+ *
+ * @param handle The handle of the recipient.
+ * @param data The message, moved into the connection's send queue.
  */
-std::deque<SendBuf> prepareSendQueue(std::vector<std::vector<uint8_t>> &bufs)
+void rtype::srv::Gateway::_queueSend(const network::Handle handle, PacketBuffer &&data)
 {
-    std::deque<SendBuf> sendQueue;
-    for (auto &buf : bufs) {
-        if (!buf.empty())
-            sendQueue.push_back(SendBuf{std::move(buf), 0});
+    Connection *conn = _connection(handle);
+    if (conn == nullptr || data.empty()) {
+        return;
+    }
+    const bool was_idle = conn->send.empty();
+    conn->send.push_back(std::move(data));
+    if (was_idle) {
+        _reactor.modify(handle, Reactor::READ | Reactor::WRITE | Reactor::EDGE);
     }
-    bufs.clear();
-    return sendQueue;
 }
 
 /**
- * @brief Processes a queue of buffers to be sent.
- * @param handle The handle of the recipient.
- * @param sendQueue The queue of buffers to be sent.
+ * @brief Sends queued packets to a client until its queue is empty or the socket would block.
+ * @param handle The handle of the client.
  */
-void processSendQueue(const rtype::network::Handle handle, std::deque<SendBuf> &sendQueue)
+void rtype::srv::Gateway::_sendPackets(const network::Handle handle)
 {
-    while (!sendQueue.empty()) {
-        auto &[data, offset] = sendQueue.front();
-        const size_t to_send = data.size() - offset;
-        {
-            std::ostringstream ss;
-            ss << std::hex << std::setfill('0');
-            const size_t show = std::min<size_t>(data.size() - offset, 64);
-            for (size_t i = 0; i < show; ++i) {
-                ss << std::setw(2) << static_cast<int>(data[offset + i]);
-                if (i + 1 < show)
-                    ss << ' ';
-            }
-            rtype::srv::utils::clog("OUT TCP handle=", handle, " len=", data.size() - offset, " hex=", ss.str());
+    Connection *conn = _connection(handle);
+    if (conn == nullptr) {
+        return;
+    }
+    while (!conn->send.empty()) {
+        const auto &data = conn->send.front();
+        const size_t to_send = data.size() - conn->send_offset;
+#if defined(DEBUG)
+        std::ostringstream ss;
+        ss << std::hex << std::setfill('0');
+        const size_t show = std::min<size_t>(to_send, 64);
+        for (size_t i = 0; i < show; ++i) {
+            ss << std::setw(2) << static_cast<int>(data[conn->send_offset + i]);
+            if (i + 1 < show)
+                ss << ' ';
         }
-        const ssize_t sent = rtype::network::send(handle, data.data() + offset, static_cast<rtype::network::BufLen>(to_send), 0);
+        rtype::srv::utils::clog("OUT TCP handle=", handle, " len=", to_send, " hex=", ss.str());
+#endif
+        const ssize_t sent =
+            network::send(handle, data.data() + conn->send_offset, static_cast<network::BufLen>(to_send), 0);
         if (sent < 0) {
-            break;
+            const int err = errno;
+            if (err == EINTR) {
+                continue;
+            }
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                ++_send_stats.would_block;
+                return;
+            }
+            ++_send_stats.errors;
+            throw std::runtime_error("Could not send to client.");
         }
-        offset += static_cast<size_t>(sent);
-        if (offset == data.size()) {
-            sendQueue.pop_front();
-        } else {
-            break;
+        if (static_cast<size_t>(sent) < to_send) {
+            ++_send_stats.partial;
         }
-    }
-}
-
-/**
- * @brief Updates the send buffers with any remaining data that was not sent.
- * @param sendQueue The queue of buffers that were sent.
- * @param bufs The buffers to update.
- */
-void updateSendBuffers(std::deque<SendBuf> &sendQueue, std::vector<std::vector<uint8_t>> &bufs)
-{
-    for (auto &[data, offset] : sendQueue) {
-        if (offset < data.size()) {
-            std::vector remaining(data.begin() + static_cast<long long>(offset), data.end());
-            bufs.push_back(std::move(remaining));
+        conn->send_offset += static_cast<size_t>(sent);
+        if (conn->send_offset == data.size()) {
+            conn->send.pop_front();
+            conn->send_offset = 0;
         }
     }
-}
-
-}// namespace
-
-/**
- * @brief Sends packets to a client.
- * @param i The index of the client in the `_fds` array.
- */
-void rtype::srv::Gateway::_sendPackets(const network::NFDS i)
-{
-    const auto handle = _fds[i].handle;
-    if (!(_fds[i].revents & POLLOUT)) {
-        return;
-    }
-    const auto it = _send_spans.find(handle);
-    if (it == _send_spans.end()) {
-        return;
-    }
-    auto &bufs = it->second;
-    if (bufs.empty()) {
-        _fds[i].events &= ~POLLOUT;
-        return;
-    }
-    auto sendQueue = prepareSendQueue(bufs);
-    processSendQueue(handle, sendQueue);
-    updateSendBuffers(sendQueue, bufs);
+    _reactor.modify(handle, Reactor::READ | Reactor::EDGE);
 }
 
 /**
@@ -119,11 +90,8 @@ void rtype::srv::Gateway::_sendPackets(const network::NFDS i)
  */
 void rtype::srv::Gateway::sendOccupancyRequests()
 {
-    for (const auto &gs_key : _gs_registry | std::views::keys) {
-        if (auto it = _gs_addr_to_handle.find(gs_key); it != _gs_addr_to_handle.end()) {
-            network::Handle gs_handle = it->second;
-            std::vector<uint8_t> keepalive = rtype::srv::Gateway::PacketParser::buildSimpleResponse(21);
-            _send_spans[gs_handle].push_back(std::move(keepalive));
-        }
+    const PacketBuffer keepalive = rtype::srv::Gateway::PacketParser::buildSimpleResponse(_packet_pool, 21);
+    for (const auto &gs_handle : _gs_registry | std::views::keys) {
+        _queueSend(gs_handle, PacketBuffer(keepalive));
     }
 }
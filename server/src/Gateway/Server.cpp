@@ -32,15 +32,17 @@ void rtype::srv::Gateway::startServer() noexcept
  * @param tcp_endpoint The TCP endpoint to use.
  * @param quit_server A reference to an atomic boolean that will be set to
  * true when the server should quit.
+ * @param buffers The kernel buffer sizes of the listening socket (0 keeps the default).
  *
  * @throws Exception if the server has already been initialized.
  */
-void rtype::srv::Gateway::initServer(const network::Endpoint &tcp_endpoint, std::atomic<bool> &quit_server)
+void rtype::srv::Gateway::initServer(const network::Endpoint &tcp_endpoint, std::atomic<bool> &quit_server, const SocketBuffers &buffers)
 {
     if (_is_init) {
         throw Exception("initServer", "Server was already initialized.");
     }
     _quit_server = &quit_server;
     _tcp_endpoint = tcp_endpoint;
+    _buffers = buffers;
     _is_init = true;
 }
@@ -0,0 +1,281 @@
+#include <RTypeNet/Poll.hpp>
+#include <RTypeSrv/Exception.hpp>
+#include <RTypeSrv/Reactor.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+#elif defined(_WIN32)
+    #include <winsock2.h>
+#else
+    #include <fcntl.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Switches a handle to non-blocking mode, required for edge-triggered readiness.
+ * @param handle The handle to update.
+ */
+void setNonBlocking(const rtype::network::Handle handle) noexcept
+{
+#if defined(_WIN32)
+    u_long mode = 1;
+    ioctlsocket(handle, FIONBIO, &mode);
+#else
+    if (const int flags = ::fcntl(handle, F_GETFL, 0); flags != -1) {
+        ::fcntl(handle, F_SETFL, flags | O_NONBLOCK);
+    }
+#endif
+}
+
+#if defined(__linux__)
+/**
+ * @brief Converts Interest flags into epoll event flags.
+ */
+uint32_t toEpoll(const uint32_t interest) noexcept
+{
+    uint32_t events = 0;
+    if (interest & rtype::srv::Reactor::READ) {
+        events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (interest & rtype::srv::Reactor::WRITE) {
+        events |= EPOLLOUT;
+    }
+    if (interest & rtype::srv::Reactor::EDGE) {
+        events |= EPOLLET;
+    }
+    return events;
+}
+#else
+/**
+ * @brief Converts Interest flags into poll event flags.
+ */
+short toPoll(const uint32_t interest) noexcept
+{
+    short events = 0;
+    if (interest & rtype::srv::Reactor::READ) {
+        events = static_cast<short>(events | POLLIN);
+    }
+    if (interest & rtype::srv::Reactor::WRITE) {
+        events = static_cast<short>(events | POLLOUT);
+    }
+    return events;
+}
+#endif
+
+}// namespace
+
+rtype::srv::Reactor::Reactor()
+{
+    _events.reserve(MAX_EVENTS);
+#if defined(__linux__)
+    _kevents.resize(MAX_EVENTS);
+    _epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epfd == -1) {
+        throw Exception("Reactor", "epoll_create1 failed: ", std::strerror(errno));
+    }
+#endif
+}
+
+rtype::srv::Reactor::~Reactor() noexcept
+{
+#if defined(__linux__)
+    if (_timerfd != -1) {
+        ::close(_timerfd);
+    }
+    if (_epfd != -1) {
+        ::close(_epfd);
+    }
+#endif
+}
+
+void rtype::srv::Reactor::add(const network::Handle handle, const uint32_t interest)
+{
+    if (interest & EDGE) {
+        setNonBlocking(handle);
+    }
+#if defined(__linux__)
+    epoll_event ev{};
+    ev.events = toEpoll(interest);
+    ev.data.fd = handle;
+    if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, handle, &ev) == -1) {
+        throw Exception("Reactor::add", "epoll_ctl failed: ", std::strerror(errno));
+    }
+#else
+    _pfds.push_back({handle, toPoll(interest), 0});
+#endif
+    _interest[handle] = interest;
+}
+
+void rtype::srv::Reactor::modify(const network::Handle handle, const uint32_t interest) noexcept
+{
+    const auto it = _interest.find(handle);
+    if (it == _interest.end() || it->second == interest) {
+        return;
+    }
+    it->second = interest;
+#if defined(__linux__)
+    epoll_event ev{};
+    ev.events = toEpoll(interest);
+    ev.data.fd = handle;
+    ::epoll_ctl(_epfd, EPOLL_CTL_MOD, handle, &ev);
+#else
+    for (auto &pfd : _pfds) {
+        if (pfd.handle == handle) {
+            pfd.events = toPoll(interest);
+            break;
+        }
+    }
+#endif
+}
+
+void rtype::srv::Reactor::remove(const network::Handle handle) noexcept
+{
+    if (_interest.erase(handle) == 0) {
+        return;
+    }
+#if defined(__linux__)
+    ::epoll_ctl(_epfd, EPOLL_CTL_DEL, handle, nullptr);
+#else
+    std::erase_if(_pfds, [handle](const network::PollFD &pfd) { return pfd.handle == handle; });
+#endif
+}
+
+uint32_t rtype::srv::Reactor::interest(const network::Handle handle) const noexcept
+{
+    const auto it = _interest.find(handle);
+    return it == _interest.end() ? 0 : it->second;
+}
+
+void rtype::srv::Reactor::armTimer(const std::chrono::nanoseconds period)
+{
+    _period = period;
+#if defined(__linux__)
+    if (_timerfd == -1) {
+        _timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (_timerfd == -1) {
+            throw Exception("Reactor::armTimer", "timerfd_create failed: ", std::strerror(errno));
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = _timerfd;
+        if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, _timerfd, &ev) == -1) {
+            throw Exception("Reactor::armTimer", "epoll_ctl failed: ", std::strerror(errno));
+        }
+    }
+    itimerspec spec{};
+    spec.it_interval.tv_sec = static_cast<time_t>(period.count() / 1'000'000'000);
+    spec.it_interval.tv_nsec = static_cast<long>(period.count() % 1'000'000'000);
+    spec.it_value = spec.it_interval;
+    if (::timerfd_settime(_timerfd, 0, &spec, nullptr) == -1) {
+        throw Exception("Reactor::armTimer", "timerfd_settime failed: ", std::strerror(errno));
+    }
+#else
+    _deadline = clock::now() + period;
+    _expirations = 0;
+#endif
+}
+
+rtype::network::Handle rtype::srv::Reactor::timerHandle() const noexcept
+{
+#if defined(__linux__)
+    return _timerfd;
+#else
+    return static_cast<network::Handle>(-2);
+#endif
+}
+
+uint64_t rtype::srv::Reactor::consumeTimer() noexcept
+{
+#if defined(__linux__)
+    uint64_t expirations = 0;
+    if (::read(_timerfd, &expirations, sizeof(expirations)) != static_cast<ssize_t>(sizeof(expirations))) {
+        return 0;
+    }
+    return expirations;
+#else
+    const uint64_t expirations = _expirations;
+    _expirations = 0;
+    return expirations;
+#endif
+}
+
+std::span<const rtype::srv::Reactor::Event> rtype::srv::Reactor::wait(const std::chrono::milliseconds timeout)
+{
+    const auto before = clock::now();
+    if (_last_wake != clock::time_point{}) {
+        _stats.busy += before - _last_wake;
+    }
+    _events.clear();
+
+#if defined(__linux__)
+    const int n = ::epoll_wait(_epfd, _kevents.data(), static_cast<int>(_kevents.size()), static_cast<int>(timeout.count()));
+    for (int i = 0; i < n; ++i) {
+        const auto &kev = _kevents[static_cast<std::size_t>(i)];
+        Event ev{kev.data.fd, 0};
+        if (kev.events & EPOLLIN) {
+            ev.ready |= READABLE;
+        }
+        if (kev.events & EPOLLOUT) {
+            ev.ready |= WRITABLE;
+        }
+        if (kev.events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+            ev.ready |= CLOSED;
+        }
+        _events.push_back(ev);
+    }
+#else
+    auto wait_ms = timeout;
+    if (_period.count() > 0) {
+        const auto until_tick = std::chrono::ceil<std::chrono::milliseconds>((std::max) (_deadline - before, clock::duration{0}));
+        wait_ms = (wait_ms.count() < 0) ? until_tick : (std::min) (wait_ms, until_tick);
+    }
+    if (network::poll(_pfds.data(), static_cast<network::NFDS>(_pfds.size()), static_cast<int>(wait_ms.count())) > 0) {
+        for (auto &pfd : _pfds) {
+            if (pfd.revents == 0) {
+                continue;
+            }
+            Event ev{pfd.handle, 0};
+            if (pfd.revents & POLLIN) {
+                ev.ready |= READABLE;
+            }
+            if (pfd.revents & POLLOUT) {
+                ev.ready |= WRITABLE;
+            }
+            if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                ev.ready |= CLOSED;
+            }
+            pfd.revents = 0;
+            _events.push_back(ev);
+        }
+    }
+    if (_period.count() > 0) {
+        if (const auto now = clock::now(); now >= _deadline) {
+            const auto elapsed = static_cast<uint64_t>((now - _deadline) / _period) + 1;
+            _deadline += _period * static_cast<int64_t>(elapsed);
+            _expirations += elapsed;
+            _events.push_back(Event{timerHandle(), READABLE});
+        }
+    }
+#endif
+
+    _last_wake = clock::now();
+    _stats.idle += _last_wake - before;
+    ++_stats.iterations;
+    return {_events.data(), _events.size()};
+}
+
+const rtype::srv::Reactor::Stats &rtype::srv::Reactor::stats() const noexcept
+{
+    return _stats;
+}
+
+void rtype::srv::Reactor::resetStats() noexcept
+{
+    _stats = {};
+}
@@ -0,0 +1,71 @@
+#include <RTypeSrv/SocketBuffers.hpp>
+#include <climits>
+
+#if defined(_WIN32)
+    #include <winsock2.h>
+#else
+    #include <sys/socket.h>
+#endif
+
+namespace {
+
+#if defined(_WIN32)
+using OptLen = int;
+#else
+using OptLen = socklen_t;
+#endif
+
+/**
+ * @brief Sets one buffer size, preferring the privileged option when there is one.
+ * @param handle The socket.
+ * @param force The option that ignores the sysctl limit, or -1 if the platform has none.
+ * @param option SO_RCVBUF or SO_SNDBUF.
+ * @param size The requested size in bytes.
+ */
+void setBuffer(const rtype::network::Handle handle, const int force, const int option, const std::size_t size) noexcept
+{
+    const int value = size > static_cast<std::size_t>(INT_MAX) ? INT_MAX : static_cast<int>(size);
+    const auto *raw = reinterpret_cast<const char *>(&value);
+
+    if (force != -1 && ::setsockopt(handle, SOL_SOCKET, force, raw, sizeof(value)) == 0) {
+        return;
+    }
+    ::setsockopt(handle, SOL_SOCKET, option, raw, sizeof(value));
+}
+
+/**
+ * @brief Reads one buffer size.
+ * @param handle The socket.
+ * @param option SO_RCVBUF or SO_SNDBUF.
+ * @return The size in bytes, 0 if it cannot be read.
+ */
+std::size_t getBuffer(const rtype::network::Handle handle, const int option) noexcept
+{
+    int value = 0;
+    OptLen len = sizeof(value);
+
+    if (::getsockopt(handle, SOL_SOCKET, option, reinterpret_cast<char *>(&value), &len) != 0 || value < 0) {
+        return 0;
+    }
+    return static_cast<std::size_t>(value);
+}
+
+}// namespace
+
+rtype::srv::SocketBuffers rtype::srv::applySocketBuffers(const network::Handle handle, const SocketBuffers &requested) noexcept
+{
+#if defined(__linux__)
+    constexpr int rcv_force = SO_RCVBUFFORCE;
+    constexpr int snd_force = SO_SNDBUFFORCE;
+#else
+    constexpr int rcv_force = -1;
+    constexpr int snd_force = -1;
+#endif
+    if (requested.rcv > 0) {
+        setBuffer(handle, rcv_force, SO_RCVBUF, requested.rcv);
+    }
+    if (requested.snd > 0) {
+        setBuffer(handle, snd_force, SO_SNDBUF, requested.snd);
+    }
+    return SocketBuffers{getBuffer(handle, SO_RCVBUF), getBuffer(handle, SO_SNDBUF)};
+}
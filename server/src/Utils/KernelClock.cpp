@@ -0,0 +1,14 @@
+#include <RTypeSrv/Utils/KernelClock.hpp>
+
+std::chrono::nanoseconds rtype::srv::utils::realtimeOffset() noexcept
+{
+    const auto steady = std::chrono::steady_clock::now().time_since_epoch();
+    const auto wall = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(steady) - std::chrono::duration_cast<std::chrono::nanoseconds>(wall);
+}
+
+std::chrono::steady_clock::time_point rtype::srv::utils::fromKernelTime(const timespec &ts, const std::chrono::nanoseconds offset) noexcept
+{
+    const auto wall = std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(wall + offset));
+}
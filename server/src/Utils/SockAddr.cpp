@@ -0,0 +1,53 @@
+#include <RTypeSrv/Utils/SockAddr.hpp>
+
+#if !defined(_WIN32)
+    #include <arpa/inet.h>
+    #include <cstring>
+    #include <netinet/in.h>
+
+rtype::network::Endpoint rtype::srv::utils::fromSockaddr(const sockaddr_storage &addr) noexcept
+{
+    network::Endpoint endpoint{};
+
+    if (addr.ss_family == AF_INET6) {
+        const auto *in6 = reinterpret_cast<const sockaddr_in6 *>(&addr);
+        std::memcpy(endpoint.ip.data(), &in6->sin6_addr, 16);
+        endpoint.port = ntohs(in6->sin6_port);
+    } else if (addr.ss_family == AF_INET) {
+        const auto *in4 = reinterpret_cast<const sockaddr_in *>(&addr);
+        endpoint.ip[10] = 0xFF;
+        endpoint.ip[11] = 0xFF;
+        std::memcpy(endpoint.ip.data() + network::IPv4Offset, &in4->sin_addr, 4);
+        endpoint.port = ntohs(in4->sin_port);
+    }
+    return endpoint;
+}
+
+socklen_t rtype::srv::utils::toSockaddr(const network::Endpoint &endpoint, const int family, sockaddr_storage &addr) noexcept
+{
+    std::memset(&addr, 0, sizeof(addr));
+    if (family == AF_INET) {
+        auto *in4 = reinterpret_cast<sockaddr_in *>(&addr);
+        in4->sin_family = AF_INET;
+        in4->sin_port = htons(endpoint.port);
+        std::memcpy(&in4->sin_addr, endpoint.ip.data() + network::IPv4Offset, 4);
+        return sizeof(sockaddr_in);
+    }
+    auto *in6 = reinterpret_cast<sockaddr_in6 *>(&addr);
+    in6->sin6_family = AF_INET6;
+    in6->sin6_port = htons(endpoint.port);
+    std::memcpy(&in6->sin6_addr, endpoint.ip.data(), 16);
+    return sizeof(sockaddr_in6);
+}
+
+int rtype::srv::utils::socketFamily(const network::Handle handle) noexcept
+{
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    if (::getsockname(handle, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+        return AF_INET6;
+    }
+    return addr.ss_family;
+}
+
+#endif